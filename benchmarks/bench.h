@@ -0,0 +1,37 @@
+// Minimal timing helpers shared by the benchmarks
+#ifndef _UINT128_T_BENCH_H_
+#define _UINT128_T_BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// keep the optimizer from discarding a result
+template <typename T>
+inline void do_not_optimize(const T & value){
+    #if defined(__GNUC__)
+        __asm__ volatile("" : : "r,m"(value) : "memory");
+    #else
+        static volatile const void * sink;
+        sink = &value;
+    #endif
+}
+
+// runs fn(iterations) a few times and returns the best time per iteration in nanoseconds
+template <typename F>
+double bench(const char * name, const std::size_t iterations, F fn){
+    double best = 1e300;
+    for(int rep = 0; rep < 5; rep++){
+        const auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        const auto stop = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration <double, std::nano> (stop - start).count() / iterations;
+        if (ns < best){
+            best = ns;
+        }
+    }
+    std::printf("%-40s %10.3f ns/op\n", name, best);
+    return best;
+}
+
+#endif
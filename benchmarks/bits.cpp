@@ -0,0 +1,91 @@
+// Bit field access: extract_bits() and insert_bits() against the same field
+// access written with the shift and mask operators, and pdep()/pext() at
+// every kernel level the CPU supports
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_bits.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 12, iterations = 1 << 18;
+    std::vector <uint128_t> values(count), masks(count);
+    std::vector <unsigned> pos(count), len(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        values[i] = gen();
+        masks[i] = gen() & gen();
+        pos[i] = (unsigned) (gen().lower() % 120);
+        len[i] = 1 + (unsigned) (gen().lower() % (128 - pos[i]));
+    }
+
+    bench("(v >> pos) & ((1 << len) - 1)", iterations, [&](std::size_t n){
+        uint64_t sum = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const uint128_t field = (values[i % count] >> pos[i % count]) & ((uint128_t(1) << len[i % count]) - 1);
+            sum += field.lower() ^ field.upper();
+        }
+        do_not_optimize(sum);
+    });
+
+    bench("extract_bits(v, pos, len)", iterations, [&](std::size_t n){
+        uint64_t sum = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const uint128_t field = extract_bits(values[i % count], pos[i % count], len[i % count]);
+            sum += field.lower() ^ field.upper();
+        }
+        do_not_optimize(sum);
+    });
+
+    bench("insert with operators", iterations, [&](std::size_t n){
+        uint128_t v = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const std::size_t j = i % count;
+            const uint128_t mask = ((uint128_t(1) << len[j]) - 1) << pos[j];
+            v = (v & ~mask) | ((values[j] << pos[j]) & mask);
+        }
+        do_not_optimize(v);
+    });
+
+    bench("insert_bits(v, field, pos, len)", iterations, [&](std::size_t n){
+        uint128_t v = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const std::size_t j = i % count;
+            v = insert_bits(v, values[j], pos[j], len[j]);
+        }
+        do_not_optimize(v);
+    });
+
+    const uint128_isa original = uint128_active_isa();
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+        bench(("pdep" + suffix).c_str(), iterations, [&](std::size_t n){
+            uint64_t sum = 0;
+            for(std::size_t i = 0; i < n; i++){
+                const uint128_t bits = pdep(values[i % count], masks[i % count]);
+                sum += bits.lower() ^ bits.upper();
+            }
+            do_not_optimize(sum);
+        });
+
+        bench(("pext" + suffix).c_str(), iterations, [&](std::size_t n){
+            uint64_t sum = 0;
+            for(std::size_t i = 0; i < n; i++){
+                const uint128_t bits = pext(values[i % count], masks[i % count]);
+                sum += bits.lower() ^ bits.upper();
+            }
+            do_not_optimize(sum);
+        });
+    }
+    uint128_set_isa(original);
+
+    return 0;
+}
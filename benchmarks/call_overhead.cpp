@@ -0,0 +1,82 @@
+// Cost of a call into the trivial uint128_t operators
+//
+// Built three times: against the static library, the shared library and the
+// header only mode. With the compiled libraries every operator is an
+// out-of-line call (through the PLT for the shared library); in header only
+// mode they inline into the loop.
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 12;
+    std::vector <uint128_t> a(count), b(count);
+    xoshiro256 gen(42);
+    gen.fill(a.data(), count);
+    gen.fill(b.data(), count);
+    for(std::size_t i = 0; i < count; i += 3){
+        b[i] = a[i];
+    }
+
+    #if defined(UINT128_T_HEADER_ONLY)
+        std::printf("mode: header only\n");
+    #elif defined(UINT128_T_BENCH_SHARED)
+        std::printf("mode: shared library\n");
+    #else
+        std::printf("mode: static library\n");
+    #endif
+
+    const std::size_t iterations = 1 << 24;
+
+    bench("operator==", iterations, [&](std::size_t n){
+        std::size_t equal = 0;
+        for(std::size_t i = 0; i < n; i++){
+            equal += (a[i % count] == b[i % count]);
+        }
+        do_not_optimize(equal);
+    });
+
+    bench("operator<", iterations, [&](std::size_t n){
+        std::size_t less = 0;
+        for(std::size_t i = 0; i < n; i++){
+            less += (a[i % count] < b[i % count]);
+        }
+        do_not_optimize(less);
+    });
+
+    bench("operator+", iterations, [&](std::size_t n){
+        uint128_t sum = 0;
+        for(std::size_t i = 0; i < n; i++){
+            sum = sum + a[i % count];
+        }
+        do_not_optimize(sum);
+    });
+
+    bench("operator^", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            x = x ^ a[i % count];
+        }
+        do_not_optimize(x);
+    });
+
+    bench("operator<<", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            x = x ^ (a[i % count] << (i & 127));
+        }
+        do_not_optimize(x);
+    });
+
+    bench("operator*", iterations, [&](std::size_t n){
+        uint128_t x = 1;
+        for(std::size_t i = 0; i < n; i++){
+            x = x * a[i % count];
+        }
+        do_not_optimize(x);
+    });
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Compressed uint128_t arrays
+//
+// 1M sorted, clustered keys (the upper limb changes every few hundred values,
+// the lower one steps by up to 4096) are encoded with each codec. Decoding is
+// timed at every kernel level the CPU supports and reported per value and in
+// GB/s of decoded uint128_t, along with the compression ratio and the cost of
+// reading single values at random.
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_codec.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 20;
+    std::vector <uint128_t> values(count), back(count);
+    xoshiro256 gen(42);
+    uint128_t v(0x0123456789abcdefULL, 0);
+    for(uint128_t & x : values){
+        const uint128_t r = gen();
+        v += r.lower() % 4096;
+        if (r.upper() % 300 == 0){
+            v += uint128_t(1, 0);
+        }
+        x = v;
+    }
+    std::vector <std::size_t> picks(1 << 16);
+    for(std::size_t & i : picks){
+        i = (std::size_t) (gen().lower() % count);
+    }
+
+    const uint128_isa original = uint128_active_isa();
+
+    for(const uint128_codec codec : {uint128_codec::frame, uint128_codec::delta, uint128_codec::dictionary}){
+        const char * name = (codec == uint128_codec::frame)?"frame":
+                            (codec == uint128_codec::delta)?"delta":
+                            "dictionary";
+        std::printf("\n%s\n", name);
+
+        uint128_compressed packed;
+        bench("encode", count, [&](std::size_t n){
+            packed.assign(values.data(), n, codec);
+        });
+        packed.assign(values.data(), count, codec);
+        std::printf("%-40s %10.2f x\n", "ratio", (double) (count * sizeof(uint128_t)) / packed.bytes());
+
+        for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+            if (!uint128_kernels_for(isa)){
+                continue;
+            }
+            uint128_set_isa(isa);
+            const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+            const double ns = bench(("decode" + suffix).c_str(), count, [&](std::size_t n){
+                packed.decode(0, n, back.data());
+                do_not_optimize(back[0]);
+            });
+            std::printf("%-40s %10.3f GB/s\n", "", sizeof(uint128_t) / ns);
+
+            bench(("random access" + suffix).c_str(), picks.size(), [&](std::size_t n){
+                uint64_t sum = 0;
+                for(std::size_t i = 0; i < n; i++){
+                    sum += packed[picks[i]].lower();
+                }
+                do_not_optimize(sum);
+            });
+        }
+        uint128_set_isa(original);
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Reloading a large uint128_t array: decimal text against column files
+//
+// 4M clustered values (64 MB as raw limbs) are written once per format and
+// loaded back; times are per value. The text path reads lines with fgets and
+// accumulates digits into a uint128_t, which is what a str() dump costs to
+// reload. Opening a column file maps it, so the plane and interleaved loads
+// are dominated by touching the pages, while packed files are decoded.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_column.h"
+#include "uint128_t_random.h"
+
+static const char * TEXT = "bench_column.txt";
+static const char * COLUMN = "bench_column.bin";
+
+static std::size_t file_size(const char * path){
+    std::FILE * file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    return (std::size_t) size;
+}
+
+int main(){
+    const std::size_t count = 1 << 22;
+    std::vector <uint128_t> values(count), back(count);
+    xoshiro256 gen(42);
+    uint64_t hi = 0x00000000deadbeefULL, lo = 0;
+    for(std::size_t i = 0; i < count; i++){
+        const uint128_t r = gen();
+        hi += (r.upper() % 1000 == 0);
+        lo += r.lower() % 100000;
+        values[i] = uint128_t(hi, lo);
+    }
+
+    bench("write text (str)", count, [&](std::size_t){
+        std::FILE * file = std::fopen(TEXT, "w");
+        for(const uint128_t & v : values){
+            const std::string s = v.str();
+            std::fwrite(s.data(), 1, s.size(), file);
+            std::fputc('\n', file);
+        }
+        std::fclose(file);
+    });
+    std::printf("%-40s %10.1f MB\n", "", file_size(TEXT) / 1e6);
+
+    bench("load text", count, [&](std::size_t){
+        std::FILE * file = std::fopen(TEXT, "r");
+        char line[64];
+        std::size_t i = 0;
+        while (std::fgets(line, sizeof(line), file)){
+            uint128_t v = 0;
+            for(const char * p = line; (*p >= '0') && (*p <= '9'); p++){
+                v = v * 10 + (unsigned) (*p - '0');
+            }
+            back[i++] = v;
+        }
+        std::fclose(file);
+        do_not_optimize(back[count - 1]);
+    });
+    std::remove(TEXT);
+
+    for(const uint128_column_layout layout : {uint128_column_layout::planes, uint128_column_layout::interleaved, uint128_column_layout::packed}){
+        const char * name = (layout == uint128_column_layout::planes)?"planes":
+                            (layout == uint128_column_layout::interleaved)?"interleaved":
+                            "packed";
+        std::printf("\n%s\n", name);
+
+        bench("write column", count, [&](std::size_t){
+            uint128_column_writer writer(COLUMN, layout);
+            writer.write(values.data(), values.size());
+            writer.close();
+        });
+        std::printf("%-40s %10.1f MB\n", "", file_size(COLUMN) / 1e6);
+
+        bench("open + read() into uint128_t[]", count, [&](std::size_t){
+            uint128_column_reader reader(COLUMN);
+            reader.read(0, reader.size(), back.data());
+            do_not_optimize(back[count - 1]);
+        });
+
+        if (layout == uint128_column_layout::planes){
+            bench("open + sum over uint128_soa blocks", count, [&](std::size_t){
+                uint128_column_reader reader(COLUMN);
+                uint64_t sum = 0;
+                for(std::size_t b = 0; b < reader.blocks(); b++){
+                    const uint128_soa soa = reader.block(b);
+                    for(std::size_t i = 0; i < soa.size; i++){
+                        sum += soa.upper[i] ^ soa.lower[i];
+                    }
+                }
+                do_not_optimize(sum);
+            });
+        }
+        if (layout == uint128_column_layout::interleaved){
+            bench("open + sum over data()", count, [&](std::size_t){
+                uint128_column_reader reader(COLUMN);
+                const uint128_t * data = reader.data();
+                uint64_t sum = 0;
+                for(std::size_t i = 0; i < reader.size(); i++){
+                    sum += data[i].upper() ^ data[i].lower();
+                }
+                do_not_optimize(sum);
+            });
+        }
+    }
+    std::remove(COLUMN);
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+// Constant time functions against the operators they replace, each on inputs
+// the operators take shortcuts on (small dividends, equal values, 0) and on
+// random inputs: the operator times differ between the two, the ct:: ones
+// should not
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_ct.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 12;
+    const uint128_t max(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    std::vector <uint128_t> a(count), b(count), small(count, 1), large(count, max), large2(count, max);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        a[i] = gen();
+        b[i] = gen() >> ((unsigned) gen() % 128) | 1;
+    }
+
+    #define BENCH_PAIR(NAME, X, Y, EXPR)                                        \
+        bench(NAME, 16 * count, [&](std::size_t n){                             \
+            uint64_t sum = 0;                                                   \
+            for(std::size_t i = 0; i < n; i++){                                 \
+                const uint128_t & x = X[i % count];                             \
+                const uint128_t & y = Y[i % count];                             \
+                (void) y;                                                       \
+                sum += uint128_t(EXPR).lower();                                 \
+            }                                                                   \
+            do_not_optimize(sum);                                               \
+        })
+
+    BENCH_PAIR("1 / max",                   small, large, x / y);
+    BENCH_PAIR("random / random",           a, b, x / y);
+    BENCH_PAIR("ct::div(1, max)",           small, large, ct::div(x, y));
+    BENCH_PAIR("ct::div(random, random)",   a, b, ct::div(x, y));
+
+    BENCH_PAIR("max < max",                 large, large2, x < y);
+    BENCH_PAIR("random < random",           a, b, x < y);
+    BENCH_PAIR("ct::lt(max, max)",          large, large2, ct::lt(x, y));
+    BENCH_PAIR("ct::lt(random, random)",    a, b, ct::lt(x, y));
+
+    BENCH_PAIR("1.bits()",                  small, small, x.bits());
+    BENCH_PAIR("random.bits()",             b, b, x.bits());
+    BENCH_PAIR("ct::bits(1)",               small, small, ct::bits(x));
+    BENCH_PAIR("ct::bits(random)",          b, b, ct::bits(x));
+
+    #undef BENCH_PAIR
+
+    return 0;
+}
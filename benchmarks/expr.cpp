@@ -0,0 +1,84 @@
+// Plain operators against lazy() expression trees
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_expr.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 10;
+    std::vector <uint128_t> a(count), b(count), c(count), m(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        a[i] = gen();
+        b[i] = gen();
+        c[i] = gen();
+        m[i] = gen() | 1;
+    }
+
+    const std::size_t iterations = 1 << 10;
+
+    bench("(x << 3) | ((y >> 5) ^ z)", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc ^= (a[i] << 3) | ((b[i] >> 5) ^ c[i]);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("lazy: (x << 3) | ((y >> 5) ^ z)", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc ^= uint128_t((lazy(a[i]) << 3) | ((b[i] >> 5) ^ c[i]));
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("((x >> 7) >> 9) & 0xffff", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc += ((a[i] >> 7) >> 9) & 0xffff;
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("lazy: ((x >> 7) >> 9) & 0xffff", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc += uint128_t(((lazy(a[i]) >> 7) >> 9) & 0xffff);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    // not the same result: the plain form reduces the truncated product
+    bench("(a * b + c) % m", iterations * count / 16, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc ^= (a[i] * b[i] + c[i]) % m[i];
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("lazy: (a * b + c) % m (exact)", iterations * count / 16, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc ^= uint128_t((lazy(a[i]) * b[i] + c[i]) % m[i]);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    return 0;
+}
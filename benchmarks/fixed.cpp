@@ -0,0 +1,79 @@
+// fixed128<18> arithmetic and conversions against the uint128_t operator equivalents
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_fixed.h"
+#include "uint128_t_random.h"
+
+typedef fixed128 <18> amount;
+
+int main(){
+    const std::size_t count = 1 << 10;
+    std::vector <amount> a(count), b(count);
+    std::vector <std::string> text(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        // amounts up to about 10^9 units, so products stay in range
+        a[i] = amount::from_raw(gen() >> 68);
+        b[i] = amount::from_raw(gen() >> 68);
+        text[i] = a[i].str();
+    }
+
+    const std::size_t iterations = 1 << 18;
+    const uint128_t one = amount::one();
+
+    bench("uint128_t a * b / 10^18", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            x ^= a[i % count].raw() * b[i % count].raw() / one;
+        }
+        do_not_optimize(x);
+    });
+
+    bench("fixed128 a * b", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            x ^= (a[i % count] * b[i % count]).raw();
+        }
+        do_not_optimize(x);
+    });
+
+    bench("fixed128 a / b", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            x ^= (a[i % count] / b[i % count]).raw();
+        }
+        do_not_optimize(x);
+    });
+
+    bench("uint128_t str() of integer and fraction", iterations, [&](std::size_t n){
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const uint128_t & raw = a[i % count].raw();
+            len += (raw / one).str().size() + (raw % one).str(10, 18).size();
+        }
+        do_not_optimize(len);
+    });
+
+    bench("fixed128 format", iterations, [&](std::size_t n){
+        char buf[amount::max_length];
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            len += a[i % count].format(buf);
+        }
+        do_not_optimize(len);
+    });
+
+    bench("fixed128 parse", iterations, [&](std::size_t n){
+        uint128_t x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const std::string & s = text[i % count];
+            x ^= amount::parse(s.data(), s.size()).raw();
+        }
+        do_not_optimize(x);
+    });
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+// 1M counters to double: the two step upper() * 2^64 + lower() that metrics
+// code used to write by hand, the compiler's unsigned __int128 cast where
+// there is one, and to_double(); then from_double() back
+#include <cmath>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 20;
+    std::vector <uint128_t> values(count), back(count);
+    std::vector <double> out(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        values[i] = gen() >> (gen().lower() % 128);
+    }
+
+    bench("upper() * 2^64 + lower(), rounds twice", count, [&](std::size_t n){
+        for(std::size_t i = 0; i < n; i++){
+            out[i] = std::ldexp((double) values[i].upper(), 64) + (double) values[i].lower();
+        }
+        do_not_optimize(out[0]);
+    });
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 u128;
+    bench("unsigned __int128 cast", count, [&](std::size_t n){
+        for(std::size_t i = 0; i < n; i++){
+            out[i] = (double) (((u128) values[i].upper() << 64) | values[i].lower());
+        }
+        do_not_optimize(out[0]);
+    });
+#endif
+
+    bench("to_double", count, [&](std::size_t n){
+        to_double(values.data(), n, out.data());
+        do_not_optimize(out[0]);
+    });
+
+    bench("from_double", count, [&](std::size_t n){
+        from_double(out.data(), n, back.data());
+        do_not_optimize(back[0]);
+    });
+
+    return 0;
+}
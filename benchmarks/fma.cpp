@@ -0,0 +1,59 @@
+// Sum of 64 x 64 bit products into a 128 bit accumulator:
+// the operator based loop against fma() and every dot() kernel level
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_fma.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 12;
+    std::vector <uint64_t> a(count), b(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        a[i] = (uint64_t) gen();
+        b[i] = (uint64_t) gen();
+    }
+
+    const std::size_t iterations = 1 << 10;
+
+    bench("acc += uint128_t(a) * uint128_t(b)", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc += uint128_t(a[i]) * uint128_t(b[i]);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("fma(acc, a, b)", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                fma(acc, a[i], b[i]);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string name = std::string("dot (") + uint128_isa_name(isa) + ")";
+        bench(name.c_str(), iterations * count, [&](std::size_t n){
+            uint128_t acc = 0;
+            uint64_t overflow = 0;
+            for(std::size_t r = 0; r < n / count; r++){
+                acc += dot(a.data(), b.data(), count, overflow);
+            }
+            do_not_optimize(acc);
+        });
+    }
+
+    return 0;
+}
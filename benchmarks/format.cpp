@@ -0,0 +1,118 @@
+// Formatting through uint128_format_to / fmt::format_to against str()
+//
+// operator new is counted so the allocations per call show up next to the
+// timings.
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__has_include)
+  #if __has_include(<fmt/format.h>)
+    #define FMT_HEADER_ONLY
+    #include <fmt/format.h>
+  #endif
+#endif
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_format.h"
+#include "uint128_t_random.h"
+
+static std::size_t allocations = 0;
+
+void * operator new(std::size_t size){
+    allocations++;
+    if (void * p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept{
+    std::free(p);
+}
+
+template <typename F>
+static void run(const char * name, const std::size_t iterations, F fn){
+    const std::size_t before = allocations;
+    bench(name, iterations, fn);
+    // bench runs fn five times
+    std::printf("%-40s %10.3f allocations/op\n", "", (double) (allocations - before) / (5.0 * iterations));
+}
+
+int main(){
+    const std::size_t count = 1 << 10;
+    std::vector <uint128_t> values(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        values[i] = gen() >> ((unsigned) gen() % 128);
+    }
+
+    const std::size_t iterations = 1 << 9;
+
+    // stands in for the log line buffer both versions append to
+    std::string line;
+    line.reserve(1 << 16);
+
+    run("line += str()", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            line.clear();
+            for(std::size_t i = 0; i < count; i++){
+                line += values[i].str();
+            }
+        }
+        do_not_optimize(line);
+    });
+
+    const uint128_format_spec spec;
+    run("line.append(uint128_format_to(buf))", iterations * count, [&](std::size_t n){
+        char buf[uint128_format_spec::max_length];
+        for(std::size_t r = 0; r < n / count; r++){
+            line.clear();
+            for(std::size_t i = 0; i < count; i++){
+                line.append(buf, uint128_format_to(buf, values[i], spec) - buf);
+            }
+        }
+        do_not_optimize(line);
+    });
+
+    #if defined(FMT_VERSION)
+    fmt::memory_buffer buf;
+    run("fmt::format_to(buf, \"{}\", x.str())", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            buf.clear();
+            for(std::size_t i = 0; i < count; i++){
+                fmt::format_to(std::back_inserter(buf), "{}", values[i].str());
+            }
+        }
+        do_not_optimize(buf);
+    });
+
+    run("fmt::format_to(buf, \"{}\", x)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            buf.clear();
+            for(std::size_t i = 0; i < count; i++){
+                fmt::format_to(std::back_inserter(buf), "{}", values[i]);
+            }
+        }
+        do_not_optimize(buf);
+    });
+
+    run("fmt::format_to(buf, \"{:>#45x}\", x)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            buf.clear();
+            for(std::size_t i = 0; i < count; i++){
+                fmt::format_to(std::back_inserter(buf), "{:>#45x}", values[i]);
+            }
+        }
+        do_not_optimize(buf);
+    });
+    #endif
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// gcd of random full width values: Euclid on operator% against gcd() and ext_gcd()
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_gcd.h"
+#include "uint128_t_random.h"
+
+static uint128_t euclid(uint128_t a, uint128_t b){
+    while (b){
+        const uint128_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+int main(){
+    const std::size_t count = 1 << 12;
+    std::vector <uint128_t> a(count), b(count), small(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        a[i] = gen();
+        b[i] = gen();
+        small[i] = gen() >> 80;
+    }
+
+    const std::size_t iterations = 1 << 4;
+
+    bench("euclid(a, b) with operator%", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                do_not_optimize(euclid(a[i], b[i]));
+            }
+        }
+    });
+
+    bench("gcd(a, b)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                do_not_optimize(gcd(a[i], b[i]));
+            }
+        }
+    });
+
+    bench("gcd(a, b >> 80)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                do_not_optimize(gcd(a[i], small[i]));
+            }
+        }
+    });
+
+    bench("ext_gcd(a, b)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                do_not_optimize(ext_gcd(a[i], b[i]).x);
+            }
+        }
+    });
+
+    bench("lcm(a >> 64, b >> 64)", iterations * count, [&](std::size_t n){
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                do_not_optimize(lcm(a[i] >> 64, b[i] >> 64));
+            }
+        }
+    });
+
+    return 0;
+}
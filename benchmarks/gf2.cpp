@@ -0,0 +1,72 @@
+// GHASH over a 1 MB buffer
+//
+// The bit at a time multiplication of the GCM specification, on uint128_t
+// operators, against ghash() at every kernel level the CPU supports,
+// reported per 16 byte block and in GB/s.
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_gf2.h"
+#include "uint128_t_random.h"
+
+static uint128_t bitwise_mul(const uint128_t & x, const uint128_t & y){
+    const uint128_t R(0xe100000000000000ULL, 0);
+    uint128_t z = 0, v = y;
+    for(unsigned i = 0; i < 128; i++){
+        if ((x >> (127 - i)) & 1){
+            z ^= v;
+        }
+        const bool low = (v & 1) != 0;
+        v >>= 1;
+        if (low){
+            v ^= R;
+        }
+    }
+    return z;
+}
+
+int main(){
+    const std::size_t blocks = 1 << 16;
+    std::vector <unsigned char> data(16 * blocks);
+    xoshiro256 gen(42);
+    for(unsigned char & c : data){
+        c = (unsigned char) gen().lower();
+    }
+    const gf2_128 h(gen());
+
+    bench("bitwise multiply", blocks / 64, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t i = 0; i < n; i++){
+            acc = bitwise_mul(acc ^ gf2_128::load(&data[16 * i]).value(), h.value());
+        }
+        do_not_optimize(acc);
+    });
+
+    const uint128_isa original = uint128_active_isa();
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+        const double ns = bench(("ghash" + suffix).c_str(), blocks, [&](std::size_t n){
+            do_not_optimize(ghash(h, data.data(), n).value());
+        });
+        std::printf("%-40s %10.3f GB/s\n", "", 16 / ns);
+
+        bench(("gf2_128 multiply" + suffix).c_str(), blocks, [&](std::size_t n){
+            gf2_128 acc = h;
+            for(std::size_t i = 0; i < n; i++){
+                acc *= h;
+            }
+            do_not_optimize(acc.value());
+        });
+    }
+    uint128_set_isa(original);
+
+    return 0;
+}
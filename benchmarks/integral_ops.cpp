@@ -0,0 +1,81 @@
+// uint128_t op built-in integer: the 128-by-64 paths against promoting the
+// operand to uint128_t and using the 128-by-128 operator, and shifts by
+// constant amounts through the operators and the uint128_t_bits.h templates
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_bits.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 10;
+    std::vector <uint128_t> x(count);
+    std::vector <uint64_t> y(count);
+    std::vector <unsigned> s(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        x[i] = gen();
+        y[i] = (uint64_t) gen() | 1;
+        s[i] = (unsigned) gen() % 128;
+    }
+
+    const std::size_t iterations = 1 << 11;
+
+    #define BENCH_OP(NAME, EXPR)                                                \
+        bench(NAME, iterations * count, [&](std::size_t n){                    \
+            uint128_t acc = 0;                                                  \
+            for(std::size_t r = 0; r < n / count; r++){                         \
+                for(std::size_t i = 0; i < count; i++){                         \
+                    acc ^= EXPR;                                                \
+                }                                                               \
+            }                                                                   \
+            do_not_optimize(acc);                                               \
+        })
+
+    BENCH_OP("x * uint128_t(y)",  x[i] * uint128_t(y[i]));
+    BENCH_OP("x * y",             x[i] * y[i]);
+    BENCH_OP("x * 10",            x[i] * 10);
+    BENCH_OP("x / uint128_t(y)",  x[i] / uint128_t(y[i]));
+    BENCH_OP("x / y",             x[i] / y[i]);
+    BENCH_OP("x / 7",             x[i] / 7);
+    BENCH_OP("x % uint128_t(y)",  x[i] % uint128_t(y[i]));
+    BENCH_OP("x % y",             x[i] % y[i]);
+    BENCH_OP("x << uint128_t(s)", x[i] << uint128_t(s[i]));
+    BENCH_OP("x << s",            x[i] << s[i]);
+    BENCH_OP("x >> uint128_t(s)", x[i] >> uint128_t(s[i]));
+    BENCH_OP("x >> s",            x[i] >> s[i]);
+    BENCH_OP("x << uint128_t(3)", x[i] << uint128_t(3));
+    BENCH_OP("x << 3",            x[i] << 3);
+    BENCH_OP("shl<3>(x)",         shl <3> (x[i]));
+    BENCH_OP("x >> uint128_t(64)", x[i] >> uint128_t(64));
+    BENCH_OP("shr<64>(x)",        shr <64> (x[i]));
+    BENCH_OP("(x << 5) | (x >> 123)", (x[i] << 5) | (x[i] >> 123));
+    BENCH_OP("rotl<5>(x)",        rotl <5> (x[i]));
+    BENCH_OP("y / x",             y[i] / ((x[i] >> s[i]) | 1));
+    BENCH_OP("y * x",             y[i] * x[i]);
+
+    #undef BENCH_OP
+
+    bench("x -= uint128_t(y)", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc -= uint128_t(y[i]);
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    bench("x -= y", iterations * count, [&](std::size_t n){
+        uint128_t acc = 0;
+        for(std::size_t r = 0; r < n / count; r++){
+            for(std::size_t i = 0; i < count; i++){
+                acc -= y[i];
+            }
+        }
+        do_not_optimize(acc);
+    });
+
+    return 0;
+}
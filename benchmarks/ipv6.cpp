@@ -0,0 +1,162 @@
+// IPv6 parsing, formatting and longest-prefix-match over a synthetic trace
+//
+// The table looks like a global routing table: prefixes under 2000::/3 that
+// cluster in a few thousand allocations, mostly /48 and /32 with some
+// lengths in between. Trace addresses fall inside those prefixes with a skew
+// towards popular ones, and their interface identifiers mix SLAAC (EUI-64),
+// random privacy addresses and small server numbers like ::1. A few percent
+// are IPv4-mapped. inet_pton / inet_ntop are timed for comparison where they
+// exist.
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <arpa/inet.h>
+  #define UINT128_T_BENCH_INET
+#endif
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_ipv6.h"
+#include "uint128_t_random.h"
+
+static uint64_t next(xoshiro256 & gen){
+    return gen().upper();
+}
+
+int main(){
+    xoshiro256 gen(42);
+
+    // 4096 allocations, each with a handful of more specific routes
+    const std::size_t allocations = 4096;
+    std::vector <ipv6_cidr> table;
+    for(std::size_t i = 0; i < allocations; i++){
+        const uint64_t block = 0x2000000000000000ULL | (next(gen) >> 3 & 0x1ffffffe00000000ULL);
+        const unsigned length = 29 + (unsigned) (next(gen) % 4);
+        table.push_back(ipv6_cidr(uint128_t(block, 0), length));
+        const unsigned routes = (unsigned) (next(gen) % 16);
+        for(unsigned r = 0; r < routes; r++){
+            const unsigned more = (next(gen) % 4) ? 48 : 33 + (unsigned) (next(gen) % 32);
+            table.push_back(ipv6_cidr(uint128_t(block | (next(gen) >> 32 & 0x00000000ffff0000ULL), 0), more));
+        }
+    }
+
+    ipv6_trie <uint32_t> trie;
+    trie.reserve(table.size());
+    for(std::size_t i = 0; i < table.size(); i++){
+        trie.insert(table[i], (uint32_t) i);
+    }
+
+    const std::size_t count = 1 << 16;
+    std::vector <uint128_t> trace(count);
+    for(std::size_t i = 0; i < count; i++){
+        if (next(gen) % 32 == 0){
+            trace[i] = uint128_t(0, 0x0000ffff00000000ULL | (next(gen) >> 32));
+            continue;
+        }
+        // skewed: the low end of the table gets most of the traffic
+        const uint64_t r = next(gen);
+        const ipv6_cidr & net = table[(std::size_t) ((r % table.size()) * (r % table.size()) / table.size())];
+        const uint64_t subnet = net.network.upper() | (next(gen) & ~ipv6_mask(net.length).upper() & 0xffffffffffff0000ULL);
+        uint64_t iid;
+        switch (next(gen) % 10){
+            case 0: case 1: case 2:
+                iid = 1 + next(gen) % 16;
+                break;
+            case 3: case 4: case 5: case 6:
+                iid = (next(gen) & 0xffffff0000ffffffULL) | 0x000000fffe000000ULL;
+                break;
+            default:
+                iid = next(gen);
+                break;
+        }
+        trace[i] = uint128_t(subnet, iid);
+    }
+
+    std::vector <std::string> text(count);
+    std::size_t total = 0;
+    for(std::size_t i = 0; i < count; i++){
+        text[i] = ipv6_str(trace[i]);
+        total += text[i].size();
+    }
+    std::printf("%zu prefixes, %zu trie nodes at most, average text length %.1f\n\n",
+                table.size(), 2 * table.size(), (double) total / count);
+
+    const std::size_t iterations = 1 << 18;
+
+    bench("ipv6_parse", iterations, [&](std::size_t n){
+        uint128_t x = 0, addr;
+        for(std::size_t i = 0; i < n; i++){
+            const std::string & s = text[i % count];
+            ipv6_parse(s.data(), s.size(), addr);
+            x ^= addr;
+        }
+        do_not_optimize(x);
+    });
+
+    bench("ipv6_format", iterations, [&](std::size_t n){
+        char buf[ipv6_max_length];
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            len += ipv6_format(trace[i % count], buf);
+        }
+        do_not_optimize(len);
+    });
+
+    #if defined(UINT128_T_BENCH_INET)
+    bench("inet_pton", iterations, [&](std::size_t n){
+        unsigned char bytes[16];
+        unsigned x = 0;
+        for(std::size_t i = 0; i < n; i++){
+            inet_pton(AF_INET6, text[i % count].c_str(), bytes);
+            x ^= bytes[15];
+        }
+        do_not_optimize(x);
+    });
+
+    std::vector <unsigned char> raw(16 * count);
+    for(std::size_t i = 0; i < count; i++){
+        for(unsigned b = 0; b < 16; b++){
+            raw[16 * i + b] = (unsigned char) ((b < 8) ? (trace[i].upper() >> (56 - 8 * b)) : (trace[i].lower() >> (120 - 8 * b)));
+        }
+    }
+    bench("inet_ntop", iterations, [&](std::size_t n){
+        char buf[INET6_ADDRSTRLEN];
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            inet_ntop(AF_INET6, &raw[16 * (i % count)], buf, sizeof(buf));
+            len += (unsigned char) buf[0];
+        }
+        do_not_optimize(len);
+    });
+    #endif
+
+    bench("contains", iterations, [&](std::size_t n){
+        std::size_t hits = 0;
+        for(std::size_t i = 0; i < n; i++){
+            hits += contains(table[i % table.size()], trace[i % count]);
+        }
+        do_not_optimize(hits);
+    });
+
+    bench("ipv6_trie lookup", iterations, [&](std::size_t n){
+        std::size_t sum = 0;
+        for(std::size_t i = 0; i < n; i++){
+            const uint32_t * route = trie.lookup(trace[i % count]);
+            sum += route ? *route : 0;
+        }
+        do_not_optimize(sum);
+    });
+
+    bench("ipv6_trie build (per prefix)", table.size(), [&](std::size_t n){
+        ipv6_trie <uint32_t> t;
+        t.reserve(n);
+        for(std::size_t i = 0; i < n; i++){
+            t.insert(table[i], (uint32_t) i);
+        }
+        do_not_optimize(t.size());
+    });
+
+    return 0;
+}
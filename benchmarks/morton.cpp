@@ -0,0 +1,78 @@
+// Morton keys for 1M points: bit by bit interleaving on the uint128_t
+// operators against morton_encode_n() and morton_decode_n() at every kernel
+// level the CPU supports, and a box query over the sorted keys
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_morton.h"
+#include "uint128_t_random.h"
+
+int main(){
+    const std::size_t count = 1 << 20;
+    std::vector <uint64_t> x(count), y(count), dx(count), dy(count);
+    std::vector <uint128_t> keys(count);
+    xoshiro256 gen(42);
+    for(std::size_t i = 0; i < count; i++){
+        const uint128_t r = gen();
+        x[i] = r.upper();
+        y[i] = r.lower();
+    }
+
+    bench("bit by bit with operators", count / 16, [&](std::size_t n){
+        for(std::size_t i = 0; i < n; i++){
+            uint128_t key = 0;
+            for(unsigned b = 0; b < 64; b++){
+                key |= uint128_t((x[i] >> b) & 1) << (2 * b);
+                key |= uint128_t((y[i] >> b) & 1) << (2 * b + 1);
+            }
+            keys[i] = key;
+        }
+        do_not_optimize(keys[0]);
+    });
+
+    const uint128_isa original = uint128_active_isa();
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+        bench(("morton_encode_n" + suffix).c_str(), count, [&](std::size_t n){
+            morton_encode_n(x.data(), y.data(), n, keys.data());
+            do_not_optimize(keys[0]);
+        });
+
+        bench(("morton_decode_n" + suffix).c_str(), count, [&](std::size_t n){
+            morton_decode_n(keys.data(), n, dx.data(), dy.data());
+            do_not_optimize(dx[0]);
+        });
+    }
+    uint128_set_isa(original);
+
+    // points in a 2^20 square, boxes of about 1/1000 of it
+    for(std::size_t i = 0; i < count; i++){
+        x[i] >>= 44;
+        y[i] >>= 44;
+    }
+    morton_encode_n(x.data(), y.data(), count, keys.data());
+    std::sort(keys.begin(), keys.end());
+    std::vector <uint64_t> corners(2 * 256);
+    for(uint64_t & c : corners){
+        c = gen().lower() % ((1 << 20) - 33000);
+    }
+    std::size_t found = 0;
+    bench("morton_query, 1/1000 of the points", 256, [&](std::size_t n){
+        for(std::size_t q = 0; q < n; q++){
+            const uint64_t x0 = corners[2 * q], y0 = corners[2 * q + 1];
+            found += morton_query(keys.data(), count, x0, y0, x0 + 33000, y0 + 33000).size();
+        }
+    });
+    do_not_optimize(found);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// A generated text file of uint128_t values, one per line (1 GB of decimal
+// by default; the first argument sets the size in MB, the second the thread
+// count). str() with fwrite and fgets with digit by digit accumulation
+// against uint128_write_text() and uint128_read_text() at every kernel level
+// the CPU supports; times are per value, throughput is of the text.
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+#include "uint128_t_text.h"
+
+static const char * TEXT = "bench_text.txt";
+
+static std::size_t file_size(const char * path){
+    std::FILE * file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    return (std::size_t) size;
+}
+
+static void throughput(const double ns_per_value, const double bytes_per_value){
+    std::printf("%-40s %10.1f MB/s\n", "", bytes_per_value / ns_per_value * 1e3);
+}
+
+int main(int argc, char * argv[]){
+    const std::size_t megabytes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    const unsigned threads = (argc > 2) ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 0;
+
+    // counters of every width, about 21 characters a line
+    xoshiro256 gen(42);
+    std::vector <uint128_t> values;
+    std::size_t bytes = 0;
+    while (bytes < megabytes * 1000000){
+        const uint128_t v = gen() >> (gen().lower() % 128);
+        bytes += v.str().size() + 1;
+        values.push_back(v);
+    }
+    const std::size_t count = values.size();
+    const double line = (double) bytes / count;
+    std::printf("%zu values, %.1f MB\n", count, bytes / 1e6);
+
+    throughput(bench("write with str() and fwrite", count, [&](std::size_t){
+        std::FILE * file = std::fopen(TEXT, "wb");
+        for(const uint128_t & v : values){
+            const std::string s = v.str();
+            std::fwrite(s.data(), 1, s.size(), file);
+            std::fputc('\n', file);
+        }
+        std::fclose(file);
+    }), line);
+
+    std::vector <uint128_t> back(count);
+    throughput(bench("read with fgets, digit by digit", count, [&](std::size_t){
+        std::FILE * file = std::fopen(TEXT, "rb");
+        char text[64];
+        std::size_t i = 0;
+        while (std::fgets(text, sizeof(text), file)){
+            uint128_t v = 0;
+            for(const char * p = text; (*p >= '0') && (*p <= '9'); p++){
+                v = v * 10 + (unsigned) (*p - '0');
+            }
+            back[i++] = v;
+        }
+        std::fclose(file);
+        do_not_optimize(back[0]);
+    }), line);
+
+    const uint128_isa original = uint128_active_isa();
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+        throughput(bench(("uint128_write_text" + suffix).c_str(), count, [&](std::size_t){
+            uint128_write_text(TEXT, values.data(), count, 10, threads);
+        }), line);
+
+        throughput(bench(("uint128_read_text" + suffix).c_str(), count, [&](std::size_t){
+            back = uint128_read_text(TEXT, 10, threads);
+            do_not_optimize(back[0]);
+        }), line);
+    }
+    uint128_set_isa(original);
+
+    if ((file_size(TEXT) != bytes) || (back != values)){
+        std::printf("round trip failed\n");
+        return 1;
+    }
+    std::remove(TEXT);
+    return 0;
+}
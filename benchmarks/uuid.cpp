@@ -0,0 +1,81 @@
+// UUID and ULID text conversion
+//
+// The batch codecs are timed at every kernel level the CPU supports and
+// reported in ns per ID and GB/s of text, next to the str(16, 32) plus
+// hyphen insertion they replace. The arrays are large enough to fall out of
+// L2, like an export job streaming IDs.
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "uint128_t.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+#include "uint128_t_uuid.h"
+
+int main(){
+    const std::size_t count = 1 << 18;
+    std::vector <uint128_t> values(count), back(count);
+    xoshiro256 gen(42);
+    for(uint128_t & v : values){
+        v = gen();
+    }
+    std::vector <char> text(count * uuid_length);
+    std::vector <char> ulid(count * ulid_length);
+
+    const uint128_isa original = uint128_active_isa();
+
+    bench("str(16, 32) + hyphens", 1 << 14, [&](std::size_t n){
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            std::string s = values[i % count].str(16, 32);
+            s.insert(20, 1, '-');
+            s.insert(16, 1, '-');
+            s.insert(12, 1, '-');
+            s.insert(8, 1, '-');
+            len += s.size();
+        }
+        do_not_optimize(len);
+    });
+
+    bench("uuid_str", 1 << 18, [&](std::size_t n){
+        std::size_t len = 0;
+        for(std::size_t i = 0; i < n; i++){
+            len += uuid_str(values[i % count]).size();
+        }
+        do_not_optimize(len);
+    });
+
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (!uint128_kernels_for(isa)){
+            continue;
+        }
+        uint128_set_isa(isa);
+        const std::string suffix = std::string(" (") + uint128_isa_name(isa) + ")";
+
+        const double format_ns = bench(("uuid_format_n" + suffix).c_str(), count, [&](std::size_t n){
+            uuid_format_n(values.data(), n, text.data());
+            do_not_optimize(text[0]);
+        });
+        std::printf("%-40s %10.3f GB/s\n", "", uuid_length / format_ns);
+
+        const double parse_ns = bench(("uuid_parse_n" + suffix).c_str(), count, [&](std::size_t n){
+            do_not_optimize(uuid_parse_n(text.data(), n, back.data()));
+        });
+        std::printf("%-40s %10.3f GB/s\n", "", uuid_length / parse_ns);
+    }
+    uint128_set_isa(original);
+
+    const double ulid_format_ns = bench("ulid_format_n", count, [&](std::size_t n){
+        ulid_format_n(values.data(), n, ulid.data());
+        do_not_optimize(ulid[0]);
+    });
+    std::printf("%-40s %10.3f GB/s\n", "", ulid_length / ulid_format_ns);
+
+    const double ulid_parse_ns = bench("ulid_parse_n", count, [&](std::size_t n){
+        do_not_optimize(ulid_parse_n(ulid.data(), n, back.data()));
+    });
+    std::printf("%-40s %10.3f GB/s\n", "", ulid_length / ulid_parse_ns);
+
+    return 0;
+}
@@ -0,0 +1,424 @@
+// Differential checks of uint128_t against the compiler's unsigned __int128
+//
+// Shared by the differential test cases, the soak runner (soak.cpp) and the
+// libFuzzer entry point (fuzz.cpp). Every check returns an empty string when
+// uint128_t agrees with the builtin and a description of the first mismatch
+// otherwise. Only GCC and Clang have the builtin; elsewhere this header
+// defines nothing.
+#ifndef _UINT128_T_DIFFERENTIAL_H_
+#define _UINT128_T_DIFFERENTIAL_H_
+
+#if defined(__SIZEOF_INT128__)
+#define UINT128_T_DIFFERENTIAL
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "uint128_t.h"
+#include "uint128_t_fixed.h"
+#include "uint128_t_fma.h"
+#include "uint128_t_ipv6.h"
+#include "uint128_t_random.h"
+#include "uint128_t_uuid.h"
+
+namespace differential {
+
+__extension__ typedef unsigned __int128 u128;
+
+inline u128 native(const uint128_t & value){
+    return ((u128) value.upper() << 64) | value.lower();
+}
+
+inline uint128_t ours(const u128 value){
+    return uint128_t((uint64_t) (value >> 64), (uint64_t) value);
+}
+
+inline std::string hex(const u128 value){
+    static const char DIGITS[] = "0123456789abcdef";
+    char out[34] = {'0', 'x'};
+    for(int i = 0; i < 32; i++){
+        out[2 + i] = DIGITS[(unsigned) (value >> (124 - 4 * i)) & 15];
+    }
+    return std::string(out, sizeof(out));
+}
+
+inline std::string mismatch(const char * what, const u128 a, const u128 b, const u128 got, const u128 want){
+    return std::string(what) + " with a = " + hex(a) + ", b = " + hex(b) + ": got " + hex(got) + ", want " + hex(want);
+}
+
+#define DIFFERENTIAL_CHECK(what, got, want)                                   \
+    do{                                                                       \
+        const u128 got_ = (got), want_ = (want);                              \
+        if (got_ != want_){                                                   \
+            return mismatch(what, x, y, got_, want_);                         \
+        }                                                                     \
+    } while (0)
+
+// the quotient or remainder by 0 must throw std::domain_error
+#define DIFFERENTIAL_CHECK_THROWS(what, expr)                                 \
+    do{                                                                       \
+        bool thrown_ = false;                                                 \
+        try{                                                                  \
+            (void) (expr);                                                    \
+        }                                                                     \
+        catch (const std::domain_error &){                                    \
+            thrown_ = true;                                                   \
+        }                                                                     \
+        if (!thrown_){                                                        \
+            return mismatch(what " did not throw", x, y, 0, 0);               \
+        }                                                                     \
+    } while (0)
+
+// Operands biased toward where carries, shifts and divisions change paths:
+// fixed edge values, powers of two and their neighbours, limbs of 0, 1 and
+// all ones, short values and full width random ones
+inline uint128_t edge_operand(xoshiro256 & gen){
+    static const u128 EDGES[] = {
+        0, 1, 2, 3, 10,
+        ~(u128) 0, ~(u128) 0 - 1,
+        (u128) 1 << 63, ((u128) 1 << 64) - 1, (u128) 1 << 64, ((u128) 1 << 64) + 1,
+        (u128) 1 << 127, ((u128) 1 << 127) - 1,
+    };
+    static const uint64_t LIMBS[] = {0, 1, 2, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0xffffffffffffffffULL};
+
+    const u128 r = native(gen()), s = native(gen());
+    const uint64_t pick = (uint64_t) s;
+    const unsigned bit = (unsigned) (s >> 64) % 128;
+    switch (pick % 8){
+        case 0:
+            return ours(EDGES[(pick >> 8) % (sizeof(EDGES) / sizeof(EDGES[0]))]);
+        case 1:
+            return ours(((u128) 1 << bit) + (u128) ((pick >> 8) % 3) - 1);
+        case 2:
+            return uint128_t(LIMBS[(pick >> 8) % 6], ((pick >> 16) & 1) ? (uint64_t) r : LIMBS[(pick >> 24) % 6]);
+        case 3:
+        case 4:
+            return ours(r >> bit);
+        case 5:
+            return ours(r | (~(u128) 0 << bit));
+        default:
+            return ours(r);
+    }
+}
+
+inline u128 shifted_left(const u128 value, const u128 amount){
+    return (amount < 128) ? (value << (unsigned) amount) : 0;
+}
+
+inline u128 shifted_right(const u128 value, const u128 amount){
+    return (amount < 128) ? (value >> (unsigned) amount) : 0;
+}
+
+// 256 bit product (hi:lo) from four 64 x 64 bit ones
+inline void wide_product(const u128 x, const u128 y, u128 & hi, u128 & lo){
+    const u128 p00 = (u128) (uint64_t) x * (uint64_t) y;
+    const u128 p01 = (u128) (uint64_t) x * (uint64_t) (y >> 64);
+    const u128 p10 = (u128) (uint64_t) (x >> 64) * (uint64_t) y;
+    const u128 p11 = (u128) (uint64_t) (x >> 64) * (uint64_t) (y >> 64);
+    const u128 mid = (p00 >> 64) + (uint64_t) p01 + (uint64_t) p10;
+    lo = (mid << 64) | (uint64_t) p00;
+    hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+// every operator with two uint128_t operands, the unary ones on a, and bits()
+inline std::string check_operators(const uint128_t & a, const uint128_t & b){
+    const u128 x = native(a), y = native(b);
+
+    DIFFERENTIAL_CHECK("a + b", native(a + b), x + y);
+    DIFFERENTIAL_CHECK("a - b", native(a - b), x - y);
+    DIFFERENTIAL_CHECK("a * b", native(a * b), x * y);
+    DIFFERENTIAL_CHECK("a & b", native(a & b), x & y);
+    DIFFERENTIAL_CHECK("a | b", native(a | b), x | y);
+    DIFFERENTIAL_CHECK("a ^ b", native(a ^ b), x ^ y);
+    DIFFERENTIAL_CHECK("~a", native(~a), ~x);
+    DIFFERENTIAL_CHECK("-a", native(-a), -x);
+    DIFFERENTIAL_CHECK("+a", native(+a), x);
+
+    DIFFERENTIAL_CHECK("a == b", a == b, x == y);
+    DIFFERENTIAL_CHECK("a != b", a != b, x != y);
+    DIFFERENTIAL_CHECK("a < b", a < b, x < y);
+    DIFFERENTIAL_CHECK("a > b", a > b, x > y);
+    DIFFERENTIAL_CHECK("a <= b", a <= b, x <= y);
+    DIFFERENTIAL_CHECK("a >= b", a >= b, x >= y);
+    DIFFERENTIAL_CHECK("!a", !a, !x);
+
+    // conversions compared bit for bit, so both must round the same way
+    const double ad = static_cast <double> (a), xd = (double) x;
+    const float af = static_cast <float> (a), xf = (float) x;
+    uint64_t ad_bits, xd_bits;
+    uint32_t af_bits, xf_bits;
+    std::memcpy(&ad_bits, &ad, sizeof(ad));
+    std::memcpy(&xd_bits, &xd, sizeof(xd));
+    std::memcpy(&af_bits, &af, sizeof(af));
+    std::memcpy(&xf_bits, &xf, sizeof(xf));
+    DIFFERENTIAL_CHECK("(double) a", ad_bits, xd_bits);
+    DIFFERENTIAL_CHECK("(float) a", af_bits, xf_bits);
+    if (xd < 340282366920938463463374607431768211456.0){
+        DIFFERENTIAL_CHECK("uint128_t((double) a)", native(uint128_t(xd)), (u128) xd);
+    }
+    DIFFERENTIAL_CHECK("a && b", a && b, x && y);
+    DIFFERENTIAL_CHECK("a || b", a || b, x || y);
+
+    // whole b as the amount, and b reduced to the interesting range
+    const u128 n = y % 130;
+    DIFFERENTIAL_CHECK("a << b", native(a << b), shifted_left(x, y));
+    DIFFERENTIAL_CHECK("a >> b", native(a >> b), shifted_right(x, y));
+    DIFFERENTIAL_CHECK("a << (b % 130)", native(a << ours(n)), shifted_left(x, n));
+    DIFFERENTIAL_CHECK("a >> (b % 130)", native(a >> ours(n)), shifted_right(x, n));
+
+    if (y){
+        DIFFERENTIAL_CHECK("a / b", native(a / b), x / y);
+        DIFFERENTIAL_CHECK("a % b", native(a % b), x % y);
+        uint128_t q = a, r = a;
+        q /= b;
+        r %= b;
+        DIFFERENTIAL_CHECK("a /= b", native(q), x / y);
+        DIFFERENTIAL_CHECK("a %= b", native(r), x % y);
+    }
+    else{
+        DIFFERENTIAL_CHECK_THROWS("a / 0", a / b);
+        DIFFERENTIAL_CHECK_THROWS("a % 0", a % b);
+    }
+
+    uint128_t c = a;
+    c += b;
+    DIFFERENTIAL_CHECK("a += b", native(c), x + y);
+    c = a;
+    c -= b;
+    DIFFERENTIAL_CHECK("a -= b", native(c), x - y);
+    c = a;
+    c *= b;
+    DIFFERENTIAL_CHECK("a *= b", native(c), x * y);
+    c = a;
+    c &= b;
+    DIFFERENTIAL_CHECK("a &= b", native(c), x & y);
+    c = a;
+    c |= b;
+    DIFFERENTIAL_CHECK("a |= b", native(c), x | y);
+    c = a;
+    c ^= b;
+    DIFFERENTIAL_CHECK("a ^= b", native(c), x ^ y);
+    c = a;
+    c <<= ours(n);
+    DIFFERENTIAL_CHECK("a <<= n", native(c), shifted_left(x, n));
+    c = a;
+    c >>= ours(n);
+    DIFFERENTIAL_CHECK("a >>= n", native(c), shifted_right(x, n));
+    c = a;
+    DIFFERENTIAL_CHECK("++a", native(++c), x + 1);
+    DIFFERENTIAL_CHECK("a++", native(c++), x + 1);
+    DIFFERENTIAL_CHECK("--a", native(--c), x + 1);
+    DIFFERENTIAL_CHECK("a--", native(c--), x + 1);
+    DIFFERENTIAL_CHECK("a after a--", native(c), x);
+
+    unsigned width = 0;
+    for(u128 v = x; v; v >>= 1){
+        width++;
+    }
+    DIFFERENTIAL_CHECK("a.bits()", a.bits(), width);
+    DIFFERENTIAL_CHECK("(bool) a", (bool) a, x != 0);
+    DIFFERENTIAL_CHECK("(uint8_t) a", (uint8_t) a, (uint8_t) x);
+    DIFFERENTIAL_CHECK("(uint16_t) a", (uint16_t) a, (uint16_t) x);
+    DIFFERENTIAL_CHECK("(uint32_t) a", (uint32_t) a, (uint32_t) x);
+    DIFFERENTIAL_CHECK("(uint64_t) a", (uint64_t) a, (uint64_t) x);
+
+    u128 hi, lo;
+    wide_product(x, y, hi, lo);
+    const uint128_wide wide = mul_wide(a, b);
+    DIFFERENTIAL_CHECK("mul_wide(a, b).lower", native(wide.lower), lo);
+    DIFFERENTIAL_CHECK("mul_wide(a, b).upper", native(wide.upper), hi);
+
+    return std::string();
+}
+
+// muldiv(a, b, c) * c + remainder has to give back a * b
+inline std::string check_muldiv(const uint128_t & a, const uint128_t & b, const uint128_t & c){
+    const u128 x = native(a), y = native(b), d = native(c);
+    u128 hi, lo;
+    wide_product(x, y, hi, lo);
+
+    if (!d){
+        DIFFERENTIAL_CHECK_THROWS("muldiv(a, b, 0)", muldiv(a, b, c));
+        return std::string();
+    }
+    if (hi >= d){
+        // exceptions are slow, so only some of these are thrown
+        if ((uint8_t) x){
+            return std::string();
+        }
+        bool thrown = false;
+        try{
+            muldiv(a, b, c);
+        }
+        catch (const std::overflow_error &){
+            thrown = true;
+        }
+        DIFFERENTIAL_CHECK("muldiv(a, b, c) overflow", thrown, true);
+        return std::string();
+    }
+
+    const u128 q = native(muldiv(a, b, c));
+    const u128 r = lo - q * d;
+    u128 back_hi, back_lo;
+    wide_product(q, d, back_hi, back_lo);
+    back_hi += (back_lo + r < back_lo);
+    back_lo += r;
+    DIFFERENTIAL_CHECK("muldiv(a, b, c) remainder", r < d, true);
+    DIFFERENTIAL_CHECK("muldiv(a, b, c) * c upper", back_hi, hi);
+    DIFFERENTIAL_CHECK("muldiv(a, b, c) * c lower", back_lo, lo);
+    if (q != ~(u128) 0){
+        DIFFERENTIAL_CHECK("muldiv_round(a, b, c, up)", native(muldiv_round(a, b, c, fixed_rounding::up)), q + (r != 0));
+    }
+    return std::string();
+}
+
+// the integral operand overloads, with v on either side
+template <typename T>
+std::string check_integral(const uint128_t & a, const T v){
+    const u128 x = native(a), y = (u128) v;     // signed values sign extend, like the builtin
+
+    DIFFERENTIAL_CHECK("a + v", native(a + v), x + y);
+    DIFFERENTIAL_CHECK("a - v", native(a - v), x - y);
+    DIFFERENTIAL_CHECK("a * v", native(a * v), x * y);
+    DIFFERENTIAL_CHECK("a & v", native(a & v), x & y);
+    DIFFERENTIAL_CHECK("a | v", native(a | v), x | y);
+    DIFFERENTIAL_CHECK("a ^ v", native(a ^ v), x ^ y);
+    DIFFERENTIAL_CHECK("v + a", native(v + a), y + x);
+    DIFFERENTIAL_CHECK("v - a", native(v - a), y - x);
+    DIFFERENTIAL_CHECK("v * a", native(v * a), y * x);
+    DIFFERENTIAL_CHECK("v & a", native(v & a), y & x);
+
+    DIFFERENTIAL_CHECK("a == v", a == v, x == y);
+    DIFFERENTIAL_CHECK("a != v", a != v, x != y);
+    DIFFERENTIAL_CHECK("a < v", a < v, x < y);
+    DIFFERENTIAL_CHECK("a > v", a > v, x > y);
+    DIFFERENTIAL_CHECK("a <= v", a <= v, x <= y);
+    DIFFERENTIAL_CHECK("a >= v", a >= v, x >= y);
+    DIFFERENTIAL_CHECK("v < a", v < a, y < x);
+    DIFFERENTIAL_CHECK("v >= a", v >= a, y >= x);
+
+    // negative amounts count as huge ones
+    DIFFERENTIAL_CHECK("a << v", native(a << v), shifted_left(x, y));
+    DIFFERENTIAL_CHECK("a >> v", native(a >> v), shifted_right(x, y));
+
+    if (y){
+        DIFFERENTIAL_CHECK("a / v", native(a / v), x / y);
+        DIFFERENTIAL_CHECK("a % v", native(a % v), x % y);
+    }
+    else{
+        DIFFERENTIAL_CHECK_THROWS("a / 0", a / v);
+        DIFFERENTIAL_CHECK_THROWS("a % 0", a % v);
+    }
+    if (x){
+        DIFFERENTIAL_CHECK("v / a", native(v / a), y / x);
+        DIFFERENTIAL_CHECK("v % a", native(v % a), y % x);
+    }
+
+    uint128_t c = a;
+    c += v;
+    DIFFERENTIAL_CHECK("a += v", native(c), x + y);
+    c = a;
+    c -= v;
+    DIFFERENTIAL_CHECK("a -= v", native(c), x - y);
+    c = a;
+    c *= v;
+    DIFFERENTIAL_CHECK("a *= v", native(c), x * y);
+
+    return std::string();
+}
+
+inline std::string check_integrals(const uint128_t & a, const uint128_t & b){
+    const uint64_t v = b.lower();
+    std::string error;
+    if (!(error = check_integral(a, (uint64_t) v)).empty() ||
+        !(error = check_integral(a, (int64_t) v)).empty() ||
+        !(error = check_integral(a, (uint32_t) v)).empty() ||
+        !(error = check_integral(a, (int32_t) v)).empty() ||
+        !(error = check_integral(a, (uint8_t) v)).empty() ||
+        !(error = check_integral(a, (int8_t) v)).empty()){
+        return error;
+    }
+    return error;
+}
+
+// str() in every base, with and without padding, and the text codecs built on top of uint128_t
+inline std::string check_text(const uint128_t & a, const uint128_t & b){
+    const u128 x = native(a), y = native(b);
+
+    for(unsigned base = 2; base <= 16; base++){
+        char digits[128];
+        std::size_t n = 0;
+        u128 v = x;
+        do{
+            digits[127 - n++] = "0123456789abcdef"[(unsigned) (v % base)];
+            v /= base;
+        } while (v);
+        const std::string want(digits + 128 - n, n);
+        const unsigned len = (unsigned) (y % 140);
+
+        if (a.str((uint8_t) base) != want){
+            return "a.str(" + std::to_string(base) + ") with a = " + hex(x) + ": got " + a.str((uint8_t) base) + ", want " + want;
+        }
+        const std::string padded = (len > n) ? std::string(len - n, '0') + want : want;
+        if (a.str((uint8_t) base, len) != padded){
+            return "a.str(" + std::to_string(base) + ", " + std::to_string(len) + ") with a = " + hex(x) + ": got " + a.str((uint8_t) base, len);
+        }
+    }
+
+    char text[ipv6_max_length];
+    uint128_t back;
+    uuid_format(a, text);
+    if (!uuid_parse(text, uuid_length, back) || (back != a) || (std::string(text, 8) != a.str(16, 32).substr(0, 8))){
+        return "uuid round trip with a = " + hex(x);
+    }
+    const std::size_t len = ipv6_format(a, text);
+    if (!ipv6_parse(text, len, back) || (back != a)){
+        return "ipv6 round trip with a = " + hex(x) + " via " + std::string(text, len);
+    }
+
+    return std::string();
+}
+
+// everything on one pair of operands
+inline std::string check(const uint128_t & a, const uint128_t & b, const bool text = true){
+    std::string error = check_operators(a, b);
+    if (error.empty()){
+        error = check_operators(b, a);
+    }
+    if (error.empty()){
+        error = check_integrals(a, b);
+    }
+    if (error.empty()){
+        error = check_muldiv(a, b, (a ^ b) >> (unsigned) (a.lower() % 128));
+    }
+    if (error.empty() && text){
+        error = check_text(a, b);
+    }
+    return error;
+}
+
+// operands from raw bytes (as from a fuzzer): a is the first 16, b the next 16,
+// missing bytes are zero
+inline std::string check_bytes(const unsigned char * data, const std::size_t size){
+    unsigned char bytes[32] = {};
+    std::memcpy(bytes, data, (size < 32) ? size : 32);
+    uint64_t limbs[4];
+    for(int i = 0; i < 4; i++){
+        limbs[i] = 0;
+        for(int j = 0; j < 8; j++){
+            limbs[i] = (limbs[i] << 8) | bytes[8 * i + j];
+        }
+    }
+    return check(uint128_t(limbs[0], limbs[1]), uint128_t(limbs[2], limbs[3]));
+}
+
+#undef DIFFERENTIAL_CHECK
+#undef DIFFERENTIAL_CHECK_THROWS
+
+}
+
+#endif
+
+#endif
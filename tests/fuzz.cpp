@@ -0,0 +1,21 @@
+// libFuzzer entry point for the differential checks
+//
+//     clang++ -std=c++14 -O1 -g -fsanitize=fuzzer,address,undefined -I.. fuzz.cpp ../uint128_t*.cpp -o fuzz
+//     ./fuzz -max_len=32 corpus/
+//
+// (or the uint128_t_fuzz target, which CMake adds when building with Clang).
+// The first 16 bytes of an input are one operand and the next 16 the other.
+// A mismatch is printed and aborts, which libFuzzer records as a crash.
+#include <cstdio>
+#include <cstdlib>
+
+#include "differential.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, std::size_t size){
+    const std::string error = differential::check_bytes(data, size);
+    if (!error.empty()){
+        std::fprintf(stderr, "%s\n", error.c_str());
+        std::abort();
+    }
+    return 0;
+}
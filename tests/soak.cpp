@@ -0,0 +1,116 @@
+// Long running differential check of uint128_t against unsigned __int128
+//
+//     soak [seconds [threads [seed]]]
+//     soak 0 1 42 --cases N         stop after N cases instead
+//
+// Each thread draws edge biased operand pairs from its own jumped xoshiro256
+// stream and runs every operator on them in both orders; str(), the UUID and
+// the IPv6 codecs are checked on one pair in 256. Prints the rate every 10
+// seconds and, on the first mismatch, the operands and what went wrong, and
+// exits with 1.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "differential.h"
+
+#if !defined(UINT128_T_DIFFERENTIAL)
+
+int main(){
+    std::cerr << "soak: unsigned __int128 is not available on this compiler" << std::endl;
+    return 0;
+}
+
+#else
+
+int main(int argc, char * argv[]){
+    double seconds = 60;
+    unsigned threads = std::thread::hardware_concurrency();
+    uint64_t seed = 1;
+    uint64_t limit = 0;
+
+    std::vector <std::string> args(argv + 1, argv + argc);
+    for(std::size_t i = 0; i < args.size(); i++){
+        if ((args[i] == "--cases") && (i + 1 < args.size())){
+            limit = std::strtoull(args[i + 1].c_str(), nullptr, 10);
+            args.erase(args.begin() + i, args.begin() + i + 2);
+            break;
+        }
+    }
+    if (args.size() > 0){ seconds = std::atof(args[0].c_str()); }
+    if (args.size() > 1){ threads = (unsigned) std::atoi(args[1].c_str()); }
+    if (args.size() > 2){ seed = std::strtoull(args[2].c_str(), nullptr, 0); }
+    if (!threads){
+        threads = 1;
+    }
+
+    std::atomic <uint64_t> cases(0);
+    std::atomic <bool> stop(false);
+    std::mutex mutex;
+    std::string failure;
+
+    xoshiro256 streams(seed);
+    std::vector <std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&, streams](){
+            xoshiro256 gen = streams;
+            uint64_t done = 0;
+            while (!stop.load(std::memory_order_relaxed)){
+                // in batches, so the shared counter stays cold
+                for(int i = 0; i < 256; i++){
+                    const uint128_t a = differential::edge_operand(gen);
+                    const uint128_t b = differential::edge_operand(gen);
+                    const std::string error = differential::check(a, b, i == 0);
+                    if (!error.empty()){
+                        std::lock_guard <std::mutex> lock(mutex);
+                        if (failure.empty()){
+                            failure = error;
+                        }
+                        stop = true;
+                        break;
+                    }
+                }
+                done = cases.fetch_add(256, std::memory_order_relaxed) + 256;
+                if (limit && (done >= limit)){
+                    stop = true;
+                }
+            }
+        });
+        streams.jump();
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point report = start;
+    double elapsed = 0;
+    while (!stop){
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        elapsed = std::chrono::duration <double> (now - start).count();
+        if (!limit && (elapsed >= seconds)){
+            stop = true;
+        }
+        if (now - report >= std::chrono::seconds(10)){
+            report = now;
+            std::cout << cases << " cases, " << (uint64_t) (cases / elapsed * 60) << " a minute" << std::endl;
+        }
+    }
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+    elapsed = std::chrono::duration <double> (std::chrono::steady_clock::now() - start).count();
+
+    std::cout << cases << " cases in " << elapsed << " s on " << threads << " threads, "
+              << (uint64_t) (cases / elapsed * 60) << " a minute" << std::endl;
+    if (!failure.empty()){
+        std::cout << "MISMATCH: " << failure << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#endif
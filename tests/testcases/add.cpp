@@ -39,3 +39,16 @@ TEST(External, add){
     EXPECT_EQ(u32 += val, (uint32_t) 0x9b9b9b9aULL);
     EXPECT_EQ(u64 += val, (uint64_t) 0x9b9b9b9b9b9b9b9aULL);
 }
+
+TEST(External, add_signed){
+    const uint128_t val(1, 0);
+
+    EXPECT_EQ(val + -1,           uint128_t(0, 0xffffffffffffffffULL));
+    EXPECT_EQ(-1  + val,          uint128_t(0, 0xffffffffffffffffULL));
+    EXPECT_EQ(val + (int8_t) -128, val - 128);
+    EXPECT_EQ(uint128_t(5) + -5,  0);
+
+    uint128_t acc = 3;
+    acc += -4;
+    EXPECT_EQ(acc, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+}
@@ -0,0 +1,222 @@
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_bits.h"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+
+static uint128_t low_mask_reference(const unsigned len){
+    return (uint128_t(1) << len) - 1;
+}
+
+// one bit at a time, lowest mask bit first
+static uint128_t pdep_reference(const uint128_t & src, const uint128_t & mask){
+    uint128_t out = 0;
+    unsigned k = 0;
+    for(unsigned i = 0; i < 128; i++){
+        if ((mask >> i) & 1){
+            out |= ((src >> k) & 1) << i;
+            k++;
+        }
+    }
+    return out;
+}
+
+static uint128_t pext_reference(const uint128_t & src, const uint128_t & mask){
+    uint128_t out = 0;
+    unsigned k = 0;
+    for(unsigned i = 0; i < 128; i++){
+        if ((mask >> i) & 1){
+            out |= ((src >> i) & 1) << k;
+            k++;
+        }
+    }
+    return out;
+}
+
+// every position and length, including ones that run past bit 127
+TEST(Bits, extract_bits){
+    xoshiro256 gen(44);
+    const uint128_t values[] = {0, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL), gen(), gen(), gen()};
+    for(const uint128_t & v : values){
+        for(unsigned pos = 0; pos <= 130; pos++){
+            for(unsigned len = 0; len <= 130; len++){
+                EXPECT_EQ(extract_bits(v, pos, len), (v >> pos) & low_mask_reference(len)) << v << " " << pos << " " << len;
+            }
+        }
+    }
+    EXPECT_EQ(extract_bits(uint128_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL), 56, 16), 0xeffe);
+}
+
+TEST(Bits, insert_bits){
+    xoshiro256 gen(45);
+    const uint128_t fields[] = {0, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL), gen(), gen()};
+    for(int i = 0; i < 3; i++){
+        const uint128_t v = gen();
+        for(const uint128_t & field : fields){
+            for(unsigned pos = 0; pos <= 130; pos++){
+                for(unsigned len = 0; len <= 130; len++){
+                    const uint128_t mask = low_mask_reference(len) << pos;
+                    EXPECT_EQ(insert_bits(v, field, pos, len), (v & ~mask) | ((field << pos) & mask)) << v << " " << pos << " " << len;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(insert_bits(0, 0xff, 60, 8), uint128_t(0xf, 0xf000000000000000ULL));
+
+    // round trip
+    const uint128_t v = gen(), field = gen();
+    EXPECT_EQ(extract_bits(insert_bits(v, field, 37, 71), 37, 71), field & low_mask_reference(71));
+}
+
+TEST(Bits, pdep_pext){
+    const uint128_t ones(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    EXPECT_EQ(pdep(ones, 0), 0);
+    EXPECT_EQ(pext(ones, 0), 0);
+    EXPECT_EQ(pdep(0x5, uint128_t(1, 1)), uint128_t(0, 1));
+    EXPECT_EQ(pdep(0x6, uint128_t(1, 1)), uint128_t(1, 0));
+    EXPECT_EQ(pext(uint128_t(1, 0), uint128_t(1, 1)), 2);
+    EXPECT_EQ(pdep(ones, ones), ones);
+    EXPECT_EQ(pext(ones, ones), ones);
+
+    // masks with 0, 1, 63, 64 and random numbers of bits in each limb
+    xoshiro256 gen(46);
+    const uint64_t limbs[] = {0, 1, 0x8000000000000000ULL, 0x7fffffffffffffffULL, 0xfffffffffffffffeULL, 0xffffffffffffffffULL};
+    for(const uint64_t hi : limbs){
+        for(const uint64_t lo : limbs){
+            const uint128_t mask(hi, lo), src = gen();
+            EXPECT_EQ(pdep(src, mask), pdep_reference(src, mask)) << mask;
+            EXPECT_EQ(pext(src, mask), pext_reference(src, mask)) << mask;
+        }
+    }
+    for(int i = 0; i < 1000; i++){
+        const uint128_t src = gen(), mask = gen() & gen();
+        EXPECT_EQ(pdep(src, mask), pdep_reference(src, mask)) << src << " " << mask;
+        EXPECT_EQ(pext(src, mask), pext_reference(src, mask)) << src << " " << mask;
+        EXPECT_EQ(pdep(pext(src, mask), mask), src & mask);
+    }
+}
+
+// every compiled kernel level against the generic one
+TEST(Bits, kernels_agree){
+    const uint128_kernels * reference = uint128_kernels_for(uint128_isa::generic);
+    ASSERT_NE(reference, nullptr);
+
+    xoshiro256 gen(47);
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+        for(int i = 0; i < 1000; i++){
+            const uint128_t src = gen(), mask = (i & 1) ? gen() : gen() & gen() & gen();
+            EXPECT_EQ(k -> pdep(src, mask), reference -> pdep(src, mask)) << uint128_isa_name(isa);
+            EXPECT_EQ(k -> pext(src, mask), reference -> pext(src, mask)) << uint128_isa_name(isa);
+        }
+    }
+}
+
+TEST(Bits, byteswap){
+    EXPECT_EQ(byteswap(uint128_t(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL)),
+              uint128_t(0x0f0e0d0c0b0a0908ULL, 0x0706050403020100ULL));
+
+    xoshiro256 gen(48);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t v = gen();
+        uint128_t expected = 0;
+        for(unsigned b = 0; b < 128; b += 8){
+            expected = (expected << 8) | ((v >> b) & 0xff);
+        }
+        EXPECT_EQ(byteswap(v), expected) << v;
+        EXPECT_EQ(byteswap(byteswap(v)), v);
+    }
+}
+
+TEST(Bits, bit_reverse){
+    EXPECT_EQ(bit_reverse(1), uint128_t(1) << 127);
+    EXPECT_EQ(bit_reverse(uint128_t(0, 0xf0)), uint128_t(0x0f00000000000000ULL, 0));
+
+    xoshiro256 gen(49);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t v = gen();
+        uint128_t expected = 0;
+        for(unsigned b = 0; b < 128; b++){
+            expected = (expected << 1) | ((v >> b) & 1);
+        }
+        EXPECT_EQ(bit_reverse(v), expected) << v;
+    }
+}
+
+TEST(Bits, parity){
+    EXPECT_FALSE(parity(0));
+    EXPECT_TRUE(parity(uint128_t(1) << 100));
+    EXPECT_FALSE(parity(uint128_t(1, 1)));
+
+    xoshiro256 gen(50);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t v = gen();
+        uint128_t folded = 0;
+        for(unsigned b = 0; b < 128; b++){
+            folded ^= (v >> b) & 1;
+        }
+        EXPECT_EQ(parity(v), folded == 1) << v;
+    }
+}
+
+// usable in constant expressions
+static_assert(shl <64> (uint128_t(0, 5)).upper() == 5, "shl<64>");
+static_assert(shr <127> (high_mask <1> ()).lower() == 1, "shr<127>");
+static_assert(rotr <1> (bit <0> ()).upper() == 0x8000000000000000ULL, "rotr<1>");
+static_assert(low_mask <100> ().upper() == 0xfffffffffULL, "low_mask<100>");
+
+// every N from 0 to 128 against the operators on the same values
+template <std::size_t... N>
+static void check_constant_amounts(const uint128_t & v, std::index_sequence <N...>){
+    const uint128_t max(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    for(const bool ok : {(shl <N> (v) == (v << N))...}){
+        EXPECT_TRUE(ok);
+    }
+    for(const bool ok : {(shr <N> (v) == (v >> N))...}){
+        EXPECT_TRUE(ok);
+    }
+    for(const bool ok : {(rotl <N> (v) == ((v << (N % 128)) | (v >> ((128 - N % 128) % 128))))...}){
+        EXPECT_TRUE(ok);
+    }
+    for(const bool ok : {(rotr <N> (rotl <N> (v)) == v)...}){
+        EXPECT_TRUE(ok);
+    }
+    for(const bool ok : {(low_mask <N> () == low_mask_reference(N))...}){
+        EXPECT_TRUE(ok);
+    }
+    for(const bool ok : {(high_mask <N> () == ~(max >> N))...}){
+        EXPECT_TRUE(ok);
+    }
+}
+
+template <std::size_t... N>
+static void check_bits(std::index_sequence <N...>){
+    for(const bool ok : {(bit <N> () == (uint128_t(1) << N))...}){
+        EXPECT_TRUE(ok);
+    }
+}
+
+TEST(Bits, constant_amounts){
+    xoshiro256 gen(51);
+    for(int i = 0; i < 20; i++){
+        check_constant_amounts(gen(), std::make_index_sequence <129> ());
+    }
+    check_bits(std::make_index_sequence <128> ());
+    EXPECT_EQ(rotl <200> (uint128_t(1)), uint128_t(1) << 72);
+}
+
+// amounts given as uint128_t go through the integral overloads
+TEST(Bits, uint128_t_amounts){
+    const uint128_t v(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    for(unsigned s = 0; s <= 130; s++){
+        EXPECT_EQ(v << uint128_t(s), v << s) << s;
+        EXPECT_EQ(v >> uint128_t(s), v >> s) << s;
+    }
+    EXPECT_EQ(v << uint128_t(1, 0), 0);
+    EXPECT_EQ(v >> uint128_t(1, 3), 0);
+}
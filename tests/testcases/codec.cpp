@@ -0,0 +1,86 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_codec.h"
+#include "uint128_t_random.h"
+
+static const uint128_codec CODECS[] = {uint128_codec::frame, uint128_codec::delta, uint128_codec::dictionary};
+
+// sorted, with long runs of the same upper limb and small steps below
+static std::vector <uint128_t> clustered(const std::size_t n){
+    xoshiro256 gen(41);
+    std::vector <uint128_t> values(n);
+    uint128_t v(0x0123456789abcdefULL, 0xfffffffffff00000ULL);
+    for(uint128_t & x : values){
+        const uint128_t r = gen();
+        v += r.lower() % 4096;
+        if (r.upper() % 300 == 0){
+            v += uint128_t(1, 0);
+        }
+        x = v;
+    }
+    return values;
+}
+
+static void roundtrip(const std::vector <uint128_t> & values){
+    for(const uint128_codec codec : CODECS){
+        const uint128_compressed packed(values.data(), values.size(), codec);
+        ASSERT_EQ(packed.size(), values.size());
+        EXPECT_EQ(packed.codec(), codec);
+        EXPECT_EQ(packed.blocks(), (values.size() + 127) / 128);
+
+        std::vector <uint128_t> back(values.size());
+        packed.decode(0, back.size(), back.data());
+        EXPECT_EQ(back, values);
+
+        for(std::size_t i = 0; i < values.size(); i += 37){
+            EXPECT_EQ(packed[i], values[i]);
+        }
+        if (values.size() > 300){
+            std::vector <uint64_t> hi(200), lo(200);
+            packed.decode(100, 200, hi.data(), lo.data());
+            for(std::size_t i = 0; i < 200; i++){
+                EXPECT_EQ(uint128_t(hi[i], lo[i]), values[100 + i]);
+            }
+        }
+    }
+}
+
+TEST(Codec, roundtrip){
+    roundtrip(clustered(1000));
+
+    xoshiro256 gen(42);
+    std::vector <uint128_t> random(777);
+    for(uint128_t & v : random){
+        v = gen() >> ((unsigned) gen().upper() % 129);
+    }
+    roundtrip(random);
+
+    // constant blocks, full width planes and wrapping differences
+    roundtrip(std::vector <uint128_t> (300, uint128_t(5, 6)));
+    roundtrip({uint128_0, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL), uint128_0,
+               uint128_t(0, 0xffffffffffffffffULL), uint128_t(1, 0), uint128_1});
+    roundtrip({});
+}
+
+TEST(Codec, compression){
+    const std::vector <uint128_t> values = clustered(1 << 14);
+    const std::size_t raw = values.size() * sizeof(uint128_t);
+    for(const uint128_codec codec : CODECS){
+        const uint128_compressed packed(values.data(), values.size(), codec);
+        EXPECT_LT(packed.bytes() * 4, raw);
+    }
+}
+
+TEST(Codec, errors){
+    const std::vector <uint128_t> values = clustered(200);
+    uint128_compressed packed;
+    EXPECT_EQ(packed.size(), 0U);
+    packed.assign(values.data(), values.size(), uint128_codec::delta);
+    EXPECT_THROW(packed[200], std::out_of_range);
+    uint128_t out[2];
+    EXPECT_THROW(packed.decode(199, 2, out), std::out_of_range);
+    EXPECT_THROW(packed.assign(values.data(), values.size(), (uint128_codec) 7), std::invalid_argument);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_column.h"
+#include "uint128_t_random.h"
+
+static const char * PATH = "uint128_t_column_test.bin";
+
+// clustered like sorted keys: long runs of the same upper limb, small steps below
+static std::vector <uint128_t> clustered(const std::size_t n){
+    xoshiro256 gen(37);
+    std::vector <uint128_t> values(n);
+    uint64_t hi = 0x0123456789abcdefULL, lo = 0;
+    for(std::size_t i = 0; i < n; i++){
+        const uint128_t r = gen();
+        if (r.upper() % 500 == 0){
+            hi++;
+        }
+        lo += r.lower() % 1000;
+        values[i] = uint128_t(hi, lo);
+    }
+    return values;
+}
+
+TEST(Column, layouts){
+    xoshiro256 gen(38);
+    std::vector <uint128_t> random(1000);
+    for(uint128_t & v : random){
+        v = gen() >> ((unsigned) gen().upper() % 128);
+    }
+    std::vector <uint128_t> sorted = clustered(1000);
+
+    for(const std::vector <uint128_t> * values : {&random, &sorted}){
+        for(const uint128_column_layout layout : {uint128_column_layout::planes, uint128_column_layout::interleaved, uint128_column_layout::packed}){
+            {
+                uint128_column_writer writer(PATH, layout, 128);
+                writer.write(values -> data(), 500);
+                for(std::size_t i = 500; i < values -> size(); i++){
+                    writer.write((*values)[i]);
+                }
+            }
+
+            uint128_column_reader reader(PATH);
+            ASSERT_EQ(reader.size(), values -> size());
+            EXPECT_EQ(reader.blocks(), 8U);
+            EXPECT_EQ(reader.block_size(), 128U);
+            EXPECT_EQ(reader.layout(), layout);
+            EXPECT_TRUE(reader.has_stats());
+
+            std::vector <uint128_t> back(values -> size());
+            reader.read(0, back.size(), back.data());
+            EXPECT_EQ(back, *values);
+
+            // ranges crossing blocks, and single values
+            std::vector <uint64_t> hi(300), lo(300);
+            reader.read(100, 300, hi.data(), lo.data());
+            for(std::size_t i = 0; i < 300; i++){
+                EXPECT_EQ(uint128_t(hi[i], lo[i]), (*values)[100 + i]);
+            }
+            EXPECT_EQ(reader[999], (*values)[999]);
+            EXPECT_EQ(reader[128], (*values)[128]);
+
+            for(std::size_t b = 0; b < reader.blocks(); b++){
+                const std::size_t first = b * 128, last = std::min <std::size_t> (first + 128, values -> size());
+                uint128_t min = (*values)[first], max = min;
+                for(std::size_t i = first; i < last; i++){
+                    min = std::min(min, (*values)[i]);
+                    max = std::max(max, (*values)[i]);
+                }
+                EXPECT_EQ(reader.block_min(b), min);
+                EXPECT_EQ(reader.block_max(b), max);
+            }
+            EXPECT_EQ(reader.block_info(7).count, 1000U - 7 * 128);
+
+            if (layout == uint128_column_layout::planes){
+                const uint128_soa soa = reader.block(1);
+                EXPECT_EQ(soa.size, 128U);
+                EXPECT_EQ(soa[5], (*values)[133]);
+                EXPECT_EQ(reader.data(), nullptr);
+            }
+            else{
+                EXPECT_THROW(reader.block(0), std::logic_error);
+            }
+            if (layout == uint128_column_layout::interleaved){
+                ASSERT_NE(reader.data(), nullptr);
+                EXPECT_EQ(std::vector <uint128_t> (reader.data(), reader.data() + reader.size()), *values);
+            }
+
+            EXPECT_THROW(reader[1000], std::out_of_range);
+            EXPECT_THROW(reader.read(999, 2, back.data()), std::out_of_range);
+        }
+    }
+    std::remove(PATH);
+}
+
+TEST(Column, packed_size){
+    const std::vector <uint128_t> values = clustered(1 << 14);
+    std::size_t sizes[2];
+    for(int packed = 0; packed < 2; packed++){
+        uint128_column_writer writer(PATH, packed ? uint128_column_layout::packed : uint128_column_layout::planes, 4096, false);
+        writer.write(values.data(), values.size());
+        writer.close();
+
+        std::FILE * file = std::fopen(PATH, "rb");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, 0, SEEK_END);
+        sizes[packed] = (std::size_t) std::ftell(file);
+        std::fclose(file);
+    }
+    // the upper plane packs to a few bits and the lower one to about 24
+    EXPECT_LT(sizes[1] * 4, sizes[0]);
+
+    uint128_column_reader reader(PATH);
+    EXPECT_FALSE(reader.has_stats());
+    std::vector <uint128_t> back(values.size());
+    reader.read(0, back.size(), back.data());
+    EXPECT_EQ(back, values);
+    std::remove(PATH);
+}
+
+TEST(Column, soa_columns){
+    std::vector <uint64_t> hi(300), lo(300);
+    for(std::size_t i = 0; i < hi.size(); i++){
+        hi[i] = i / 7;
+        lo[i] = ~(uint64_t) i;
+    }
+    {
+        uint128_column_writer writer(PATH, uint128_column_layout::planes, 100);
+        writer.write(hi.data(), lo.data(), 150);
+        writer.write(hi.data() + 150, lo.data() + 150, 150);
+    }
+    uint128_column_reader reader(PATH);
+    ASSERT_EQ(reader.blocks(), 3U);
+    std::size_t i = 0;
+    for(std::size_t b = 0; b < reader.blocks(); b++){
+        const uint128_soa soa = reader.block(b);
+        for(std::size_t j = 0; j < soa.size; j++, i++){
+            EXPECT_EQ(soa.upper[j], hi[i]);
+            EXPECT_EQ(soa.lower[j], lo[i]);
+        }
+    }
+    EXPECT_EQ(i, hi.size());
+    std::remove(PATH);
+}
+
+TEST(Column, errors){
+    {
+        uint128_column_writer writer(PATH);
+    }
+    {
+        uint128_column_reader empty(PATH);
+        EXPECT_EQ(empty.size(), 0U);
+        EXPECT_EQ(empty.blocks(), 0U);
+    }
+
+    // truncated and foreign files
+    std::FILE * file = std::fopen(PATH, "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("0\n1\n2\n", file);
+    std::fclose(file);
+    EXPECT_THROW(uint128_column_reader reader(PATH), std::runtime_error);
+
+    {
+        uint128_column_writer writer(PATH, uint128_column_layout::packed, 16);
+        for(int i = 0; i < 100; i++){
+            writer.write(uint128_t(i));
+        }
+    }
+    file = std::fopen(PATH, "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 24, SEEK_SET);     // point the directory past the end
+    const uint64_t far = 1 << 20;
+    std::fwrite(&far, sizeof(far), 1, file);
+    std::fclose(file);
+    EXPECT_THROW(uint128_column_reader reader(PATH), std::runtime_error);
+
+    // a block offset that would wrap around when its planes are added to it
+    {
+        uint128_column_writer writer(PATH, uint128_column_layout::planes, 16);
+        for(int i = 0; i < 100; i++){
+            writer.write(uint128_t(i));
+        }
+    }
+    file = std::fopen(PATH, "r+b");
+    ASSERT_NE(file, nullptr);
+    uint64_t directory = 0;
+    std::fseek(file, 24, SEEK_SET);
+    ASSERT_EQ(std::fread(&directory, sizeof(directory), 1, file), 1U);
+    std::fseek(file, (long) directory, SEEK_SET);
+    const uint64_t wrapping = 0xffffffffffffffc0ULL;
+    std::fwrite(&wrapping, sizeof(wrapping), 1, file);
+    std::fclose(file);
+    EXPECT_THROW(uint128_column_reader reader(PATH), std::runtime_error);
+    std::remove(PATH);
+
+    EXPECT_THROW(uint128_column_reader reader("no/such/file"), std::runtime_error);
+    EXPECT_THROW(uint128_column_writer writer(PATH, uint128_column_layout::planes, 0), std::invalid_argument);
+}
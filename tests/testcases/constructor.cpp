@@ -48,3 +48,14 @@ TEST(Constructor, two){
     EXPECT_EQ(uint128_t((uint32_t) 0x01234567ULL,         (uint32_t) 0x01234567ULL).lower(),         (uint32_t) 0x01234567ULL);
     EXPECT_EQ(uint128_t((uint64_t) 0x0123456789abcdefULL, (uint64_t) 0x0123456789abcdefULL).lower(), (uint64_t) 0x0123456789abcdefULL);
 }
+
+TEST(Constructor, sign_extend){
+    // signed values convert like they do to unsigned __int128
+    EXPECT_EQ(uint128_t((int8_t)  -1), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(uint128_t((int64_t) -2), uint128_t(0xffffffffffffffffULL, 0xfffffffffffffffeULL));
+    EXPECT_EQ(uint128_t((int32_t)  5), uint128_t(0, 5));
+
+    uint128_t val;
+    val = (int16_t) -3;
+    EXPECT_EQ(val, uint128_t(0xffffffffffffffffULL, 0xfffffffffffffffdULL));
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_ct.h"
+#include "uint128_t_random.h"
+
+static const uint128_t MAX(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+static const ct::mask TRUE_MASK = 0xffffffffffffffffULL;
+
+// 0, 1, the limb edges and the maximum, then random values of every width
+static std::vector <uint128_t> ct_values(){
+    std::vector <uint128_t> values = {0, 1, 2, 0xffffffffffffffffULL, uint128_t(1, 0), uint128_t(1, 1),
+                                      MAX - 1, MAX, uint128_t(1) << 127};
+    xoshiro256 gen(50);
+    for(int i = 0; i < 200; i++){
+        values.push_back(gen() >> ((unsigned) gen() % 128));
+    }
+    return values;
+}
+
+TEST(CT, compare){
+    const std::vector <uint128_t> values = ct_values();
+    for(const uint128_t & a : values){
+        EXPECT_EQ(ct::is_zero(a), a ? 0 : TRUE_MASK);
+        for(const uint128_t & b : {a, a + 1, a - 1, values[(std::size_t) a.lower() % values.size()]}){
+            EXPECT_EQ(ct::eq(a, b), (a == b) ? TRUE_MASK : 0) << a << " " << b;
+            EXPECT_EQ(ct::ne(a, b), (a != b) ? TRUE_MASK : 0) << a << " " << b;
+            EXPECT_EQ(ct::lt(a, b), (a <  b) ? TRUE_MASK : 0) << a << " " << b;
+            EXPECT_EQ(ct::le(a, b), (a <= b) ? TRUE_MASK : 0) << a << " " << b;
+            EXPECT_EQ(ct::gt(a, b), (a >  b) ? TRUE_MASK : 0) << a << " " << b;
+            EXPECT_EQ(ct::ge(a, b), (a >= b) ? TRUE_MASK : 0) << a << " " << b;
+        }
+    }
+}
+
+TEST(CT, select){
+    const uint128_t a(1, 2), b(3, 4);
+    EXPECT_EQ(ct::select(TRUE_MASK, a, b), a);
+    EXPECT_EQ(ct::select(0, a, b), b);
+    EXPECT_EQ(ct::select(ct::lt(a, b), a, b), a);
+
+    uint128_t x = a, y = b;
+    ct::cswap(0, x, y);
+    EXPECT_EQ(x, a);
+    EXPECT_EQ(y, b);
+    ct::cswap(TRUE_MASK, x, y);
+    EXPECT_EQ(x, b);
+    EXPECT_EQ(y, a);
+}
+
+TEST(CT, shifts){
+    for(const uint128_t & v : ct_values()){
+        for(uint64_t s = 0; s < 260; s++){
+            EXPECT_EQ(ct::shl(v, s), v << s) << v << " " << s;
+            EXPECT_EQ(ct::shr(v, s), v >> s) << v << " " << s;
+            const unsigned r = (unsigned) (s % 128);
+            const uint128_t rotated = r ? ((v << r) | (v >> (128 - r))) : v;
+            EXPECT_EQ(ct::rotl(v, s), rotated) << v << " " << s;
+            EXPECT_EQ(ct::rotr(rotated, s), v) << v << " " << s;
+        }
+        EXPECT_EQ(ct::shl(v, 1ULL << 40), 0);
+        EXPECT_EQ(ct::shr(v, 0xffffffffffffffffULL), 0);
+    }
+}
+
+TEST(CT, bits){
+    for(const uint128_t & v : ct_values()){
+        EXPECT_EQ(ct::bits(v), v.bits()) << v;
+    }
+    for(unsigned i = 0; i < 128; i++){
+        EXPECT_EQ(ct::bits(uint128_t(1) << i), i + 1);
+    }
+}
+
+TEST(CT, divmod){
+    const std::vector <uint128_t> values = ct_values();
+    for(const uint128_t & a : values){
+        for(const uint128_t & b : values){
+            if (!b){
+                continue;
+            }
+            uint128_t q, r;
+            ct::divmod(a, b, q, r);
+            EXPECT_EQ(q, a / b) << a << " " << b;
+            EXPECT_EQ(r, a % b) << a << " " << b;
+        }
+    }
+    EXPECT_EQ(ct::div(MAX, 3), MAX / 3);
+    EXPECT_EQ(ct::mod(MAX, 1000000007), MAX % 1000000007);
+    EXPECT_THROW(ct::div(1, 0), std::domain_error);
+    EXPECT_THROW(ct::mod(1, 0), std::domain_error);
+}
+
+// dudect (Reparaz, Balasch and Verbauwhede): time f on a fixed input and on
+// random inputs, in random order, drop the slowest tenth of the samples and
+// compare the two means with Welch's t-test. |t| past 10 means the time
+// depends on the input; on constant time code it stays within a few units.
+template <typename F>
+static double dudect_t(const F & f, const uint128_t & fixed_a, const uint128_t & fixed_b){
+    const std::size_t samples = 10000, batch = 16;
+    xoshiro256 gen(51);
+    std::vector <uint128_t> a(samples * batch), b(samples * batch);
+    std::vector <unsigned> cls(samples);
+    for(std::size_t i = 0; i < samples; i++){
+        cls[i] = (unsigned) (gen().lower() & 1);
+        for(std::size_t j = i * batch; j < (i + 1) * batch; j++){
+            a[j] = cls[i] ? gen() : fixed_a;
+            b[j] = cls[i] ? (gen() | 1) : fixed_b;
+        }
+    }
+
+    uint64_t sink = 0;
+    std::vector <double> ns(samples);
+    for(int pass = 0; pass < 2; pass++){
+        for(std::size_t i = 0; i < samples; i++){
+            const auto start = std::chrono::steady_clock::now();
+            for(std::size_t j = i * batch; j < (i + 1) * batch; j++){
+                sink += f(a[j], b[j]).lower();
+            }
+            const auto stop = std::chrono::steady_clock::now();
+            ns[i] = std::chrono::duration <double, std::nano> (stop - start).count();
+        }
+    }
+    EXPECT_NE(sink, 1U);
+
+    std::vector <double> sorted = ns;
+    std::nth_element(sorted.begin(), sorted.begin() + samples * 9 / 10, sorted.end());
+    const double crop = sorted[samples * 9 / 10];
+
+    double n[2] = {0, 0}, mean[2] = {0, 0}, m2[2] = {0, 0};
+    for(std::size_t i = 0; i < samples; i++){
+        if (ns[i] <= crop){
+            // Welford's running mean and variance
+            const unsigned c = cls[i];
+            n[c]++;
+            const double delta = ns[i] - mean[c];
+            mean[c] += delta / n[c];
+            m2[c] += delta * (ns[i] - mean[c]);
+        }
+    }
+    return (mean[0] - mean[1]) / std::sqrt(m2[0] / (n[0] - 1) / n[0] + m2[1] / (n[1] - 1) / n[1]);
+}
+
+TEST(CT, timing){
+    // the fixed inputs are the ones the operators take shortcuts on
+    const double div = dudect_t([](const uint128_t & a, const uint128_t & b){ return ct::div(a, b); }, 1, MAX);
+    const double lt = dudect_t([](const uint128_t & a, const uint128_t & b){ return ct::select(ct::lt(a, b), a, b); }, 5, 5);
+    const double shl = dudect_t([](const uint128_t & a, const uint128_t & b){ return ct::shl(a, b.lower() & 255); }, MAX, 0);
+    const double bits = dudect_t([](const uint128_t & a, const uint128_t &){ return uint128_t(ct::bits(a)); }, 0, 1);
+    EXPECT_LT(std::fabs(div), 10) << div;
+    EXPECT_LT(std::fabs(lt), 10) << lt;
+    EXPECT_LT(std::fabs(shl), 10) << shl;
+    EXPECT_LT(std::fabs(bits), 10) << bits;
+
+    // the test itself: operator/ returns at once when a < b
+    const double leaky = dudect_t([](const uint128_t & a, const uint128_t & b){ return a / b; }, 1, MAX);
+    EXPECT_GT(std::fabs(leaky), 10) << leaky;
+}
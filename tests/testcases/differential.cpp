@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "../differential.h"
+
+#if defined(UINT128_T_DIFFERENTIAL)
+
+// short runs of what soak.cpp runs for minutes, with fixed seeds
+
+TEST(Differential, edges){
+    // every pair of fixed edge values, and their neighbours
+    const differential::u128 edges[] = {
+        0, 1, 2, 3, 10, 0xffffffffULL, 0x100000000ULL,
+        ((differential::u128) 1 << 63) - 1, (differential::u128) 1 << 63,
+        ((differential::u128) 1 << 64) - 1, (differential::u128) 1 << 64, ((differential::u128) 1 << 64) + 1,
+        ((differential::u128) 1 << 127) - 1, (differential::u128) 1 << 127, ~(differential::u128) 0 - 1, ~(differential::u128) 0,
+    };
+    for(const differential::u128 a : edges){
+        for(const differential::u128 b : edges){
+            EXPECT_EQ(differential::check(differential::ours(a), differential::ours(b)), "");
+        }
+    }
+}
+
+TEST(Differential, operators){
+    xoshiro256 gen(0x5eed);
+    for(int i = 0; i < 100000; i++){
+        const uint128_t a = differential::edge_operand(gen);
+        const uint128_t b = differential::edge_operand(gen);
+        const std::string error = differential::check(a, b, false);
+        ASSERT_EQ(error, "");
+    }
+}
+
+TEST(Differential, text){
+    xoshiro256 gen(0x7e47);
+    for(int i = 0; i < 2000; i++){
+        const uint128_t a = differential::edge_operand(gen);
+        const uint128_t b = differential::edge_operand(gen);
+        const std::string error = differential::check_text(a, b);
+        ASSERT_EQ(error, "");
+    }
+}
+
+TEST(Differential, bytes){
+    // short fuzzer inputs are zero extended
+    const unsigned char data[] = {0xff, 0x01, 0x80};
+    for(std::size_t n = 0; n <= sizeof(data); n++){
+        EXPECT_EQ(differential::check_bytes(data, n), "");
+    }
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+
+// operands that hit the interesting limb boundaries
+static uint128_t edge(xoshiro256 & gen){
+    static const uint64_t words[] = {0, 1, 2, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0xffffffffffffffffULL};
+    const uint128_t r = gen();
+    switch ((uint64_t) r % 4){
+        case 0:
+            return uint128_t(words[(r.upper() >> 8) % 6], words[(r.upper() >> 16) % 6]);
+        case 1:
+            return uint128_t(0, r.lower());
+        case 2:
+            return r >> ((unsigned) (r.upper() % 128));
+        default:
+            return r;
+    }
+}
+
+TEST(Dispatch, names){
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        EXPECT_EQ(uint128_isa_from_name(uint128_isa_name(isa)), isa);
+    }
+    EXPECT_THROW(uint128_isa_from_name("sse9"), std::invalid_argument);
+}
+
+TEST(Dispatch, select){
+    const uint128_isa original = uint128_active_isa();
+
+    EXPECT_EQ(uint128_set_isa(uint128_isa::generic), uint128_isa::generic);
+    EXPECT_EQ(uint128_active_isa(), uint128_isa::generic);
+
+    // requests above what the CPU can do are lowered
+    EXPECT_EQ(uint128_set_isa(uint128_isa::avx512), uint128_detected_isa());
+
+    uint128_set_isa(original);
+    EXPECT_EQ(uint128_active_isa(), original);
+
+    EXPECT_NE(uint128_kernels_for(uint128_isa::generic), nullptr);
+}
+
+TEST(Dispatch, kernels_agree){
+    const uint128_kernels * reference = uint128_kernels_for(uint128_isa::generic);
+    ASSERT_NE(reference, nullptr);
+
+    for(const uint128_isa isa : {uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+
+        xoshiro256 gen(12345);
+        for(int i = 0; i < 20000; i++){
+            const uint128_t a = edge(gen);
+            const uint128_t b = edge(gen);
+
+            EXPECT_EQ(k -> mul(a, b), reference -> mul(a, b));
+            EXPECT_EQ(k -> bits(a), reference -> bits(a));
+
+            if (b){
+                uint128_t q1, r1, q2, r2;
+                k -> divmod(a, b, q1, r1);
+                reference -> divmod(a, b, q2, r2);
+                EXPECT_EQ(q1, q2);
+                EXPECT_EQ(r1, r2);
+            }
+
+            char s1[128], s2[128];
+            const uint8_t base = 2 + (uint8_t) (i % 15);
+            const std::size_t n1 = k -> format(a, base, s1);
+            const std::size_t n2 = reference -> format(a, base, s2);
+            EXPECT_EQ(std::string(s1, n1), std::string(s2, n2));
+        }
+
+        const std::size_t count = 37;
+        uint128_t lhs[count], rhs[count], out1[count], out2[count];
+        for(std::size_t i = 0; i < count; i++){
+            lhs[i] = edge(gen);
+            rhs[i] = edge(gen);
+        }
+        k -> mul_n(lhs, rhs, out1, count);
+        reference -> mul_n(lhs, rhs, out2, count);
+        for(std::size_t i = 0; i < count; i++){
+            EXPECT_EQ(out1[i], out2[i]);
+        }
+    }
+}
+
+TEST(Dispatch, divmod){
+    // q * d + r == n and r < d, whatever level is active
+    xoshiro256 gen(777);
+    for(int i = 0; i < 20000; i++){
+        const uint128_t n = edge(gen);
+        const uint128_t d = edge(gen);
+        if (!d){
+            continue;
+        }
+        const uint128_t q = n / d;
+        const uint128_t r = n % d;
+        EXPECT_LT(r, d);
+        EXPECT_EQ(q * d + r, n);
+    }
+}
+
+TEST(Dispatch, multiply){
+    const uint128_t lhs[3] = {uint128_t(1, 2), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL), 3};
+    const uint128_t rhs[3] = {uint128_t(0, 3), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL), 5};
+    uint128_t out[3];
+    multiply(lhs, rhs, out, 3);
+    EXPECT_EQ(out[0], uint128_t(3, 6));
+    EXPECT_EQ(out[1], 1);
+    EXPECT_EQ(out[2], 15);
+}
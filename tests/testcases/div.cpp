@@ -39,3 +39,25 @@ TEST(External, divide){
     EXPECT_EQ(u32 /= val, (uint32_t) 0x163356bULL);
     EXPECT_EQ(u64 /= val, (uint64_t) 0x163356b88ac0de0ULL);
 }
+
+TEST(Arithmetic, divide_integral){
+    const uint128_t vals[] = {0, 1, 0xfedbca9876543210ULL, uint128_t(0xfedbca9876543210ULL, 0x0123456789abcdefULL),
+                              uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)};
+    const int64_t rhs[] = {1, 3, 10, 0x7fffffff, INT64_MAX, -1, -7, INT64_MIN};
+    for(const uint128_t & val : vals){
+        for(const int64_t r : rhs){
+            // same as going through divmod
+            EXPECT_EQ(val / r,              val / uint128_t(r));
+            EXPECT_EQ(val / (uint64_t) r,   val / uint128_t((uint64_t) r));
+            EXPECT_EQ(val / ((uint32_t) r | 1), val / uint128_t((uint32_t) r | 1));
+            EXPECT_EQ(r / (val | 1),        uint128_t(r) / (val | 1));
+        }
+    }
+
+    // a negative divisor is 2^128 - |rhs|
+    EXPECT_EQ(uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL) / -1, 1);
+    EXPECT_EQ(uint128_t(5) / -1, 0);
+
+    EXPECT_THROW(uint128_t(1) / 0, std::domain_error);
+    EXPECT_THROW(1 / uint128_t(0), std::domain_error);
+}
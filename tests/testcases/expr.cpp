@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "uint128_t_expr.h"
+#include "uint128_t_random.h"
+
+static const uint128_t MAX(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+// (a * b) mod m by doubling, never leaving 128 bits
+static uint128_t reference_mulmod(uint128_t a, uint128_t b, const uint128_t & m){
+    a %= m;
+    uint128_t r = 0;
+    for(int i = 127; i >= 0; i--){
+        r = (r >= m - r) ? r - (m - r) : r + r;
+        if ((b >> i) & 1){
+            r = (r >= m - a) ? r - (m - a) : r + a;
+        }
+    }
+    return r;
+}
+
+TEST(Expr, matches_operators){
+    xoshiro256 gen(311);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen(), b = gen(), c = gen(), d = (gen() >> ((unsigned) gen() % 128)) | 1;
+        const unsigned s = (unsigned) gen() % 130;
+
+        EXPECT_EQ(uint128_t(lazy(a) + b - c), a + b - c);
+        EXPECT_EQ(uint128_t(lazy(a) * b * c), a * b * c);
+        EXPECT_EQ(uint128_t((lazy(a) & b) | (c ^ d)), (a & b) | (c ^ d));
+        EXPECT_EQ(uint128_t(~lazy(a) + -lazy(b)), ~a + -b);
+        EXPECT_EQ(uint128_t(lazy(a) / d + b % d), a / d + b % d);
+        EXPECT_EQ(uint128_t(lazy(a) << s), a << s);
+        EXPECT_EQ(uint128_t(lazy(a) >> s), a >> s);
+        EXPECT_EQ(uint128_t((lazy(a) << 3) | ((b >> 5) ^ c)), (a << 3) | ((b >> 5) ^ c));
+        EXPECT_EQ(uint128_t(a + lazy(b) * 7 + 1), a + b * 7 + 1);
+        EXPECT_EQ(uint128_t(5 - lazy(a)), 5 - a);
+        EXPECT_EQ(uint128_t(lazy(a) << (lazy(b) & 127)), a << (b & 127));
+
+        EXPECT_TRUE(lazy(a) * b == a * b);
+        EXPECT_EQ(lazy(a) < b, a < b);
+        EXPECT_EQ(lazy(a) + c >= b, a + c >= b);
+    }
+}
+
+TEST(Expr, shift_chains){
+    const uint128_t x(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    for(unsigned i = 0; i <= 128; i += 3){
+        for(unsigned j = 0; j <= 128; j += 5){
+            EXPECT_EQ(uint128_t((lazy(x) << i) << j), (x << i) << j);
+            EXPECT_EQ(uint128_t((lazy(x) >> i) >> j), (x >> i) >> j);
+            EXPECT_EQ(uint128_t(((lazy(x) << i) >> j) & 0xff), ((x << i) >> j) & 0xff);
+        }
+    }
+
+    // out of range amounts shift everything out
+    EXPECT_EQ(uint128_t(lazy(x) << 200), 0);
+    EXPECT_EQ(uint128_t(lazy(x) >> -1), 0);
+    EXPECT_EQ(uint128_t(lazy(x) << uint128_t(1, 0)), 0);
+}
+
+TEST(Expr, mulmod){
+    // exact, unlike (a * b) % m with the plain operators
+    EXPECT_EQ(uint128_t(lazy(MAX) * MAX % 7), reference_mulmod(MAX, MAX, 7));
+    EXPECT_EQ(uint128_t(lazy(MAX) * MAX % (MAX - 1)), 1);
+    EXPECT_EQ(uint128_t((lazy(MAX) * MAX + MAX) % MAX), 0);
+    // 2^129 mod 3; the truncated sum would give 0
+    EXPECT_EQ(uint128_t((2 + lazy(MAX) * 2) % 3), 2);
+
+    xoshiro256 gen(313);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen(), b = gen() >> ((unsigned) gen() % 128), c = gen();
+        const uint128_t m = (gen() >> ((unsigned) gen() % 128)) | 1;
+        const uint128_t ab = reference_mulmod(a, b, m);
+        EXPECT_EQ(uint128_t(lazy(a) * b % m), ab);
+
+        const uint128_t cm = c % m;
+        const uint128_t expected = (ab >= m - cm) ? ab - (m - cm) : ab + cm;
+        EXPECT_EQ(uint128_t((lazy(a) * b + c) % m), expected);
+        EXPECT_EQ(uint128_t((c + lazy(a) * b) % m), expected);
+
+        // small operands agree with the plain operators
+        const uint128_t x = a >> 64, y = b >> 64;
+        EXPECT_EQ(uint128_t(lazy(x) * y % m), x * y % m);
+    }
+
+    EXPECT_THROW(uint128_t(lazy(MAX) * 3 % 0), std::domain_error);
+    EXPECT_THROW(uint128_t(lazy(MAX) / 0), std::domain_error);
+}
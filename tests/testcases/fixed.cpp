@@ -0,0 +1,274 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_fixed.h"
+#include "uint128_t_fma.h"
+#include "uint128_t_random.h"
+
+static const uint128_t MAX(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+// reference: value / 10^scale rounded with the slow operators
+static uint128_t reference_round(const uint128_t & q, const uint128_t & r, const uint128_t & d, const fixed_rounding mode){
+    if (!r){
+        return q;
+    }
+    switch (mode){
+        case fixed_rounding::down:
+            return q;
+        case fixed_rounding::up:
+            return q + 1;
+        default:
+            break;
+    }
+    const uint128_t rest = d - r;
+    if (r != rest){
+        return (r > rest) ? q + 1 : q;
+    }
+    const bool up = (mode == fixed_rounding::half_up) || ((mode == fixed_rounding::half_even) && (q & 1));
+    return up ? q + 1 : q;
+}
+
+static const fixed_rounding MODES[] = {fixed_rounding::down, fixed_rounding::up, fixed_rounding::half_down,
+                                       fixed_rounding::half_up, fixed_rounding::half_even};
+
+TEST(Fixed, constants){
+    EXPECT_EQ(fixed128 <0>::one(), 1);
+    EXPECT_EQ(fixed128 <18>::one(), 1000000000000000000ULL);
+    EXPECT_EQ(fixed128 <20>::one(), uint128_t(5, 0x6bc75e2d63100000ULL));
+    EXPECT_EQ(fixed128 <38>::one(), uint128_t(0x4b3b4ca85a86c47aULL, 0x098a224000000000ULL));
+
+    static_assert(fixed128 <18>::one_lower == 1000000000000000000ULL, "10^18");
+    static_assert(fixed128 <38>::one_upper == 0x4b3b4ca85a86c47aULL, "10^38");
+    static_assert(fixed128 <18>::scale == 18, "scale");
+}
+
+TEST(Fixed, construct){
+    EXPECT_EQ(fixed128 <2>(5).raw(), 500);
+    EXPECT_EQ(fixed128 <18>(uint128_t(3)).raw(), uint128_t(3000000000000000000ULL));
+    EXPECT_EQ(fixed128 <2>::from_raw(1234).integer(), 12);
+    EXPECT_EQ(fixed128 <2>::from_raw(1234).fraction(), 34);
+
+    // 10^38 * 4 does not fit
+    EXPECT_THROW(fixed128 <38>(4), std::overflow_error);
+    EXPECT_EQ(fixed128 <38>(3).raw(), fixed128 <38>::one() * 3);
+}
+
+TEST(Fixed, format){
+    EXPECT_EQ(fixed128 <0>(7).str(), "7");
+    EXPECT_EQ(fixed128 <2>(5).str(), "5.00");
+    EXPECT_EQ(fixed128 <3>::from_raw(12345).str(), "12.345");
+    EXPECT_EQ(fixed128 <3>::from_raw(5).str(), "0.005");
+    EXPECT_EQ(fixed128 <18>::from_raw(1).str(), "0.000000000000000001");
+    EXPECT_EQ(fixed128 <38>::from_raw(MAX).str(), "3.40282366920938463463374607431768211455");
+    EXPECT_EQ(fixed128 <0>::from_raw(MAX).str(), "340282366920938463463374607431768211455");
+    EXPECT_EQ(fixed128 <20>::from_raw(MAX).str(), "3402823669209384634.63374607431768211455");
+
+    std::stringstream s;
+    s << fixed128 <1>::from_raw(15);
+    EXPECT_EQ(s.str(), "1.5");
+}
+
+TEST(Fixed, parse){
+    EXPECT_EQ(fixed128 <3>(std::string("12.345")).raw(), 12345);
+    EXPECT_EQ(fixed128 <3>(std::string("12.3")).raw(), 12300);
+    EXPECT_EQ(fixed128 <3>(std::string("12")).raw(), 12000);
+    EXPECT_EQ(fixed128 <18>::parse("0.5", 3).raw(), 500000000000000000ULL);
+    EXPECT_EQ(fixed128 <38>(std::string("3.40282366920938463463374607431768211455")).raw(), MAX);
+    EXPECT_EQ(fixed128 <0>(std::string("340282366920938463463374607431768211455")).raw(), MAX);
+
+    EXPECT_THROW(fixed128 <2>(std::string("")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <2>(std::string("1.")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <2>(std::string(".5")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <2>(std::string("1.234")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <2>(std::string("1,5")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <2>(std::string("-1")), std::invalid_argument);
+    EXPECT_THROW(fixed128 <0>(std::string("340282366920938463463374607431768211456")), std::overflow_error);
+    EXPECT_THROW(fixed128 <38>(std::string("3.40282366920938463463374607431768211456")), std::overflow_error);
+    EXPECT_THROW(fixed128 <18>(std::string("1000000000000000000000")), std::overflow_error);
+}
+
+template <unsigned Scale>
+static void round_trip(xoshiro256 & gen){
+    for(int i = 0; i < 500; i++){
+        const uint128_t raw = gen() >> ((unsigned) gen() % 128);
+        const fixed128 <Scale> x = fixed128 <Scale>::from_raw(raw);
+        const std::string s = x.str();
+        EXPECT_EQ(fixed128 <Scale>(s), x) << s;
+
+        // integer and fraction agree with the slow operators
+        EXPECT_EQ(x.integer(),  raw / fixed128 <Scale>::one());
+        EXPECT_EQ(x.fraction(), raw % fixed128 <Scale>::one());
+    }
+}
+
+TEST(Fixed, round_trip){
+    xoshiro256 gen(30);
+    round_trip <0>(gen);
+    round_trip <1>(gen);
+    round_trip <6>(gen);
+    round_trip <18>(gen);
+    round_trip <19>(gen);
+    round_trip <20>(gen);
+    round_trip <27>(gen);
+    round_trip <28>(gen);
+    round_trip <33>(gen);
+    round_trip <38>(gen);
+}
+
+TEST(Fixed, mul_rounding){
+    typedef fixed128 <1> f1;
+    const f1 a = f1::from_raw(5), b = f1::from_raw(7), c = f1::from_raw(3);
+
+    // 0.25
+    EXPECT_EQ(a.mul(a, fixed_rounding::down).raw(),      2);
+    EXPECT_EQ(a.mul(a, fixed_rounding::up).raw(),        3);
+    EXPECT_EQ(a.mul(a, fixed_rounding::half_down).raw(), 2);
+    EXPECT_EQ(a.mul(a, fixed_rounding::half_up).raw(),   3);
+    EXPECT_EQ(a.mul(a, fixed_rounding::half_even).raw(), 2);
+    EXPECT_EQ((a * a).raw(), 2);
+
+    // 0.35 and 0.15
+    EXPECT_EQ(a.mul(b, fixed_rounding::half_even).raw(), 4);
+    EXPECT_EQ(a.mul(b, fixed_rounding::half_down).raw(), 3);
+    EXPECT_EQ(a.mul(c, fixed_rounding::half_even).raw(), 2);
+
+    // 0.09
+    EXPECT_EQ(c.mul(c, fixed_rounding::down).raw(),      0);
+    EXPECT_EQ(c.mul(c, fixed_rounding::half_down).raw(), 1);
+
+    // 1.5 * 2 is exact
+    EXPECT_EQ(f1::from_raw(15) * f1(2), f1(3));
+}
+
+TEST(Fixed, mul){
+    xoshiro256 gen(31);
+    const uint128_t one = fixed128 <18>::one();
+    for(int i = 0; i < 2000; i++){
+        // both below 2^64 so the reference product fits in 128 bits
+        const uint128_t a = (uint64_t) gen() >> ((unsigned) gen() % 64);
+        const uint128_t b = (uint64_t) gen();
+        const uint128_t p = a * b;
+        for(const fixed_rounding mode : MODES){
+            EXPECT_EQ(fixed128 <18>::from_raw(a).mul(fixed128 <18>::from_raw(b), mode).raw(),
+                      reference_round(p / one, p % one, one, mode));
+        }
+    }
+
+    // the full 256 bit product is used: 10^19 * 10^19 at scale 38 is 1 * 10^38 / 10^38
+    EXPECT_EQ(fixed128 <38>::from_raw(fixed128 <38>::one()).mul(fixed128 <38>::from_raw(fixed128 <38>::one())),
+              fixed128 <38>(1));
+    EXPECT_EQ(fixed128 <18>(uint128_t(1) << 60).mul(fixed128 <18>(1 << 4)), fixed128 <18>(uint128_t(1) << 64));
+
+    EXPECT_THROW(fixed128 <18>::from_raw(MAX).mul(fixed128 <18>(2)), std::overflow_error);
+}
+
+TEST(Fixed, div){
+    typedef fixed128 <18> f18;
+    EXPECT_EQ((f18(1) / f18(3)).str(), "0.333333333333333333");
+    EXPECT_EQ((f18(2) / f18(3)).str(), "0.666666666666666667");
+    EXPECT_EQ(f18(2).div(f18(3), fixed_rounding::down).str(), "0.666666666666666666");
+    EXPECT_EQ((f18(10) / f18(4)).str(), "2.500000000000000000");
+
+    // ties at the last digit
+    typedef fixed128 <0> f0;
+    EXPECT_EQ(f0(5).div(f0(2), fixed_rounding::half_even), f0(2));
+    EXPECT_EQ(f0(7).div(f0(2), fixed_rounding::half_even), f0(4));
+    EXPECT_EQ(f0(5).div(f0(2), fixed_rounding::half_up),   f0(3));
+    EXPECT_EQ(f0(5).div(f0(2), fixed_rounding::half_down), f0(2));
+
+    xoshiro256 gen(32);
+    const uint128_t one = f18::one();
+    for(int i = 0; i < 2000; i++){
+        // a * 10^18 has to fit in 128 bits for the reference
+        const uint128_t a = gen() >> 64;
+        const uint128_t b = (gen() >> ((unsigned) gen() % 127)) | 1;
+        const uint128_t n = a * one;
+        for(const fixed_rounding mode : MODES){
+            EXPECT_EQ(f18::from_raw(a).div(f18::from_raw(b), mode).raw(), reference_round(n / b, n % b, b, mode));
+        }
+    }
+
+    EXPECT_THROW(f18(1) / f18(), std::domain_error);
+    EXPECT_THROW(f18::from_raw(MAX) / f18::from_raw(1), std::overflow_error);
+
+    // 10 * a / 9 = (2^128 - 1) + 5/9: fits truncated, but rounding up carries out of 128 bits
+    const fixed128 <1> a = fixed128 <1>::from_raw(9 * (MAX / 10) + 5), b = fixed128 <1>::from_raw(9);
+    EXPECT_EQ(a.div(b, fixed_rounding::down).raw(), MAX);
+    EXPECT_THROW(a.div(b, fixed_rounding::up), std::overflow_error);
+}
+
+TEST(Fixed, rescale){
+    const fixed128 <2> x(std::string("1.25"));
+    EXPECT_EQ(x.rescale <1>().raw(), 12);
+    EXPECT_EQ(x.rescale <1>(fixed_rounding::half_up).raw(), 13);
+    EXPECT_EQ(x.rescale <0>().raw(), 1);
+    EXPECT_EQ(x.rescale <4>().str(), "1.2500");
+    EXPECT_EQ(x.rescale <2>(), x);
+    EXPECT_EQ(fixed128 <38>::from_raw(MAX).rescale <0>(fixed_rounding::down), fixed128 <0>(3));
+    EXPECT_THROW(fixed128 <0>::from_raw(MAX).rescale <1>(), std::overflow_error);
+}
+
+TEST(Fixed, compare){
+    typedef fixed128 <4> f4;
+    EXPECT_LT(f4(std::string("1.5")), f4(2));
+    EXPECT_GT(f4(std::string("1.5")), f4(1));
+    EXPECT_EQ(f4(std::string("1.5")) + f4(std::string("0.5")), f4(2));
+    EXPECT_EQ(f4(2) - f4(std::string("0.5")), f4(std::string("1.5")));
+}
+
+TEST(Fixed, muldiv){
+    EXPECT_EQ(muldiv(6, 7, 4), 10);
+    EXPECT_EQ(muldiv_round(6, 7, 4), 10);                                  // 10.5, ties to even
+    EXPECT_EQ(muldiv_round(6, 7, 4, fixed_rounding::half_up), 11);
+    EXPECT_EQ(muldiv(MAX, MAX, MAX), MAX);                                  // the product needs 256 bits
+    EXPECT_EQ(muldiv(MAX, uint128_t(1) << 100, uint128_t(1) << 101), MAX >> 1);
+    EXPECT_EQ(muldiv(MAX, 3, 4), MAX / 4 * 3 + 2);
+
+    // products that fit in 128 bits against the slow operators
+    xoshiro256 gen(41);
+    for(int i = 0; i < 2000; i++){
+        const uint128_t a = gen() >> ((unsigned) gen() % 128);
+        const uint128_t b = gen() >> (64 + (unsigned) gen() % 64);
+        const uint128_t c = (gen() >> ((unsigned) gen() % 128)) | 1;
+        if ((b != 0) && (a > MAX / b)){
+            continue;
+        }
+        const uint128_t n = a * b;
+        EXPECT_EQ(muldiv(a, b, c), n / c);
+        for(const fixed_rounding mode : MODES){
+            EXPECT_EQ(muldiv_round(a, b, c, mode), reference_round(n / c, n % c, c, mode));
+        }
+    }
+
+    // wide products: q * c + r == a * b with r < c
+    for(int i = 0; i < 2000; i++){
+        const uint128_t a = gen(), b = gen() >> ((unsigned) gen() % 128);
+        const uint128_t c = (gen() >> ((unsigned) gen() % 128)) | 1;
+        const uint128_wide p = mul_wide(a, b);
+        if (p.upper >= c){
+            EXPECT_THROW(muldiv(a, b, c), std::overflow_error);
+            continue;
+        }
+        const uint128_t q = muldiv(a, b, c);
+        const uint128_t r = p.lower - q * c;
+        uint128_wide back = mul_wide(q, c);
+        EXPECT_LT(r, c);
+        EXPECT_FALSE(fma(back, r, 1));
+        EXPECT_EQ(back.upper, p.upper);
+        EXPECT_EQ(back.lower, p.lower);
+        EXPECT_EQ(muldiv_round(a, b, c, fixed_rounding::up), r ? q + 1 : q);
+    }
+
+    EXPECT_THROW(muldiv(1, 1, 0), std::domain_error);
+    EXPECT_THROW(muldiv(MAX, MAX, 0), std::domain_error);
+    EXPECT_THROW(muldiv(MAX, 2, 1), std::overflow_error);
+    EXPECT_EQ(muldiv(MAX, 2, 2), MAX);
+    EXPECT_EQ(muldiv_round(MAX, 2, 3, fixed_rounding::down), MAX / 3 * 2);
+
+    // 7 * b = 2^129 - 1, so 7 * b / 2 = (2^128 - 1) + 1/2, which only fits truncated
+    const uint128_t b(0x4924924924924924ULL, 0x9249249249249249ULL);
+    EXPECT_EQ(muldiv(7, b, 2), MAX);
+    EXPECT_EQ(muldiv_round(7, b, 2, fixed_rounding::half_down), MAX);
+    EXPECT_THROW(muldiv_round(7, b, 2, fixed_rounding::half_up), std::overflow_error);
+}
@@ -0,0 +1,126 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_fma.h"
+#include "uint128_t_random.h"
+
+static const uint64_t MAX = 0xffffffffffffffffULL;
+
+TEST(FMA, narrow){
+    uint128_t acc = 5;
+    EXPECT_FALSE(fma(acc, 3, 7));
+    EXPECT_EQ(acc, 26);
+
+    acc = uint128_t(0, MAX);
+    EXPECT_FALSE(fma(acc, MAX, MAX));
+    EXPECT_EQ(acc, uint128_t(MAX, 0));
+
+    // (2^64 - 1)^2 + 2^128 - 1 wraps around
+    acc = uint128_t(MAX, MAX);
+    EXPECT_TRUE(fma(acc, MAX, MAX));
+    EXPECT_EQ(acc, uint128_t(MAX - 1, 0));
+
+    xoshiro256 gen(29);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t start = gen();
+        const uint128_t ab = gen();
+        uint128_t acc = start;
+        fma(acc, ab.upper(), ab.lower());
+        EXPECT_EQ(acc, start + uint128_t(ab.upper()) * uint128_t(ab.lower()));
+    }
+}
+
+TEST(FMA, wide){
+    const uint128_t max(MAX, MAX);
+
+    // (2^128 - 1)^2 = 2^256 - 2^129 + 1
+    uint128_wide acc = {0, 0};
+    EXPECT_FALSE(fma(acc, max, max));
+    EXPECT_EQ(acc.upper, uint128_t(MAX, MAX - 1));
+    EXPECT_EQ(acc.lower, 1);
+
+    // + 2^129 - 2 fills every bit
+    EXPECT_FALSE(fma(acc, max, 2));
+    EXPECT_EQ(acc.upper, max);
+    EXPECT_EQ(acc.lower, max);
+
+    EXPECT_TRUE(fma(acc, 1, 1));
+    EXPECT_EQ(acc.upper, 0);
+    EXPECT_EQ(acc.lower, 0);
+
+    const uint128_wide p = mul_wide(uint128_t(1, 0), uint128_t(1, 0));
+    EXPECT_EQ(p.upper, 1);
+    EXPECT_EQ(p.lower, 0);
+
+    // the lower half always matches operator*
+    xoshiro256 gen(31);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen(), b = gen();
+        EXPECT_EQ(mul_wide(a, b).lower, a * b);
+    }
+}
+
+TEST(FMA, dot){
+    xoshiro256 gen(37);
+    for(const std::size_t n : {0, 1, 2, 3, 7, 64, 1001}){
+        std::vector <uint64_t> a(n), b(n);
+        uint128_t expected = 0;
+        for(std::size_t i = 0; i < n; i++){
+            a[i] = (uint64_t) gen();
+            b[i] = (uint64_t) gen();
+            expected += uint128_t(a[i]) * uint128_t(b[i]);
+        }
+        EXPECT_EQ(dot(a.data(), b.data(), n), expected);
+    }
+}
+
+TEST(FMA, dot_overflow){
+    // n * (2^64 - 1)^2 does not fit in 128 bits for n > 1
+    const std::size_t n = 1001;
+    std::vector <uint64_t> a(n, MAX), b(n, MAX);
+
+    uint128_t expected_lo = 0;
+    uint64_t expected_hi = 0;
+    const uint128_t square(MAX - 1, 1);
+    for(std::size_t i = 0; i < n; i++){
+        expected_lo += square;
+        expected_hi += (expected_lo < square);
+    }
+
+    uint64_t overflow = 0;
+    EXPECT_EQ(dot(a.data(), b.data(), n, overflow), expected_lo);
+    EXPECT_EQ(overflow, expected_hi);
+    EXPECT_EQ(overflow, 1000U);
+
+    EXPECT_EQ(dot(a.data(), b.data(), 1, overflow), square);
+    EXPECT_EQ(overflow, 0U);
+}
+
+TEST(FMA, dot_kernels_agree){
+    const uint128_kernels * reference = uint128_kernels_for(uint128_isa::generic);
+    ASSERT_NE(reference, nullptr);
+
+    xoshiro256 gen(41);
+    std::vector <uint64_t> a(257), b(257);
+    for(std::size_t i = 0; i < a.size(); i++){
+        a[i] = (i % 5) ? (uint64_t) gen() : MAX;
+        b[i] = (i % 3) ? (uint64_t) gen() : MAX;
+    }
+
+    for(const uint128_isa isa : {uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+        for(std::size_t n = 0; n <= a.size(); n += 17){
+            uint64_t expected[3], got[3];
+            reference -> dot(a.data(), b.data(), n, expected);
+            k -> dot(a.data(), b.data(), n, got);
+            EXPECT_EQ(got[0], expected[0]);
+            EXPECT_EQ(got[1], expected[1]);
+            EXPECT_EQ(got[2], expected[2]);
+        }
+    }
+}
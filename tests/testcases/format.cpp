@@ -0,0 +1,117 @@
+#include <iterator>
+#include <locale>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#if defined(__has_include)
+  #if __has_include(<fmt/format.h>)
+    #define FMT_HEADER_ONLY
+    #include <fmt/format.h>
+  #endif
+#endif
+
+#include "uint128_t_format.h"
+
+static const uint128_t MAX(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+static std::string format(const uint128_t & value, const char * spec, const char * grouping = "", const char separator = ','){
+    uint128_format_spec parsed;
+    const char * end = spec + std::char_traits <char>::length(spec);
+    const char * stop = uint128_parse_format_spec(spec, end, parsed);
+    EXPECT_EQ(stop, end) << spec;
+    std::string out;
+    uint128_format_to(std::back_inserter(out), value, parsed, grouping, separator);
+    return out;
+}
+
+static bool valid(const char * spec){
+    uint128_format_spec parsed;
+    return uint128_parse_format_spec(spec, spec + std::char_traits <char>::length(spec), parsed);
+}
+
+TEST(Format, types){
+    const uint128_t value(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    EXPECT_EQ(format(value, ""),  value.str(10));
+    EXPECT_EQ(format(value, "d"), value.str(10));
+    EXPECT_EQ(format(value, "x"), value.str(16));
+    EXPECT_EQ(format(value, "X"), "123456789ABCDEFFEDCBA9876543210");
+    EXPECT_EQ(format(value, "o"), value.str(8));
+    EXPECT_EQ(format(value, "b"), value.str(2));
+    EXPECT_EQ(format(MAX, "d"),   "340282366920938463463374607431768211455");
+    EXPECT_EQ(format(0, "b"),     "0");
+}
+
+TEST(Format, prefix_and_sign){
+    EXPECT_EQ(format(255, "#x"), "0xff");
+    EXPECT_EQ(format(255, "#X"), "0XFF");
+    EXPECT_EQ(format(5,   "#b"), "0b101");
+    EXPECT_EQ(format(5,   "#B"), "0B101");
+    EXPECT_EQ(format(8,   "#o"), "010");
+    EXPECT_EQ(format(0,   "#o"), "0");
+    EXPECT_EQ(format(7,   "#d"), "7");
+    EXPECT_EQ(format(7,   "+"),  "+7");
+    EXPECT_EQ(format(7,   " "),  " 7");
+    EXPECT_EQ(format(7,   "-"),  "7");
+}
+
+TEST(Format, width_and_fill){
+    EXPECT_EQ(format(42, "6"),      "    42");
+    EXPECT_EQ(format(42, "<6"),     "42    ");
+    EXPECT_EQ(format(42, "^6"),     "  42  ");
+    EXPECT_EQ(format(42, "^7"),     "  42   ");
+    EXPECT_EQ(format(42, "*>6"),    "****42");
+    EXPECT_EQ(format(42, "06"),     "000042");
+    EXPECT_EQ(format(42, "+#08x"),  "+0x0002a");
+    EXPECT_EQ(format(42, "<06"),    "42    ");     // alignment wins over zero padding
+    EXPECT_EQ(format(42, "1"),      "42");
+    EXPECT_EQ(format(42, "\xc2\xb7^6"), "\xc2\xb7\xc2\xb7" "42" "\xc2\xb7\xc2\xb7");
+
+    // wider than the body buffer
+    const std::string wide = format(MAX, "#0300b");
+    EXPECT_EQ(wide.size(), 300U);
+    EXPECT_EQ(wide.substr(0, 4), "0b00");
+}
+
+TEST(Format, grouping){
+    EXPECT_EQ(format(1234567, "L",  "\3"),         "1,234,567");
+    EXPECT_EQ(format(1234567, "",   "\3"),         "1234567");     // only with L
+    EXPECT_EQ(format(123,     "L",  "\3"),         "123");
+    EXPECT_EQ(format(1234567, "L",  "\3\2", '.'),  "12.34.567");
+    EXPECT_EQ(format(1234567, "L",  "\2\x7f"),     "12345,67");
+    EXPECT_EQ(format(1234567, "010L", "\3"),       "01,234,567");
+    EXPECT_EQ(format(MAX, "L", "\3"),              "340,282,366,920,938,463,463,374,607,431,768,211,455");
+    EXPECT_EQ(format(MAX, "Lb", "\1").size(),      255U);
+}
+
+TEST(Format, invalid){
+    EXPECT_TRUE(valid(""));
+    EXPECT_TRUE(valid("}"));
+    EXPECT_TRUE(valid("*^+#030Lx"));
+    EXPECT_FALSE(valid(".3"));
+    EXPECT_FALSE(valid("{}"));
+    EXPECT_FALSE(valid("s"));
+    EXPECT_FALSE(valid("c"));
+    EXPECT_FALSE(valid("xx"));
+    EXPECT_FALSE(valid("{<5"));
+}
+
+#if defined(FMT_VERSION)
+struct grouping_3 : std::numpunct <char>{
+    char do_thousands_sep() const override{ return '\''; }
+    std::string do_grouping() const override{ return "\3"; }
+};
+
+TEST(Format, fmt){
+    const uint128_t value(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    EXPECT_EQ(fmt::format("{}", value), value.str());
+    EXPECT_EQ(fmt::format("[{:>#40X}]", value), "[" + std::string(7, ' ') + "0X123456789ABCDEFFEDCBA9876543210]");
+    EXPECT_EQ(fmt::format("{:08b} {}", uint128_t(5), 7), "00000101 7");
+    EXPECT_EQ(fmt::format(std::locale(std::locale(), new grouping_3), "{:L}", uint128_t(1234567)), "1'234'567");
+    EXPECT_THROW((void) fmt::format(fmt::runtime("{:.2}"), value), fmt::format_error);
+
+    char buf[64];
+    char * end = fmt::format_to(buf, "{:x}", MAX);
+    EXPECT_EQ(std::string(buf, end - buf), std::string(32, 'f'));
+}
+#endif
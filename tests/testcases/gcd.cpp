@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "uint128_t_gcd.h"
+#include "uint128_t_random.h"
+
+static const uint128_t MAX(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+static uint128_t euclid(uint128_t a, uint128_t b){
+    while (b){
+        const uint128_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// |v| of a two's complement value
+static uint128_t magnitude(const uint128_t & v){
+    return (v.upper() >> 63) ? -v : v;
+}
+
+TEST(GCD, gcd){
+    EXPECT_EQ(gcd(0, 0), 0);
+    EXPECT_EQ(gcd(0, 12), 12);
+    EXPECT_EQ(gcd(12, 0), 12);
+    EXPECT_EQ(gcd(12, 18), 6);
+    EXPECT_EQ(gcd(MAX, MAX), MAX);
+    EXPECT_EQ(gcd(MAX, MAX - 1), 1);
+    EXPECT_EQ(gcd(uint128_t(1) << 127, uint128_t(1) << 100), uint128_t(1) << 100);
+    EXPECT_EQ(gcd(uint128_t(3) << 90, uint128_t(6) << 70), uint128_t(3) << 71);
+    EXPECT_EQ(gcd(MAX, 3 * 5 * 17), 3 * 5 * 17);                // 2^128 - 1 = 3 * 5 * 17 * 257 * ...
+
+    xoshiro256 gen(42);
+    for(int i = 0; i < 5000; i++){
+        uint128_t a = gen() >> ((unsigned) gen() % 128);
+        uint128_t b = gen() >> ((unsigned) gen() % 128);
+        const uint128_t common = gen() >> (64 + (unsigned) gen() % 64);
+        if ((i & 1) && (a.bits() + common.bits() <= 128) && (b.bits() + common.bits() <= 128)){
+            a *= common;
+            b *= common;
+        }
+        EXPECT_EQ(gcd(a, b), euclid(a, b));
+    }
+}
+
+TEST(GCD, lcm){
+    EXPECT_EQ(lcm(0, 5), 0);
+    EXPECT_EQ(lcm(5, 0), 0);
+    EXPECT_EQ(lcm(4, 6), 12);
+    EXPECT_EQ(lcm(MAX, MAX), MAX);
+    EXPECT_EQ(lcm(MAX, 3), MAX);
+    EXPECT_EQ(lcm(uint128_t(1) << 127, 2), uint128_t(1) << 127);
+    EXPECT_THROW(lcm(uint128_t(1) << 127, 3), std::overflow_error);
+    EXPECT_THROW(lcm(MAX, MAX - 1), std::overflow_error);
+}
+
+TEST(GCD, ext_gcd){
+    const uint128_bezout r = ext_gcd(240, 46);
+    EXPECT_EQ(r.gcd, 2);
+    EXPECT_EQ(r.x, -uint128_t(9));
+    EXPECT_EQ(r.y, 47);
+
+    EXPECT_EQ(ext_gcd(0, 0).gcd, 0);
+    EXPECT_EQ(ext_gcd(7, 0).x, 1);
+    EXPECT_EQ(ext_gcd(0, 7).y, 1);
+
+    xoshiro256 gen(7);
+    for(int i = 0; i < 5000; i++){
+        const uint128_t a = gen() >> ((unsigned) gen() % 128);
+        const uint128_t b = gen() >> ((unsigned) gen() % 128);
+        const uint128_bezout e = ext_gcd(a, b);
+        EXPECT_EQ(e.gcd, euclid(a, b));
+        EXPECT_EQ(a * e.x + b * e.y, e.gcd);
+        if ((e.gcd != 0) && (e.gcd != a) && (e.gcd != b)){
+            EXPECT_LE(magnitude(e.x), b / e.gcd / 2);
+            EXPECT_LE(magnitude(e.y), a / e.gcd / 2);
+        }
+    }
+}
+
+TEST(GCD, mod_inverse){
+    uint128_t inverse;
+    EXPECT_TRUE(mod_inverse(3, 7, inverse));
+    EXPECT_EQ(inverse, 5);
+    EXPECT_FALSE(mod_inverse(6, 9, inverse));
+    EXPECT_FALSE(mod_inverse(3, 0, inverse));
+    EXPECT_TRUE(mod_inverse(5, 1, inverse));
+    EXPECT_EQ(inverse, 0);
+
+    // 2^127 - 1 is prime
+    const uint128_t p = MAX >> 1;
+    xoshiro256 gen(11);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen() % p;
+        if (!a){
+            continue;
+        }
+        ASSERT_TRUE(mod_inverse(a, p, inverse));
+        EXPECT_LT(inverse, p);
+
+        // a * inverse = 1 (mod p) without a 256 bit product: sum a * bit over the bits of inverse
+        uint128_t product = 0, addend = a;
+        for(uint128_t bits = inverse; bits; bits >>= 1){
+            if (bits & 1){
+                product = (product + addend) % p;
+            }
+            addend = (addend << 1) % p;
+        }
+        EXPECT_EQ(product, 1);
+    }
+}
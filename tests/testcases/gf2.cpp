@@ -0,0 +1,187 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_gf2.h"
+#include "uint128_t_random.h"
+
+// bit at a time, as written in the GCM specification (algorithm 1)
+static uint128_t gf2_reference(const uint128_t & x, const uint128_t & y){
+    const uint128_t R(0xe100000000000000ULL, 0);
+    uint128_t z = 0, v = y;
+    for(unsigned i = 0; i < 128; i++){
+        if ((x >> (127 - i)) & 1){
+            z ^= v;
+        }
+        const bool low = (v & 1) != 0;
+        v >>= 1;
+        if (low){
+            v ^= R;
+        }
+    }
+    return z;
+}
+
+static uint128_wide clmul_reference(const uint128_t & a, const uint128_t & b){
+    uint128_wide out{0, 0};
+    for(unsigned i = 0; i < 128; i++){
+        if ((b >> i) & 1){
+            out.lower ^= a << i;
+            if (i){
+                out.upper ^= a >> (128 - i);
+            }
+        }
+    }
+    return out;
+}
+
+static std::vector <unsigned char> gf2_bytes(const char * hex){
+    std::vector <unsigned char> out;
+    for(; hex[0] && hex[1]; hex += 2){
+        out.push_back((unsigned char) std::stoul(std::string(hex, 2), nullptr, 16));
+    }
+    return out;
+}
+
+TEST(GF2, clmul){
+    const uint128_wide p = clmul(uint128_t(3), uint128_t(3));
+    EXPECT_EQ(p.upper, 0);
+    EXPECT_EQ(p.lower, 5);      // (x + 1)^2 = x^2 + 1
+
+    const uint128_t ones(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    const uint128_wide q = clmul(ones, uint128_t(1) << 127);
+    EXPECT_EQ(q.upper, ones >> 1);
+    EXPECT_EQ(q.lower, uint128_t(1) << 127);
+
+    xoshiro256 gen(43);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen(), b = gen();
+        const uint128_wide expected = clmul_reference(a, b);
+        const uint128_wide p = clmul(a, b);
+        EXPECT_EQ(p.upper, expected.upper) << a << " " << b;
+        EXPECT_EQ(p.lower, expected.lower) << a << " " << b;
+    }
+}
+
+TEST(GF2, multiply){
+    const gf2_128 one = gf2_128::one();
+    const gf2_128 x(uint128_t(0x4000000000000000ULL, 0));
+    EXPECT_EQ(one * one, one);
+    EXPECT_EQ(x * one, x);
+    EXPECT_EQ(x * gf2_128(), gf2_128());
+
+    // x^127 * x = x^128 = x^7 + x^2 + x + 1
+    EXPECT_EQ(gf2_128(uint128_t(1)) * x, gf2_128(uint128_t(0xe100000000000000ULL, 0)));
+
+    xoshiro256 gen(128);
+    for(int i = 0; i < 1000; i++){
+        const gf2_128 a(gen()), b(gen()), c(gen());
+        EXPECT_EQ((a * b).value(), gf2_reference(a.value(), b.value()));
+        EXPECT_EQ(a * b, b * a);
+        EXPECT_EQ((a + b) * c, a * c + b * c);
+        EXPECT_EQ(a.square(), a * a);
+
+        gf2_128 d = a;
+        d *= b;
+        EXPECT_EQ(d, a * b);
+        d -= a * b;
+        EXPECT_EQ(d, gf2_128());
+    }
+}
+
+TEST(GF2, inverse){
+    EXPECT_EQ(gf2_128::one().inverse(), gf2_128::one());
+    EXPECT_THROW(gf2_128().inverse(), std::domain_error);
+
+    xoshiro256 gen(7);
+    for(int i = 0; i < 100; i++){
+        const gf2_128 a(gen());
+        EXPECT_EQ(a * a.inverse(), gf2_128::one()) << a.value();
+    }
+    const gf2_128 x(uint128_t(0x4000000000000000ULL, 0));
+    EXPECT_EQ(x * x.inverse(), gf2_128::one());
+}
+
+TEST(GF2, load_store){
+    const std::vector <unsigned char> bytes = gf2_bytes("0388dace60b6a392f328c2b971b2fe78");
+    const gf2_128 a = gf2_128::load(bytes.data());
+    EXPECT_EQ(a.value(), uint128_t(0x0388dace60b6a392ULL, 0xf328c2b971b2fe78ULL));
+    unsigned char out[16];
+    a.store(out);
+    EXPECT_EQ(std::vector <unsigned char> (out, out + 16), bytes);
+}
+
+// AES-GCM test case 2 (McGrew and Viega): an empty key, one zero block of plaintext
+TEST(GF2, ghash){
+    const std::vector <unsigned char> h = gf2_bytes("66e94bd4ef8a2c3b884cfa59ca342b2e");
+    const std::vector <unsigned char> data = gf2_bytes("0388dace60b6a392f328c2b971b2fe78"
+                                                       "00000000000000000000000000000080");
+    const std::vector <unsigned char> tag = gf2_bytes("f38cbb1ad69223dcc3457ae5b6b0f885");
+    const gf2_128 H = gf2_128::load(h.data());
+
+    EXPECT_EQ(ghash(H, data.data(), 2), gf2_128::load(tag.data()));
+
+    // in pieces and as elements
+    EXPECT_EQ(ghash(H, data.data() + 16, 1, ghash(H, data.data(), 1)), gf2_128::load(tag.data()));
+    const gf2_128 blocks[2] = {gf2_128::load(data.data()), gf2_128::load(data.data() + 16)};
+    EXPECT_EQ(ghash(H, blocks, 2), gf2_128::load(tag.data()));
+    EXPECT_EQ(ghash(H, data.data(), 0, H), H);
+}
+
+TEST(GF2, ghash_batch){
+    xoshiro256 gen(1024);
+    const gf2_128 h(gen());
+    std::vector <gf2_128> blocks(203);
+    for(gf2_128 & b : blocks){
+        b = gf2_128(gen());
+    }
+    std::vector <unsigned char> bytes(16 * blocks.size());
+    for(std::size_t i = 0; i < blocks.size(); i++){
+        blocks[i].store(bytes.data() + 16 * i);
+    }
+
+    // every length through the 4 block loop and the tail
+    gf2_128 expected(gen());
+    const gf2_128 start = expected;
+    for(std::size_t n = 0; n <= blocks.size(); n++){
+        EXPECT_EQ(ghash(h, bytes.data(), n, start), expected) << n;
+        EXPECT_EQ(ghash(h, blocks.data(), n, start), expected) << n;
+        if (n < blocks.size()){
+            expected = (expected + blocks[n]) * h;
+        }
+    }
+}
+
+// every compiled kernel level against the generic one
+TEST(GF2, kernels_agree){
+    const uint128_kernels * reference = uint128_kernels_for(uint128_isa::generic);
+    ASSERT_NE(reference, nullptr);
+
+    xoshiro256 gen(2);
+    std::vector <unsigned char> data(16 * 37);
+    for(unsigned char & c : data){
+        c = (unsigned char) gen().lower();
+    }
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+        for(int i = 0; i < 100; i++){
+            const uint128_t a = gen(), b = gen();
+            uint64_t expected[4], out[4];
+            reference -> clmul(a, b, expected);
+            k -> clmul(a, b, out);
+            EXPECT_TRUE(std::equal(out, out + 4, expected)) << uint128_isa_name(isa);
+            EXPECT_EQ(k -> gf2_mul(a, b), reference -> gf2_mul(a, b)) << uint128_isa_name(isa);
+        }
+
+        const uint128_t h = gen();
+        uint128_t expected = 5, acc = 5;
+        reference -> ghash_n(h, expected, data.data(), 37);
+        k -> ghash_n(h, acc, data.data(), 37);
+        EXPECT_EQ(acc, expected) << uint128_isa_name(isa);
+    }
+}
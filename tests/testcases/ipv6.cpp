@@ -0,0 +1,210 @@
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <arpa/inet.h>
+  #define UINT128_T_TEST_INET
+#endif
+
+#include "uint128_t_ipv6.h"
+#include "uint128_t_random.h"
+
+static bool parses(const char * str){
+    uint128_t addr;
+    return ipv6_parse(str, std::char_traits <char>::length(str), addr);
+}
+
+TEST(IPv6, parse){
+    EXPECT_EQ(ipv6_parse("2001:db8::1"),              uint128_t(0x20010db800000000ULL, 1));
+    EXPECT_EQ(ipv6_parse("::"),                       uint128_t(0));
+    EXPECT_EQ(ipv6_parse("::1"),                      uint128_t(1));
+    EXPECT_EQ(ipv6_parse("1::"),                      uint128_t(0x0001000000000000ULL, 0));
+    EXPECT_EQ(ipv6_parse("1:2:3:4:5:6:7:8"),          uint128_t(0x0001000200030004ULL, 0x0005000600070008ULL));
+    EXPECT_EQ(ipv6_parse("1:2:3:4:5:6:7::"),          uint128_t(0x0001000200030004ULL, 0x0005000600070000ULL));
+    EXPECT_EQ(ipv6_parse("::2:3:4:5:6:7:8"),          uint128_t(0x0000000200030004ULL, 0x0005000600070008ULL));
+    EXPECT_EQ(ipv6_parse("FFFF:ffff:FfFf:ffff::"),    uint128_t(0xffffffffffffffffULL, 0));
+    EXPECT_EQ(ipv6_parse("0000:0db8:0:0:0:0:0:0001"), uint128_t(0x00000db800000000ULL, 1));
+    EXPECT_EQ(ipv6_parse("::ffff:192.0.2.1"),         uint128_t(0, 0x0000ffffc0000201ULL));
+    EXPECT_EQ(ipv6_parse("64:ff9b::10.0.0.255"),      uint128_t(0x0064ff9b00000000ULL, 0x0a0000ffULL));
+    EXPECT_EQ(ipv6_parse("1:2:3:4:5:6:1.2.3.4"),      uint128_t(0x0001000200030004ULL, 0x0005000601020304ULL));
+
+    const char * invalid[] = {
+        "", ":", ":::", "1:2", "::1::", "1:::2", ":1::", "1::2:", "12345::",
+        "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7:8::", "::1:2:3:4:5:6:7:8", "g::",
+        "::1.2.3", "::1.2.3.256", "::01.2.3.4", "::1.2.3.4:5", "1:2:3:4:5:6:7:1.2.3.4",
+        "::1.2.3.4.", " ::1", "::1%eth0",
+    };
+    for(const char * str : invalid){
+        EXPECT_FALSE(parses(str)) << str;
+    }
+    EXPECT_THROW(ipv6_parse(std::string("1:2")), std::invalid_argument);
+}
+
+TEST(IPv6, format){
+    // RFC 5952 section 4
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:0db8:0000:0000:0000:0000:0000:0001")), "2001:db8::1");
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:db8:0:0:0:0:2:1")),  "2001:db8::2:1");
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:db8:0:1:1:1:1:1")),  "2001:db8:0:1:1:1:1:1");   // a single 0 stays
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:0:0:1:0:0:0:1")),    "2001:0:0:1::1");          // longest run
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:db8:0:0:1:0:0:1")),  "2001:db8::1:0:0:1");      // first of equal runs
+    EXPECT_EQ(ipv6_str(ipv6_parse("2001:DB8::ABCD")),        "2001:db8::abcd");
+
+    EXPECT_EQ(ipv6_str(uint128_t(0)),                               "::");
+    EXPECT_EQ(ipv6_str(uint128_t(1)),                               "::1");
+    EXPECT_EQ(ipv6_str(uint128_t(0x0001000000000000ULL, 0)),        "1::");
+    EXPECT_EQ(ipv6_str(uint128_t(0, 0x0000ffffc0000201ULL)),        "::ffff:192.0.2.1");
+    EXPECT_EQ(ipv6_str(uint128_t(0xfe80000000000000ULL, 0x0210a0fffe0b0c0dULL)), "fe80::210:a0ff:fe0b:c0d");
+
+    const std::string longest = ipv6_str(uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(longest, "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+    EXPECT_EQ(longest.size(), ipv6_max_length);
+}
+
+#if defined(UINT128_T_TEST_INET)
+// random addresses with runs of zero groups round trip and agree with inet_pton / inet_ntop
+TEST(IPv6, inet){
+    xoshiro256 gen(11);
+    for(int i = 0; i < 10000; i++){
+        const uint128_t bits = gen();
+        uint64_t limbs[2] = {bits.upper(), bits.lower()};
+        const uint64_t zeros = gen().upper();
+        for(unsigned g = 0; g < 8; g++){
+            if ((zeros >> (2 * g)) & 3){
+                limbs[g / 4] &= ~(0xffffULL << (48 - 16 * (g % 4)));
+            }
+        }
+        const uint128_t addr(limbs[0], limbs[1]);
+        if (!limbs[0] && !(limbs[1] >> 48) && !(limbs[1] >> 32 & 0xffff)){
+            continue;   // inet_ntop prints the deprecated IPv4-compatible form
+        }
+
+        const std::string text = ipv6_str(addr);
+        EXPECT_EQ(ipv6_parse(text), addr) << text;
+
+        unsigned char bytes[16];
+        for(unsigned b = 0; b < 16; b++){
+            bytes[b] = (unsigned char) (limbs[b / 8] >> (56 - 8 * (b % 8)));
+        }
+        char expected[INET6_ADDRSTRLEN];
+        ASSERT_TRUE(inet_ntop(AF_INET6, bytes, expected, sizeof(expected)));
+        EXPECT_EQ(text, expected);
+    }
+}
+#endif
+
+TEST(IPv6, mask){
+    EXPECT_EQ(ipv6_mask(0),   uint128_t(0));
+    EXPECT_EQ(ipv6_mask(1),   uint128_t(0x8000000000000000ULL, 0));
+    EXPECT_EQ(ipv6_mask(64),  uint128_t(0xffffffffffffffffULL, 0));
+    EXPECT_EQ(ipv6_mask(65),  uint128_t(0xffffffffffffffffULL, 0x8000000000000000ULL));
+    EXPECT_EQ(ipv6_mask(128), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(ipv6_mask(200), ipv6_mask(128));
+
+    for(unsigned length = 0; length <= 128; length++){
+        EXPECT_EQ(ipv6_prefix_length(ipv6_mask(length)), (int) length);
+    }
+    EXPECT_EQ(ipv6_prefix_length(uint128_t(0xffffffffffffffffULL, 1)), -1);
+    EXPECT_EQ(ipv6_prefix_length(uint128_t(0, 1)), -1);
+
+    EXPECT_EQ(ipv6_common_prefix(ipv6_parse("2001:db8::"), ipv6_parse("2001:db9::")), 31U);
+    EXPECT_EQ(ipv6_common_prefix(uint128_t(5), uint128_t(5)), 128U);
+    EXPECT_EQ(ipv6_common_prefix(uint128_t(4), uint128_t(5)), 127U);
+}
+
+TEST(IPv6, cidr){
+    const ipv6_cidr net = ipv6_parse_cidr("2001:db8::ff/32");
+    EXPECT_EQ(net.network, ipv6_parse("2001:db8::"));       // host bits cleared
+    EXPECT_EQ(net.length, 32U);
+    EXPECT_EQ(ipv6_str(net), "2001:db8::/32");
+    EXPECT_EQ(ipv6_str(ipv6_parse_cidr("::/0")), "::/0");
+    EXPECT_EQ(ipv6_str(ipv6_parse_cidr("::ffff:10.1.2.3/128")), "::ffff:10.1.2.3/128");
+
+    EXPECT_TRUE(contains(net, ipv6_parse("2001:db8:ffff::1")));
+    EXPECT_FALSE(contains(net, ipv6_parse("2001:db9::")));
+    EXPECT_TRUE(contains(ipv6_parse_cidr("::/0"), ipv6_parse("fe80::1")));
+    EXPECT_TRUE(contains(ipv6_parse_cidr("::1/128"), uint128_t(1)));
+    EXPECT_FALSE(contains(ipv6_parse_cidr("::1/128"), uint128_t(3)));
+    EXPECT_TRUE(contains(net, ipv6_parse_cidr("2001:db8:1::/48")));
+    EXPECT_FALSE(contains(ipv6_parse_cidr("2001:db8:1::/48"), net));
+
+    for(const char * str : {"::", "::/", "::/129", "::/01", "::/1a", "::/-1", "1::2::/64", "::/1234"}){
+        ipv6_cidr cidr;
+        EXPECT_FALSE(ipv6_parse(str, std::char_traits <char>::length(str), cidr)) << str;
+    }
+    EXPECT_THROW(ipv6_parse_cidr("::1"), std::invalid_argument);
+}
+
+TEST(IPv6, trie){
+    ipv6_trie <int> trie;
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(trie.lookup(uint128_t(1)), nullptr);
+
+    trie.insert(ipv6_parse_cidr("2001:db8::/32"),    1);
+    trie.insert(ipv6_parse_cidr("2001:db8:1::/48"),  2);
+    trie.insert(ipv6_parse_cidr("2001:db8:2::/48"),  3);
+    trie.insert(ipv6_parse_cidr("2001:db8:1:1::/64"), 4);
+    trie.insert(ipv6_parse_cidr("2001:db8:1::1/128"), 5);
+    EXPECT_EQ(trie.size(), 5U);
+
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:ffff::")),   1);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:1::2")),     2);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:2:3::")),    3);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:1:1::9")),   4);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:1::1")),     5);
+    EXPECT_EQ(trie.lookup(ipv6_parse("2001:db9::")),         nullptr);
+
+    // a default route under everything, then a replacement
+    trie.insert(ipv6_parse_cidr("::/0"), 0);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db9::")), 0);
+    trie.insert(ipv6_parse_cidr("2001:db8:1::/48"), 20);
+    EXPECT_EQ(*trie.lookup(ipv6_parse("2001:db8:1::2")), 20);
+    EXPECT_EQ(trie.size(), 6U);
+
+    EXPECT_EQ(*trie.find(ipv6_parse_cidr("2001:db8:1::/48")), 20);
+    EXPECT_EQ(trie.find(ipv6_parse_cidr("2001:db8::/33")), nullptr);
+    EXPECT_EQ(trie.find(ipv6_parse_cidr("2001:db8:1::/47")), nullptr);
+
+    trie.clear();
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(trie.lookup(ipv6_parse("2001:db8::")), nullptr);
+}
+
+// against a linear scan over random nested prefixes
+TEST(IPv6, trie_random){
+    xoshiro256 gen(5);
+    std::map <std::pair <uint128_t, unsigned>, int> networks;
+    std::vector <ipv6_cidr> list;
+    ipv6_trie <int> trie;
+    const uint128_t base(0x20010db800000000ULL, 0);
+    for(int i = 0; i < 2000; i++){
+        // a few bits of variety under 2001:db8::/32 so prefixes nest and share paths
+        const uint128_t addr = base | (gen() >> 96);
+        const ipv6_cidr cidr(addr, 32 + (unsigned) (gen() % 97));
+        networks[std::make_pair(cidr.network, cidr.length)] = i;
+        list.push_back(cidr);
+        trie.insert(cidr, i);
+    }
+    EXPECT_EQ(trie.size(), networks.size());
+
+    for(int i = 0; i < 5000; i++){
+        const uint128_t addr = (i & 1) ? (base | (gen() >> 96)) : list[i % list.size()].network;
+        const int * expected = nullptr;
+        unsigned best = 0;
+        for(std::map <std::pair <uint128_t, unsigned>, int>::const_iterator it = networks.begin(); it != networks.end(); it++){
+            const ipv6_cidr cidr(it->first.first, it->first.second);
+            if (contains(cidr, addr) && (!expected || (cidr.length >= best))){
+                expected = &it->second;
+                best = cidr.length;
+            }
+        }
+        const int * found = trie.lookup(addr);
+        ASSERT_EQ(found == nullptr, expected == nullptr);
+        if (found){
+            EXPECT_EQ(*found, *expected) << ipv6_str(addr);
+        }
+    }
+}
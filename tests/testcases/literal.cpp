@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+
+// folded at compile time
+constexpr uint128_t MAX_DEC = 340282366920938463463374607431768211455_u128;
+constexpr uint128_t MAX_HEX = 0xffffffffffffffffffffffffffffffff_u128;
+constexpr uint128_t MAX_OCT = 03777777777777777777777777777777777777777777_u128;
+constexpr uint128_t MAX_BIN = 0b11111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111111_u128;
+
+static_assert(MAX_DEC.upper() == 0xffffffffffffffffULL && MAX_DEC.lower() == 0xffffffffffffffffULL, "decimal");
+static_assert(MAX_HEX.upper() == 0xffffffffffffffffULL && MAX_HEX.lower() == 0xffffffffffffffffULL, "hex");
+static_assert(MAX_OCT.upper() == 0xffffffffffffffffULL && MAX_OCT.lower() == 0xffffffffffffffffULL, "octal");
+static_assert(MAX_BIN.upper() == 0xffffffffffffffffULL && MAX_BIN.lower() == 0xffffffffffffffffULL, "binary");
+static_assert(uint128_1.lower() == 1, "uint128_1");
+
+TEST(Literal, values){
+    EXPECT_EQ(0_u128, 0);
+    EXPECT_EQ(00_u128, 0);
+    EXPECT_EQ(42_u128, 42);
+    EXPECT_EQ(0x2A_u128, 42);
+    EXPECT_EQ(052_u128, 42);
+    EXPECT_EQ(0B101010_u128, 42);
+
+    // the first value past 64 bits
+    EXPECT_EQ(18446744073709551616_u128, uint128_t(1, 0));
+    EXPECT_EQ(0x10000000000000000_u128, uint128_t(1, 0));
+
+    EXPECT_EQ(0x0123456789abcdefFEDCBA9876543210_u128, uint128_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL));
+    uint128_t p = 1;
+    for(int i = 0; i < 36; i++){
+        p *= 10;
+    }
+    EXPECT_EQ(1000000000000000000000000000000000000_u128, p);
+    EXPECT_EQ(MAX_DEC, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(MAX_HEX, MAX_DEC);
+    EXPECT_EQ(MAX_OCT, MAX_DEC);
+    EXPECT_EQ(MAX_BIN, MAX_DEC);
+
+    // leading zeros and digit separators do not count toward the size
+    EXPECT_EQ(0x0000000000000000000000000000000000000001_u128, 1);
+    EXPECT_EQ(0xffff'ffff'ffff'ffff'ffff_u128, uint128_t(0xffff, 0xffffffffffffffffULL));
+    EXPECT_EQ(1'000'000_u128, 1000000);
+}
+
+TEST(Literal, constexpr_copy){
+    // copies and moves of constants stay constant expressions
+    constexpr uint128_t a = 0x1234_u128;
+    constexpr uint128_t b(a);
+    static_assert(b.lower() == 0x1234, "copy");
+    EXPECT_EQ(b, a);
+}
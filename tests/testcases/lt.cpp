@@ -62,3 +62,16 @@ TEST(External, less_than){
     signed_compare_lt(int32_t);
     signed_compare_lt(int64_t);
 }
+
+TEST(External, less_than_negative){
+    // negative values compare as 2^128 - |value|
+    const uint128_t big(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+    EXPECT_EQ(uint128_t(5) < -1, true);
+    EXPECT_EQ(big < -1,          false);
+    EXPECT_EQ(big <= -1,         true);
+    EXPECT_EQ(big == -1,         true);
+    EXPECT_EQ(-2 < big,          true);
+    EXPECT_EQ(-1 > uint128_t(0), true);
+    EXPECT_EQ(uint128_t(1, 0) > (int64_t) -1, false);
+}
@@ -40,4 +40,20 @@ TEST(External, modulo){
     EXPECT_EQ(u16 %= val, (uint16_t) 0x183ULL);
     EXPECT_EQ(u32 %= val, (uint32_t) 0x249ULL);
     EXPECT_EQ(u64 %= val, (uint64_t) 0xc7fULL);
-}
\ No newline at end of file
+}
+TEST(Arithmetic, modulo_integral){
+    const uint128_t vals[] = {0, 1, 0xfedbca9876543210ULL, uint128_t(0xfedbca9876543210ULL, 0x0123456789abcdefULL),
+                              uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)};
+    const int64_t rhs[] = {1, 3, 10, 0x7fffffff, INT64_MAX, -1, -7, INT64_MIN};
+    for(const uint128_t & val : vals){
+        for(const int64_t r : rhs){
+            EXPECT_EQ(val % r,              val % uint128_t(r));
+            EXPECT_EQ(val % (uint64_t) r,   val % uint128_t((uint64_t) r));
+            EXPECT_EQ(val % ((uint16_t) r | 1), val % uint128_t((uint16_t) r | 1));
+            EXPECT_EQ(r % (val | 1),        uint128_t(r) % (val | 1));
+        }
+    }
+
+    EXPECT_EQ(uint128_t(5) % -1, 5);
+    EXPECT_THROW(uint128_t(1) % 0, std::domain_error);
+}
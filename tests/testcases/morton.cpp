@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_morton.h"
+#include "uint128_t_random.h"
+
+// one bit at a time with the operators
+static uint128_t morton_reference(const uint64_t x, const uint64_t y){
+    uint128_t key = 0;
+    for(unsigned i = 0; i < 64; i++){
+        key |= uint128_t((x >> i) & 1) << (2 * i);
+        key |= uint128_t((y >> i) & 1) << (2 * i + 1);
+    }
+    return key;
+}
+
+TEST(Morton, encode_decode){
+    EXPECT_EQ(morton_encode(0, 0), 0);
+    EXPECT_EQ(morton_encode(1, 0), 1);
+    EXPECT_EQ(morton_encode(0, 1), 2);
+    EXPECT_EQ(morton_encode(3, 5), 0x27);
+    EXPECT_EQ(morton_encode(0xffffffffffffffffULL, 0), uint128_t(0x5555555555555555ULL, 0x5555555555555555ULL));
+    EXPECT_EQ(morton_encode(0, 0xffffffffffffffffULL), uint128_t(0xaaaaaaaaaaaaaaaaULL, 0xaaaaaaaaaaaaaaaaULL));
+
+    xoshiro256 gen(45);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t r = gen();
+        const uint64_t x = r.upper(), y = r.lower();
+        const uint128_t key = morton_encode(x, y);
+        EXPECT_EQ(key, morton_reference(x, y)) << x << " " << y;
+        uint64_t dx, dy;
+        morton_decode(key, dx, dy);
+        EXPECT_EQ(dx, x);
+        EXPECT_EQ(dy, y);
+    }
+}
+
+// every compiled kernel level, for every count up to 13 (the 4-wide loop and its tail)
+TEST(Morton, kernels_agree){
+    xoshiro256 gen(46);
+    std::vector <uint64_t> x(13), y(13);
+    for(std::size_t i = 0; i < x.size(); i++){
+        x[i] = gen().lower();
+        y[i] = gen().upper();
+    }
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+        for(std::size_t count = 0; count <= x.size(); count++){
+            std::vector <uint128_t> keys(count + 1, 7);
+            k -> morton_encode_n(x.data(), y.data(), count, keys.data());
+            for(std::size_t i = 0; i < count; i++){
+                EXPECT_EQ(keys[i], morton_reference(x[i], y[i])) << uint128_isa_name(isa) << " " << count << " " << i;
+            }
+            EXPECT_EQ(keys[count], 7);
+
+            std::vector <uint64_t> dx(count + 1, 7), dy(count + 1, 7);
+            k -> morton_decode_n(keys.data(), count, dx.data(), dy.data());
+            EXPECT_TRUE(std::equal(dx.begin(), dx.begin() + count, x.begin())) << uint128_isa_name(isa) << " " << count;
+            EXPECT_TRUE(std::equal(dy.begin(), dy.begin() + count, y.begin())) << uint128_isa_name(isa) << " " << count;
+            EXPECT_EQ(dx[count], 7U);
+            EXPECT_EQ(dy[count], 7U);
+        }
+    }
+}
+
+TEST(Morton, batch){
+    const uint64_t x[5] = {0, 1, 2, 0xffffffffffffffffULL, 12345};
+    const uint64_t y[5] = {0, 2, 1, 0x8000000000000000ULL, 67890};
+    uint128_t keys[5];
+    morton_encode_n(x, y, 5, keys);
+    uint64_t dx[5], dy[5];
+    morton_decode_n(keys, 5, dx, dy);
+    for(int i = 0; i < 5; i++){
+        EXPECT_EQ(keys[i], morton_reference(x[i], y[i]));
+        EXPECT_EQ(dx[i], x[i]);
+        EXPECT_EQ(dy[i], y[i]);
+    }
+}
+
+// BIGMIN and LITMAX against a scan of every key on a 16 x 16 grid
+TEST(Morton, bigmin_litmax){
+    const unsigned side = 16;
+    for(unsigned x0 = 0; x0 < side; x0 += 3){
+        for(unsigned y0 = 0; y0 < side; y0 += 2){
+            for(unsigned x1 = x0; x1 < side; x1 += 5){
+                for(unsigned y1 = y0; y1 < side; y1 += 4){
+                    const uint128_t min = morton_encode(x0, y0), max = morton_encode(x1, y1);
+                    for(uint128_t z = min; z <= max; z += 1){
+                        const bool inside = morton_in_box(z, min, max);
+                        uint64_t zx, zy;
+                        morton_decode(z, zx, zy);
+                        EXPECT_EQ(inside, (x0 <= zx) && (zx <= x1) && (y0 <= zy) && (zy <= y1));
+                        if (inside){
+                            continue;
+                        }
+
+                        uint128_t expected = z + 1, bigmin = 0;
+                        while ((expected <= max) && !morton_in_box(expected, min, max)){
+                            expected += 1;
+                        }
+                        ASSERT_TRUE(morton_bigmin(z, min, max, bigmin)) << z;
+                        EXPECT_EQ(bigmin, expected) << x0 << " " << y0 << " " << x1 << " " << y1 << " " << z;
+
+                        expected = z - 1;
+                        while ((expected >= min) && !morton_in_box(expected, min, max)){
+                            expected -= 1;
+                        }
+                        uint128_t litmax = 0;
+                        ASSERT_TRUE(morton_litmax(z, min, max, litmax)) << z;
+                        EXPECT_EQ(litmax, expected) << x0 << " " << y0 << " " << x1 << " " << y1 << " " << z;
+                    }
+                }
+            }
+        }
+    }
+
+    // high bits, far apart
+    const uint128_t min = morton_encode(0x8000000000000000ULL, 0), max = morton_encode(0x8000000000000001ULL, 0xffffffffffffffffULL);
+    uint128_t bigmin;
+    ASSERT_TRUE(morton_bigmin(morton_encode(0x8000000000000002ULL, 0), min, max, bigmin));
+    EXPECT_EQ(bigmin, morton_encode(0x8000000000000000ULL, 2));
+}
+
+TEST(Morton, query){
+    xoshiro256 gen(47);
+    std::vector <uint64_t> x(5000), y(5000);
+    for(std::size_t i = 0; i < x.size(); i++){
+        x[i] = 1000000 + gen().lower() % 4096;
+        y[i] = 2000000 + gen().lower() % 4096;
+    }
+    std::vector <uint128_t> keys(x.size());
+    morton_encode_n(x.data(), y.data(), x.size(), keys.data());
+    std::sort(keys.begin(), keys.end());
+
+    for(int q = 0; q < 50; q++){
+        const uint64_t x0 = 1000000 + gen().lower() % 4096, y0 = 2000000 + gen().lower() % 4096;
+        const uint64_t x1 = x0 + gen().lower() % 1000, y1 = y0 + gen().lower() % 1000;
+        std::vector <std::size_t> expected;
+        for(std::size_t i = 0; i < keys.size(); i++){
+            uint64_t kx, ky;
+            morton_decode(keys[i], kx, ky);
+            if ((x0 <= kx) && (kx <= x1) && (y0 <= ky) && (ky <= y1)){
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(morton_query(keys.data(), keys.size(), x0, y0, x1, y1), expected) << q;
+    }
+    EXPECT_TRUE(morton_query(keys.data(), keys.size(), 5, 5, 4, 5).empty());
+    EXPECT_TRUE(morton_query(keys.data(), 0, 0, 0, 10, 10).empty());
+}
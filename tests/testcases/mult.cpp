@@ -40,3 +40,24 @@ TEST(External, multiply){
     EXPECT_EQ(u32 *= val, (uint32_t)         0x5f5f5f60ULL);
     EXPECT_EQ(u64 *= val, (uint64_t) 0x5f5f5f5f5f5f5f60ULL);
 }
+
+TEST(Arithmetic, multiply_integral){
+    const uint128_t vals[] = {0, 1, uint128_t(0xfedbca9876543210ULL, 0x0123456789abcdefULL),
+                              uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)};
+    const int64_t rhs[] = {0, 1, 10, -1, -7, INT64_MIN, INT64_MAX};
+    for(const uint128_t & val : vals){
+        for(const int64_t r : rhs){
+            // same as going through the full 128 x 128 multiply
+            EXPECT_EQ(val * r, val * uint128_t(r));
+            EXPECT_EQ(r * val, uint128_t(r) * val);
+            EXPECT_EQ(val * (uint64_t) r, val * uint128_t((uint64_t) r));
+            EXPECT_EQ(val * (int32_t) r, val * uint128_t((int32_t) r));
+        }
+    }
+
+    EXPECT_EQ(uint128_t(3) * -1, -uint128_t(3));
+
+    uint128_t acc(0x8000000000000000ULL);
+    acc *= 4;
+    EXPECT_EQ(acc, uint128_t(2, 0));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+#include "uint128_t_expr.h"
+#include "uint128_t_random.h"
+
+// Mixed uint128_t and unsigned __int128 / __int128 operands, against the
+// same expressions on the built-ins. tests/Makefile builds this with
+// -std=c++14 and CMake with gnu++14, where the 128 bit built-ins are integral.
+#if defined(UINT128_T_NATIVE_LAYOUT)
+
+typedef uint128_detail::native_u128 u128;
+typedef uint128_detail::native_s128 s128;
+
+static u128 native(const uint128_t & v){
+    return ((u128) v.upper() << 64) | v.lower();
+}
+
+TEST(Native, operators){
+    xoshiro256 gen(52);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t a = gen() >> ((unsigned) gen() % 128);
+        const uint128_t b = (gen() >> ((unsigned) gen() % 128)) | 1;
+        const u128 x = native(b);
+        const u128 na = native(a);
+        const unsigned s = (unsigned) gen() % 128;
+
+        EXPECT_TRUE(a == na);
+        EXPECT_TRUE(na == a);
+        EXPECT_EQ(a != x, na != x);
+        EXPECT_EQ(a <  x, na <  x);
+        EXPECT_EQ(a <= x, na <= x);
+        EXPECT_EQ(a >  x, na >  x);
+        EXPECT_EQ(a >= x, na >= x);
+        EXPECT_EQ(x <  a, x <  na);
+        EXPECT_EQ(x >= a, x >= na);
+        EXPECT_EQ(a && x, na && x);
+        EXPECT_EQ(a || x, na || x);
+
+        EXPECT_EQ(native(a + x), na + x);
+        EXPECT_EQ(native(a - x), na - x);
+        EXPECT_EQ(native(a * x), na * x);
+        EXPECT_EQ(native(a / x), na / x);
+        EXPECT_EQ(native(a % x), na % x);
+        EXPECT_EQ(native(a & x), na & x);
+        EXPECT_EQ(native(a | x), na | x);
+        EXPECT_EQ(native(a ^ x), na ^ x);
+        EXPECT_EQ(native(a << (u128) s), na << s);
+        EXPECT_EQ(native(a >> (u128) s), na >> s);
+
+        EXPECT_EQ(native(x + a), x + na);
+        EXPECT_EQ(native(x - a), x - na);
+        EXPECT_EQ(native(x * a), x * na);
+        EXPECT_EQ(native(na / b), na / x);
+        EXPECT_EQ(native(x % b), x % x);
+        EXPECT_EQ(native(x ^ a), x ^ na);
+        EXPECT_EQ(native(x << uint128_t(s)), x << s);
+
+        uint128_t c = a;
+        c += x;
+        EXPECT_EQ(native(c), na + x);
+        c -= x;
+        EXPECT_EQ(native(c), na);
+        c *= x;
+        EXPECT_EQ(native(c), na * x);
+        c = a;
+        c /= x;
+        EXPECT_EQ(native(c), na / x);
+        c = x;
+        EXPECT_EQ(native(c), x);
+
+        u128 y = x;
+        y += a;
+        EXPECT_EQ(y, x + na);
+        y -= a;
+        EXPECT_EQ(y, x);
+        y *= a;
+        EXPECT_EQ(y, x * na);
+        y = na;
+        y /= b;
+        EXPECT_EQ(y, na / x);
+        y <<= uint128_t(s);
+        EXPECT_EQ(y, (na / x) << s);
+    }
+
+    EXPECT_TRUE(uint128_t(3, 5) == (((u128) 3 << 64) + 5));
+    EXPECT_EQ(native(uint128_t(1) << 100) + 1, native(uint128_t(1) << 100) + (u128) 1);
+}
+
+TEST(Native, signed_operands){
+    const uint128_t max(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    const s128 minus_one = -1;
+    const s128 big = (s128) 1 << 100;
+    EXPECT_TRUE(max == minus_one);
+    EXPECT_EQ(uint128_t(5) + minus_one, 4);
+    EXPECT_EQ(uint128_t(5) - big, uint128_t(5) - (uint128_t(1) << 100));
+    EXPECT_EQ(big * uint128_t(3), uint128_t(3) << 100);
+    EXPECT_EQ((uint128_t(7) << 110) / big, uint128_t(7) << 10);
+    EXPECT_EQ(uint128_t(7, 9) % big, uint128_t(7, 9));
+    EXPECT_TRUE(uint128_t(1) < big);
+
+    s128 z = big;
+    z -= uint128_t(1);
+    EXPECT_EQ(z, big - 1);
+}
+
+TEST(Native, expressions){
+    const uint128_t a(1, 2);
+    const u128 x = ((u128) 5 << 64) | 7;
+    const uint128_t e = (lazy(a) + x) * 3;
+    EXPECT_EQ(native(e), (native(a) + x) * 3);
+}
+
+#endif
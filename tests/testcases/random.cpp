@@ -0,0 +1,105 @@
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_random.h"
+
+TEST(Random, pcg64){
+    // reference output of pcg64(42, 54)
+    pcg64 gen(42, 54);
+    EXPECT_EQ(gen(), uint128_t(0x86b1da1d72062b68ULL, 0x1304aa46c9853d39ULL));
+    EXPECT_EQ(gen(), uint128_t(0xa3670e9e0dd50358ULL, 0xf9090e529a7dae00ULL));
+
+    // discard is the same as stepping
+    pcg64 a(7, 3), b(7, 3);
+    for(int i = 0; i < 1000; i++){
+        a();
+    }
+    b.discard(1000);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a(), b());
+}
+
+TEST(Random, xoshiro256){
+    // first two xoshiro256++ outputs from the state {1, 2, 3, 4}
+    xoshiro256 gen(1, 2, 3, 4);
+    EXPECT_EQ(gen(), uint128_t(0x0000000002800001ULL, 0x0000000003800067ULL));
+
+    // jumped streams do not overlap with the original
+    xoshiro256 a(1234), b(1234);
+    b.jump();
+    EXPECT_NE(a, b);
+    EXPECT_NE(a(), b());
+}
+
+TEST(Random, philox2x64){
+    // known answer tests from Random123
+    EXPECT_EQ(philox2x64::block(0, 0), uint128_t(0x66c24222c9a845b5ULL, 0xca00a0459843d731ULL));
+    EXPECT_EQ(philox2x64::block(0xffffffffffffffffULL, uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)),
+              uint128_t(0x4d02f3222f86df20ULL, 0x65b021d60cd8310fULL));
+    EXPECT_EQ(philox2x64::block(0xa4093822299f31d0ULL, uint128_t(0x13198a2e03707344ULL, 0x243f6a8885a308d3ULL)),
+              uint128_t(0xb0f883d38000de5dULL, 0x0a5e742c2997341cULL));
+
+    // counter carries into the upper half
+    philox2x64 gen(5, uint128_t(0, 0xffffffffffffffffULL));
+    gen();
+    EXPECT_EQ(gen.counter(), uint128_t(1, 0));
+
+    gen.discard(10);
+    EXPECT_EQ(gen.counter(), uint128_t(1, 10));
+}
+
+TEST(Random, fill){
+    const std::size_t count = 37;
+    uint128_t bulk[count];
+
+    pcg64 p1(1), p2(1);
+    p1.fill(bulk, count);
+    for(std::size_t i = 0; i < count; i++){
+        EXPECT_EQ(bulk[i], p2());
+    }
+    EXPECT_EQ(p1, p2);
+
+    xoshiro256 x1(1), x2(1);
+    x1.fill(bulk, count);
+    for(std::size_t i = 0; i < count; i++){
+        EXPECT_EQ(bulk[i], x2());
+    }
+    EXPECT_EQ(x1, x2);
+
+    philox2x64 f1(1), f2(1);
+    f1.fill(bulk, count);
+    for(std::size_t i = 0; i < count; i++){
+        EXPECT_EQ(bulk[i], f2());
+    }
+    EXPECT_EQ(f1, f2);
+}
+
+TEST(Random, uniform){
+    philox2x64 gen(99);
+
+    // small range hits every value
+    std::set <uint64_t> seen;
+    for(int i = 0; i < 1000; i++){
+        const uint128_t v = gen.uniform(7);
+        EXPECT_LT(v, 7);
+        seen.insert((uint64_t) v);
+    }
+    EXPECT_EQ(seen.size(), 7U);
+
+    // wide ranges stay in bounds
+    const uint128_t n(0x8000000000000000ULL, 1);
+    for(int i = 0; i < 1000; i++){
+        EXPECT_LT(uniform(gen, n), n);
+    }
+
+    EXPECT_EQ(gen.uniform(1), 0);
+    EXPECT_THROW(gen.uniform(0), std::domain_error);
+}
+
+TEST(Random, traits){
+    EXPECT_EQ(pcg64::min(), 0);
+    EXPECT_EQ(pcg64::max(), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(xoshiro256::max(), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+    EXPECT_EQ(philox2x64::max(), uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL));
+}
@@ -74,3 +74,14 @@ TEST(External, shift_right){
     EXPECT_EQ(u32 >>= uint128_t(31), (uint32_t) 0);
     EXPECT_EQ(u64 >>= uint128_t(63), (uint64_t) 0);
 }
+
+TEST(BitShift, right_integral){
+    const uint128_t val(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    for(int i = 0; i < 130; i++){
+        EXPECT_EQ(val >> i,              val >> uint128_t(i));
+        EXPECT_EQ(val >> (uint64_t) i,   val >> uint128_t(i));
+    }
+
+    EXPECT_EQ(val >> -1, 0);
+    EXPECT_EQ(-1 >> uint128_t(64), uint128_t(0, 0xffffffffffffffffULL));
+}
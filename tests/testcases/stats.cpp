@@ -0,0 +1,124 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_stats.h"
+
+// Everything here runs in every build; the counts are only checked in
+// UINT128_T_STATS builds. The operations under test are kept apart from
+// EXPECT_EQ on uint128_t values, which counts comparisons of its own.
+
+TEST(Stats, disabled){
+    if (uint128_stats::enabled()){
+        return;
+    }
+    const uint128_t a(1, 2);
+    EXPECT_EQ(a * a, uint128_t(4, 4));
+    const uint128_stats stats = uint128_stats::snapshot();
+    EXPECT_EQ(stats.ops[uint128_stats::mul], 0U);
+    EXPECT_EQ(stats.str_allocations, 0U);
+}
+
+TEST(Stats, operators){
+    if (!uint128_stats::enabled()){
+        return;
+    }
+    const uint128_t big(1, 0), small(3);
+    uint128_stats::reset();
+    volatile bool sink;
+    uint128_t x = big * small;          // mul, operands of 65 and 2 bits
+    x = x + big;
+    x += 5;
+    x = x << 3;
+    x = x >> 1;
+    sink = (x >= big);
+    sink = (x != 7);
+    x = -x;
+    (void) sink;
+    const uint128_stats stats = uint128_stats::snapshot();
+
+    EXPECT_EQ(stats.ops[uint128_stats::mul], 1U);
+    EXPECT_EQ(stats.ops[uint128_stats::add], 2U);
+    EXPECT_EQ(stats.ops[uint128_stats::shl], 1U);
+    EXPECT_EQ(stats.ops[uint128_stats::shr], 1U);
+    EXPECT_EQ(stats.ops[uint128_stats::compare], 2U);
+    EXPECT_EQ(stats.ops[uint128_stats::negate], 1U);
+    EXPECT_EQ(stats.ops[uint128_stats::sub], 0U);
+    EXPECT_EQ(stats.operand_bits[65], 1U);
+    EXPECT_EQ(stats.operand_bits[2], 1U);
+}
+
+TEST(Stats, divmod){
+    if (!uint128_stats::enabled()){
+        return;
+    }
+    const uint128_t a(5, 7), b(1, 1), c(0, 3), one(1);
+    uint128_stats::reset();
+    uint128_t q = a / one;              // by_one
+    q = a / a;                          // equal
+    q = c / a;                          // smaller
+    q = a % b;                          // wide
+    q = c / c + a / c;                  // equal, narrow_two
+    q = uint128_t(2, 0) / 7;            // narrow_one through the integral path
+    q = a % 3;                          // narrow_two
+    try{
+        q = a / uint128_t(0);
+    }
+    catch (const std::domain_error &){}
+    (void) q;
+    const uint128_stats stats = uint128_stats::snapshot();
+
+    EXPECT_EQ(stats.divmod[uint128_stats::by_zero], 1U);
+    EXPECT_EQ(stats.divmod[uint128_stats::by_one], 1U);
+    EXPECT_EQ(stats.divmod[uint128_stats::equal], 2U);
+    EXPECT_EQ(stats.divmod[uint128_stats::smaller], 1U);
+    EXPECT_EQ(stats.divmod[uint128_stats::narrow_one], 1U);
+    EXPECT_EQ(stats.divmod[uint128_stats::narrow_two], 2U);
+    EXPECT_EQ(stats.divmod[uint128_stats::wide], 1U);
+    EXPECT_EQ(stats.ops[uint128_stats::div], 7U);
+    EXPECT_EQ(stats.ops[uint128_stats::mod], 2U);
+    EXPECT_EQ(stats.operand_bits[67], 8U);    // a, on the left or the right
+}
+
+TEST(Stats, strings){
+    if (!uint128_stats::enabled()){
+        return;
+    }
+    const uint128_t small(42), big(~0ULL, ~0ULL);
+    uint128_stats::reset();
+    const std::string s = small.str();
+    const std::string t = big.str(2);
+    const std::string u = small.str(10, 200);
+    const unsigned b = big.bits() + small.bits();
+    const uint128_stats stats = uint128_stats::snapshot();
+
+    EXPECT_EQ(s.size() + t.size() + u.size() + b, 2U + 128 + 200 + 128 + 6);
+    EXPECT_EQ(stats.str_lengths[2], 1U);
+    EXPECT_EQ(stats.str_lengths[128], 1U);
+    EXPECT_EQ(stats.str_lengths[uint128_stats::LENGTHS - 1], 1U);
+    EXPECT_EQ(stats.str_allocations, 2U);
+    EXPECT_EQ(stats.bits[128], 1U);
+    EXPECT_EQ(stats.bits[6], 1U);
+
+    std::ostringstream dump;
+    dump << stats;
+    EXPECT_NE(dump.str().find("str(): 3 calls, 2 allocated"), std::string::npos);
+}
+
+TEST(Stats, threads){
+    if (!uint128_stats::enabled()){
+        return;
+    }
+    uint128_stats::reset();
+    std::thread worker([]{
+        uint128_t x(1);
+        for(int i = 0; i < 1000; i++){
+            x = x * x;
+        }
+    });
+    worker.join();
+    // the worker has exited, its counts are kept
+    EXPECT_EQ(uint128_stats::snapshot().ops[uint128_stats::mul], 1000U);
+}
@@ -35,4 +35,15 @@ TEST(External, subtract){
     EXPECT_EQ(u16 -= val, (uint16_t) 0xb9baULL);
     EXPECT_EQ(u32 -= val, (uint32_t) 0xb9b9b9baULL);
     EXPECT_EQ(u64 -= val, (uint64_t) 0xb9b9b9b9b9b9b9baULL);
-}
\ No newline at end of file
+}
+TEST(External, subtract_signed){
+    const uint128_t val(0, 0xffffffffffffffffULL);
+
+    EXPECT_EQ(val - -1, uint128_t(1, 0));
+    EXPECT_EQ(5 - uint128_t(7), uint128_t(0xffffffffffffffffULL, 0xfffffffffffffffeULL));
+    EXPECT_EQ(-1 - val, uint128_t(0xffffffffffffffffULL, 0));
+
+    uint128_t acc = 0;
+    acc -= (int64_t) -10;
+    EXPECT_EQ(acc, 10);
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+#include "uint128_t_text.h"
+
+static const char * PATH = "uint128_t_text_test.txt";
+
+static bool parse(const std::string & str, const uint8_t base, uint128_t & value){
+    return uint128_parse(str.data(), str.size(), base, value);
+}
+
+// full width and short values, 0 and the maximum
+static std::vector <uint128_t> mixed(const std::size_t n){
+    xoshiro256 gen(48);
+    std::vector <uint128_t> values(n);
+    for(std::size_t i = 0; i < n; i++){
+        values[i] = gen() >> (gen().lower() % 128);
+    }
+    values[0] = 0;
+    values[n / 2] = uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    return values;
+}
+
+TEST(Text, parse){
+    const uint128_t max(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+    uint128_t v;
+    EXPECT_TRUE(parse("0", 10, v));
+    EXPECT_EQ(v, 0);
+    EXPECT_TRUE(parse("12345678901234567890", 10, v));
+    EXPECT_EQ(v, uint128_t(0, 12345678901234567890ULL));
+    EXPECT_TRUE(parse("340282366920938463463374607431768211455", 10, v));
+    EXPECT_EQ(v, max);
+    EXPECT_TRUE(parse("0000000000000000000000000000000000000000000000000000000000000000000000000042", 10, v));
+    EXPECT_EQ(v, 42);
+    EXPECT_TRUE(parse("ffffffffffffffffFFFFFFFFFFFFFFFF", 16, v));
+    EXPECT_EQ(v, max);
+    EXPECT_TRUE(parse("0x123456789abcdef0", 16, v));
+    EXPECT_EQ(v, 0x123456789abcdef0ULL);
+    EXPECT_TRUE(parse("0X0", 16, v));
+    EXPECT_EQ(v, 0);
+
+    // every length, so each split into a short first group and groups of 8 is used
+    const std::string digits = "123456789012345678901234567890123456789";
+    uint128_t expected = 0;
+    for(std::size_t n = 1; n <= digits.size(); n++){
+        expected = expected * 10 + (digits[n - 1] - '0');
+        EXPECT_TRUE(parse(digits.substr(0, n), 10, v)) << n;
+        EXPECT_EQ(v, expected) << n;
+    }
+
+    for(const char * bad : {"", "-1", "+1", " 1", "1 ", "12a", "1\n", "1\r", "1\n2",
+                            "340282366920938463463374607431768211456", "9999999999999999999999999999999999999999"}){
+        EXPECT_FALSE(parse(bad, 10, v)) << bad;
+    }
+    for(const char * bad : {"", "0x", "x1", "g", "1fffffffffffffffffffffffffffffffff", "0x-1"}){
+        EXPECT_FALSE(parse(bad, 16, v)) << bad;
+    }
+    EXPECT_THROW(parse("1", 8, v), std::invalid_argument);
+}
+
+// every compiled kernel level, on lines near the end of the buffer (where the
+// avx2 and avx512 kernels stop using 64 byte loads) and on bad lines
+TEST(Text, kernels_agree){
+    const std::vector <uint128_t> values = mixed(200);
+    for(const uint8_t base : {10, 16}){
+        std::string text = uint128_format_text(values.data(), values.size(), base);
+        text.insert(text.find('\n', 100) + 1, "0000000000000000000000000000000000000000000000000000000000000000000000000007\r\n");
+        for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+            const uint128_kernels * k = uint128_kernels_for(isa);
+            if (!k){
+                continue;
+            }
+
+            std::string formatted(40 * values.size(), '\0');
+            formatted.resize(k -> format_lines(values.data(), values.size(), base, &formatted[0]));
+            EXPECT_EQ(formatted, uint128_format_text(values.data(), values.size(), base)) << uint128_isa_name(isa);
+
+            // the whole text and every suffix of its last 100 characters, without the final newline
+            std::vector <uint128_t> out(values.size() + 2);
+            EXPECT_EQ(k -> parse_lines(text.data(), text.size() - 1, base, out.data()), values.size() + 1) << uint128_isa_name(isa);
+            EXPECT_EQ(out[values.size()], values.back());
+            for(std::size_t from = text.size() - 100; from < text.size() - 1; from++){
+                const std::size_t lines = k -> parse_lines(text.data() + from, text.size() - 1 - from, base, out.data());
+                std::size_t expected = 0;
+                std::string reference;
+                for(std::size_t i = from; i < text.size(); i++){
+                    if (text[i] == '\n'){
+                        uint128_t v;
+                        if (!uint128_parse(reference.data(), reference.size(), base, v)){
+                            break;
+                        }
+                        EXPECT_EQ(out[expected], v);
+                        expected++;
+                        reference.clear();
+                    }
+                    else{
+                        reference += text[i];
+                    }
+                }
+                EXPECT_EQ(lines, expected) << uint128_isa_name(isa) << " " << from;
+            }
+
+            // stops at a bad line
+            std::string bad = text;
+            bad[bad.find('\n', 2000) + 1] = 'z';
+            const std::size_t line = std::count(bad.begin(), bad.begin() + bad.find('z'), '\n');
+            EXPECT_EQ(k -> parse_lines(bad.data(), bad.size(), base, out.data()), line) << uint128_isa_name(isa);
+        }
+    }
+}
+
+TEST(Text, round_trip){
+    // about 4 MB of decimal text, so 4 threads get a piece each
+    const std::vector <uint128_t> values = mixed(100000);
+    for(const uint8_t base : {10, 16}){
+        for(const unsigned threads : {1, 4}){
+            const std::string text = uint128_format_text(values.data(), values.size(), base, threads);
+            EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), (long) values.size());
+            EXPECT_EQ(text.substr(0, 2), "0\n");
+            EXPECT_EQ(uint128_parse_text(text.data(), text.size(), base, threads), values) << threads;
+        }
+    }
+
+    EXPECT_TRUE(uint128_parse_text("", 0).empty());
+    const std::string crlf = "1\r\n22\r\n333";
+    EXPECT_EQ(uint128_parse_text(crlf.data(), crlf.size()), std::vector <uint128_t> ({1, 22, 333}));
+}
+
+TEST(Text, errors){
+    const std::vector <uint128_t> values = mixed(100000);
+    std::string text = uint128_format_text(values.data(), values.size());
+    const std::size_t at = text.find('\n', text.size() / 3 * 2) + 1;
+    text[at] = '-';
+    const std::string line = "line " + std::to_string(std::count(text.begin(), text.begin() + at, '\n') + 1) + " ";
+    for(const unsigned threads : {1, 4}){
+        try{
+            uint128_parse_text(text.data(), text.size(), 10, threads);
+            ADD_FAILURE() << "no exception";
+        }
+        catch (const std::runtime_error & e){
+            EXPECT_NE(std::string(e.what()).find(line), std::string::npos) << e.what();
+        }
+    }
+
+    const std::string empty_line = "1\n\n2\n";
+    EXPECT_THROW(uint128_parse_text(empty_line.data(), empty_line.size()), std::runtime_error);
+    EXPECT_THROW(uint128_parse_text("1", 1, 2), std::invalid_argument);
+    EXPECT_THROW(uint128_format_text(values.data(), 1, 8), std::invalid_argument);
+}
+
+TEST(Text, files){
+    const std::vector <uint128_t> values = mixed(100000);
+    for(const uint8_t base : {10, 16}){
+        uint128_write_text(PATH, values.data(), values.size(), base, 3);
+        EXPECT_EQ(uint128_read_text(PATH, base, 3), values);
+    }
+
+    uint128_write_text(PATH, values.data(), 0);
+    EXPECT_TRUE(uint128_read_text(PATH).empty());
+    std::remove(PATH);
+
+    EXPECT_THROW(uint128_read_text("does/not/exist.txt"), std::runtime_error);
+}
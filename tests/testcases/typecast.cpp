@@ -1,6 +1,12 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 
 #include "uint128_t.h"
+#include "uint128_t_random.h"
 
 TEST(Typecast, all){
     const uint128_t val(0xaaaaaaaaaaaaaaaaULL, 0xaaaaaaaaaaaaaaaaULL);
@@ -11,4 +17,116 @@ TEST(Typecast, all){
     EXPECT_EQ(static_cast <uint16_t> (val),           (uint16_t) 0xaaaaULL);
     EXPECT_EQ(static_cast <uint32_t> (val),           (uint32_t) 0xaaaaaaaaULL);
     EXPECT_EQ(static_cast <uint64_t> (val),           (uint64_t) 0xaaaaaaaaaaaaaaaaULL);
-}
\ No newline at end of file
+}
+TEST(Typecast, floating){
+    const uint128_t max(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+    EXPECT_EQ(static_cast <double> (uint128_t(0)), 0.0);
+    EXPECT_EQ(static_cast <double> (uint128_t(1, 0)), 18446744073709551616.0);
+    EXPECT_EQ(static_cast <double> (max), 340282366920938463463374607431768211456.0);
+    EXPECT_EQ(static_cast <float> (uint128_t(0xffffff0000000000ULL, 0)), std::ldexp(16777215.0f, 104));
+
+    // halfway between two doubles: ties to even, and anything past the tie rounds up
+    EXPECT_EQ(static_cast <double> (uint128_t(1, 0x800)), 18446744073709551616.0);
+    EXPECT_EQ(static_cast <double> (uint128_t(1, 0x801)), 18446744073709555712.0);
+    EXPECT_EQ(static_cast <double> (uint128_t(1, 0x1800)), 18446744073709559808.0);
+    EXPECT_EQ(static_cast <double> (uint128_t(0x0010000000000001ULL, 0x8000000000000000ULL)),
+              static_cast <double> (uint128_t(0x0010000000000002ULL, 0)));
+    EXPECT_EQ(static_cast <double> (uint128_t(0x0010000000000001ULL, 0x8000000000000001ULL)),
+              static_cast <double> (uint128_t(0x0010000000000002ULL, 0)));
+
+    // upper() * 2^64 + lower() rounds lower() down to 2^63, then the sum ties to even, one ulp low
+    const uint128_t twice(0x0010000000000000ULL, 0x8000000000000001ULL);
+    EXPECT_EQ(static_cast <double> (twice), static_cast <double> (uint128_t(0x0010000000000001ULL, 0)));
+    EXPECT_NE(static_cast <double> (twice), std::ldexp(static_cast <double> (twice.upper()), 64) + static_cast <double> (twice.lower()));
+
+    // past FLT_MAX
+    EXPECT_EQ(static_cast <float> (max), std::numeric_limits <float>::infinity());
+
+    const long double ld = static_cast <long double> (uint128_t(1, 1));
+    EXPECT_EQ(ld, std::ldexp(1.0L, 64) + 1.0L);
+}
+
+TEST(Typecast, from_floating){
+    EXPECT_EQ(uint128_t(0.0), 0);
+    EXPECT_EQ(uint128_t(-0.0), 0);
+    EXPECT_EQ(uint128_t(0.99), 0);
+    EXPECT_EQ(uint128_t(-0.99), 0);
+    EXPECT_EQ(uint128_t(1.5), 1);
+    EXPECT_EQ(uint128_t(12345.75f), 12345);
+    EXPECT_EQ(uint128_t(18446744073709551616.0), uint128_t(1, 0));
+    EXPECT_EQ(uint128_t(std::ldexp(1.0, 127)), uint128_t(0x8000000000000000ULL, 0));
+    EXPECT_EQ(uint128_t(std::ldexp(1.0f, 100)), uint128_t(1) << 100);
+    EXPECT_EQ(uint128_t(std::ldexp(3.0L, 70) + std::ldexp(1.0L, 20)), (uint128_t(3) << 70) + (1 << 20));
+    EXPECT_EQ(uint128_t(12345.75L), 12345);
+
+    EXPECT_THROW(uint128_t(-1.0), std::domain_error);
+    EXPECT_THROW(uint128_t(-1.0L), std::domain_error);
+    EXPECT_THROW(uint128_t(std::numeric_limits <double>::quiet_NaN()), std::domain_error);
+    EXPECT_THROW(uint128_t(std::numeric_limits <float>::quiet_NaN()), std::domain_error);
+    EXPECT_THROW(uint128_t(std::numeric_limits <long double>::quiet_NaN()), std::domain_error);
+    EXPECT_THROW(uint128_t(-std::numeric_limits <double>::infinity()), std::domain_error);
+    EXPECT_THROW(uint128_t(std::numeric_limits <double>::infinity()), std::overflow_error);
+    EXPECT_THROW(uint128_t(std::numeric_limits <float>::infinity()), std::overflow_error);
+    EXPECT_THROW(uint128_t(std::ldexp(1.0, 128)), std::overflow_error);
+    EXPECT_THROW(uint128_t(std::ldexp(1.0L, 128)), std::overflow_error);
+
+    // every double below 2^128 with a whole value comes back unchanged
+    xoshiro256 gen(46);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t v = gen() >> (gen().lower() % 128);
+        const double d = static_cast <double> (v);
+        if (d < std::ldexp(1.0, 128)){
+            EXPECT_EQ(static_cast <double> (uint128_t(d)), d) << v;
+        }
+        const long double l = static_cast <long double> (v);
+        if (l < std::ldexp(1.0L, 128)){
+            EXPECT_EQ(static_cast <long double> (uint128_t(l)), l) << v;
+        }
+    }
+}
+
+TEST(Typecast, batch){
+    const uint128_t in[4] = {0, 7, uint128_t(1, 0x801), uint128_t(0x8000000000000001ULL, 0)};
+    double d[4];
+    to_double(in, 4, d);
+    for(int i = 0; i < 4; i++){
+        EXPECT_EQ(d[i], static_cast <double> (in[i]));
+    }
+
+    uint128_t back[4];
+    from_double(d, 4, back);
+    for(int i = 0; i < 4; i++){
+        EXPECT_EQ(back[i], uint128_t(d[i]));
+    }
+
+    const double bad[2] = {1.0, -2.0};
+    EXPECT_THROW(from_double(bad, 2, back), std::domain_error);
+}
+
+#if defined(UINT128_T_NATIVE_LAYOUT)
+TEST(Typecast, native){
+    __extension__ typedef unsigned __int128 u128;
+    __extension__ typedef __int128 s128;
+
+    const uint128_t val(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    const u128 n = val;
+    EXPECT_EQ((uint64_t) (n >> 64), 0x0123456789abcdefULL);
+    EXPECT_EQ((uint64_t) n, 0xfedcba9876543210ULL);
+
+    const uint128_t back = n * 3;
+    EXPECT_EQ(back, val * 3);
+    const s128 negative = -5;
+    EXPECT_EQ(uint128_t(negative), uint128_t(0) - 5);
+
+    // the same bytes either way, so arrays can be passed through
+    uint128_t values[3] = {val, uint128_t(1, 0), 7};
+    const u128 * as_native = reinterpret_cast <const u128 *> (values);
+    EXPECT_EQ(as_native[0], n);
+    EXPECT_EQ(as_native[1], (u128) 1 << 64);
+    EXPECT_EQ(as_native[2], (u128) 7);
+    unsigned char bytes[sizeof(u128)];
+    std::memcpy(bytes, &values[0], sizeof(bytes));
+    EXPECT_EQ(std::memcmp(bytes, &n, sizeof(bytes)), 0);
+}
+#endif
@@ -0,0 +1,151 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t_dispatch.h"
+#include "uint128_t_random.h"
+#include "uint128_t_uuid.h"
+
+static bool uuid_valid(const std::string & str){
+    uint128_t value;
+    return uuid_parse(str.data(), str.size(), value);
+}
+
+static bool ulid_valid(const std::string & str){
+    uint128_t value;
+    return ulid_parse(str.data(), str.size(), value);
+}
+
+TEST(UUID, format){
+    EXPECT_EQ(uuid_str(uint128_t(0x0011223344556677ULL, 0x8899aabbccddeeffULL)), "00112233-4455-6677-8899-aabbccddeeff");
+    EXPECT_EQ(uuid_str(uint128_t(0)), "00000000-0000-0000-0000-000000000000");
+    EXPECT_EQ(uuid_str(uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)), "ffffffff-ffff-ffff-ffff-ffffffffffff");
+
+    // the hex form of the same number, hyphens aside
+    const uint128_t value(0x6ba7b8109dad11d1ULL, 0x80b400c04fd430c8ULL);
+    std::string plain = uuid_str(value);
+    plain.erase(23, 1);
+    plain.erase(18, 1);
+    plain.erase(13, 1);
+    plain.erase(8, 1);
+    EXPECT_EQ(plain, value.str(16, 32));
+    EXPECT_EQ(uuid_version(value), 1U);
+}
+
+TEST(UUID, parse){
+    EXPECT_EQ(uuid_parse(std::string("6ba7b810-9dad-11d1-80b4-00c04fd430c8")), uint128_t(0x6ba7b8109dad11d1ULL, 0x80b400c04fd430c8ULL));
+    EXPECT_EQ(uuid_parse(std::string("6BA7B810-9DAD-11D1-80B4-00C04FD430C8")), uint128_t(0x6ba7b8109dad11d1ULL, 0x80b400c04fd430c8ULL));
+
+    const std::string good = "6ba7b810-9dad-11d1-80b4-00c04fd430c8";
+    EXPECT_TRUE(uuid_valid(good));
+    EXPECT_FALSE(uuid_valid(good.substr(1)));
+    EXPECT_FALSE(uuid_valid(good + "0"));
+    EXPECT_FALSE(uuid_valid("6ba7b8109dad11d180b400c04fd430c8"));
+    EXPECT_FALSE(uuid_valid("{6ba7b810-9dad-11d1-80b4-00c04fd430c}"));
+    for(const std::size_t dash : {8, 13, 18, 23}){
+        std::string s = good;
+        s[dash] = '0';
+        EXPECT_FALSE(uuid_valid(s)) << s;
+    }
+    // every position, with characters just outside the digit ranges
+    for(std::size_t i = 0; i < good.size(); i++){
+        if (good[i] == '-'){
+            continue;
+        }
+        for(const char c : {'/', ':', '@', 'G', '`', 'g', '\0', '\x80', '\xb0', '-'}){
+            std::string s = good;
+            s[i] = c;
+            EXPECT_FALSE(uuid_valid(s)) << i << " " << (int) c;
+        }
+    }
+    EXPECT_THROW(uuid_parse(std::string("not a uuid")), std::invalid_argument);
+}
+
+// every compiled kernel level against the generic one
+TEST(UUID, kernels_agree){
+    const uint128_kernels * reference = uint128_kernels_for(uint128_isa::generic);
+    ASSERT_NE(reference, nullptr);
+
+    const std::size_t count = 1000, stride = 40;
+    std::vector <uint128_t> values(count), parsed(count);
+    xoshiro256 gen(36);
+    for(std::size_t i = 0; i < count; i++){
+        values[i] = gen();
+    }
+    std::vector <char> expected(count * stride, '\n');
+    reference -> uuid_format_n(values.data(), count, expected.data(), stride);
+
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        const uint128_kernels * k = uint128_kernels_for(isa);
+        if (!k){
+            continue;
+        }
+        std::vector <char> text(count * stride, '\n');
+        k -> uuid_format_n(values.data(), count, text.data(), stride);
+        EXPECT_EQ(text, expected) << uint128_isa_name(isa);
+
+        EXPECT_EQ(k -> uuid_parse_n(text.data(), stride, count, parsed.data()), count);
+        EXPECT_EQ(parsed, values) << uint128_isa_name(isa);
+
+        text[500 * stride + 35] = 'x';
+        EXPECT_EQ(k -> uuid_parse_n(text.data(), stride, count, parsed.data()), 500U);
+    }
+}
+
+TEST(UUID, batch){
+    const uint128_t values[3] = {uint128_t(1), uint128_t(2, 3), uint128_t(0xffffffffffffffffULL, 0)};
+    char text[3 * uuid_length];
+    uuid_format_n(values, 3, text);
+    EXPECT_EQ(std::string(text + uuid_length, uuid_length), uuid_str(values[1]));
+
+    uint128_t back[3];
+    EXPECT_EQ(uuid_parse_n(text, 3, back), 3U);
+    EXPECT_EQ(back[2], values[2]);
+}
+
+TEST(ULID, format){
+    EXPECT_EQ(ulid_str(uint128_t(0)), "00000000000000000000000000");
+    EXPECT_EQ(ulid_str(uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)), "7ZZZZZZZZZZZZZZZZZZZZZZZZZ");
+    EXPECT_EQ(ulid_str(uint128_t(31)), "0000000000000000000000000Z");
+    EXPECT_EQ(ulid_str(uint128_t(32)), "00000000000000000000000010");
+
+    // the timestamp is the top 48 bits: 1469918176385 is 01ARYZ6S41 in the ULID spec
+    const uint128_t value = ulid_parse(std::string("01ARYZ6S41TSV4RRFFQ69G5FAV"));
+    EXPECT_EQ(ulid_time(value), 1469918176385ULL);
+    EXPECT_EQ(ulid_str(value), "01ARYZ6S41TSV4RRFFQ69G5FAV");
+
+    // the same number cut into 5 bit digits
+    static const char CROCKFORD[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    std::string digits;
+    for(int i = 25; i >= 0; i--){
+        digits += CROCKFORD[(unsigned) ((value >> (5 * i)) & 31)];
+    }
+    EXPECT_EQ(digits, "01ARYZ6S41TSV4RRFFQ69G5FAV");
+}
+
+TEST(ULID, parse){
+    EXPECT_EQ(ulid_parse(std::string("01aryz6s41tsv4rrffq69g5fav")), ulid_parse(std::string("01ARYZ6S41TSV4RRFFQ69G5FAV")));
+    EXPECT_EQ(ulid_parse(std::string("0000000000000000000000000I")), uint128_t(1));
+    EXPECT_EQ(ulid_parse(std::string("0000000000000000000000000l")), uint128_t(1));
+    EXPECT_EQ(ulid_parse(std::string("O000000000000000000000000o")), uint128_t(0));
+
+    EXPECT_TRUE(ulid_valid("7ZZZZZZZZZZZZZZZZZZZZZZZZZ"));
+    EXPECT_FALSE(ulid_valid("80000000000000000000000000"));     // above 2^128 - 1
+    EXPECT_FALSE(ulid_valid("0000000000000000000000000U"));
+    EXPECT_FALSE(ulid_valid("0000000000000000000000000-"));
+    EXPECT_FALSE(ulid_valid("000000000000000000000000000"));
+    EXPECT_FALSE(ulid_valid("0000000000000000000000000"));
+    EXPECT_THROW(ulid_parse(std::string("")), std::invalid_argument);
+
+    xoshiro256 gen(26);
+    std::vector <uint128_t> values(100), back(100);
+    for(uint128_t & v : values){
+        v = gen();
+    }
+    std::vector <char> text(100 * 27, ',');
+    ulid_format_n(values.data(), values.size(), text.data(), 27);
+    EXPECT_EQ(ulid_parse_n(text.data(), values.size(), back.data(), 27), values.size());
+    EXPECT_EQ(back, values);
+}
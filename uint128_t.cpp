@@ -1,32 +1,17 @@
-#include "uint128_t.build"
-
-const uint128_t uint128_0(0);
-const uint128_t uint128_1(1);
-
-uint128_t::uint128_t()
-    : UPPER(0), LOWER(0)
-{}
-
-uint128_t::uint128_t(const uint128_t & rhs)
-    : UPPER(rhs.UPPER), LOWER(rhs.LOWER)
-{}
+#include <cmath>
+#include <cstring>
+#include <limits>
 
-uint128_t::uint128_t(uint128_t && rhs)
-    : UPPER(std::move(rhs.UPPER)), LOWER(std::move(rhs.LOWER))
-{
-    if (this != &rhs){
-        rhs.UPPER = 0;
-        rhs.LOWER = 0;
-    }
-}
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
 
-uint128_t & uint128_t::operator=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator=(const uint128_t & rhs){
     UPPER = rhs.UPPER;
     LOWER = rhs.LOWER;
     return *this;
 }
 
-uint128_t & uint128_t::operator=(uint128_t && rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator=(uint128_t && rhs){
     if (this != &rhs){
         UPPER = std::move(rhs.UPPER);
         LOWER = std::move(rhs.LOWER);
@@ -36,426 +21,499 @@ uint128_t & uint128_t::operator=(uint128_t && rhs){
     return *this;
 }
 
-uint128_t::operator bool() const{
+UINT128_T_INLINE uint128_t::operator bool() const{
     return (bool) (UPPER | LOWER);
 }
 
-uint128_t::operator uint8_t() const{
+UINT128_T_INLINE uint128_t::operator uint8_t() const{
     return (uint8_t) LOWER;
 }
 
-uint128_t::operator uint16_t() const{
+UINT128_T_INLINE uint128_t::operator uint16_t() const{
     return (uint16_t) LOWER;
 }
 
-uint128_t::operator uint32_t() const{
+UINT128_T_INLINE uint128_t::operator uint32_t() const{
     return (uint32_t) LOWER;
 }
 
-uint128_t::operator uint64_t() const{
+UINT128_T_INLINE uint128_t::operator uint64_t() const{
     return (uint64_t) LOWER;
 }
 
-uint128_t uint128_t::operator&(const uint128_t & rhs) const{
-    return uint128_t(UPPER & rhs.UPPER, LOWER & rhs.LOWER);
-}
-
-uint128_t & uint128_t::operator&=(const uint128_t & rhs){
-    UPPER &= rhs.UPPER;
-    LOWER &= rhs.LOWER;
-    return *this;
-}
+static_assert(std::numeric_limits <float>::is_iec559 && std::numeric_limits <double>::is_iec559,
+              "uint128_t expects IEEE 754 float and double");
 
-uint128_t uint128_t::operator|(const uint128_t & rhs) const{
-    return uint128_t(UPPER | rhs.UPPER, LOWER | rhs.LOWER);
-}
+// The leading Digits bits of a nonzero value, rounded to nearest with ties to
+// even, and the position of its top bit. A carry out of the rounding gives
+// 2^Digits, which moves into the exponent field when the caller adds it.
+template <unsigned Digits>
+static inline uint64_t uint128_round(const uint64_t upper, const uint64_t lower, unsigned & top){
+    const unsigned shift = upper ? uint128_detail::clz64(upper) : 64 + uint128_detail::clz64(lower);
+    top = 127 - shift;
 
-uint128_t & uint128_t::operator|=(const uint128_t & rhs){
-    UPPER |= rhs.UPPER;
-    LOWER |= rhs.LOWER;
-    return *this;
-}
+    uint64_t high, rest;
+    if (shift == 0){
+        high = upper;
+        rest = lower;
+    }
+    else if (shift < 64){
+        high = (upper << shift) | (lower >> (64 - shift));
+        rest = lower << shift;
+    }
+    else{
+        high = lower << (shift - 64);
+        rest = 0;
+    }
 
-uint128_t uint128_t::operator^(const uint128_t & rhs) const{
-    return uint128_t(UPPER ^ rhs.UPPER, LOWER ^ rhs.LOWER);
+    const uint64_t half = 0x8000000000000000ULL;
+    uint64_t m = high >> (64 - Digits);
+    const uint64_t dropped = (high << Digits) | (rest != 0);
+    m += (dropped > half) || ((dropped == half) && (m & 1));
+    return m;
 }
 
-uint128_t & uint128_t::operator^=(const uint128_t & rhs){
-    UPPER ^= rhs.UPPER;
-    LOWER ^= rhs.LOWER;
-    return *this;
+static inline double uint128_to_double(const uint64_t upper, const uint64_t lower){
+    if (!upper){
+        return (double) lower;
+    }
+    unsigned top;
+    const uint64_t m = uint128_round <53> (upper, lower, top);
+    const uint64_t bits = ((uint64_t) (top + 1022) << 52) + m;
+    double out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
 }
 
-uint128_t uint128_t::operator~() const{
-    return uint128_t(~UPPER, ~LOWER);
-}
+// Truncates the IEEE 754 value with Fraction stored fraction bits and
+// exponent bias Bias
+template <typename Bits, unsigned Fraction, unsigned Bias>
+static inline void uint128_from_ieee(const Bits bits, uint64_t & upper, uint64_t & lower){
+    const unsigned width = sizeof(Bits) * 8;
+    const unsigned biased = (unsigned) (bits >> Fraction) & ((1U << (width - 1 - Fraction)) - 1);
+    const Bits fraction = bits & (((Bits) 1 << Fraction) - 1);
+    const bool negative = (bits >> (width - 1)) != 0;
 
-uint128_t uint128_t::operator<<(const uint128_t & rhs) const{
-    const uint64_t shift = rhs.LOWER;
-    if (((bool) rhs.UPPER) || (shift >= 128)){
-        return uint128_0;
+    upper = lower = 0;
+    if ((biased == 2 * Bias + 1) && fraction){
+        throw std::domain_error("Error: NaN converted to uint128_t");
     }
-    else if (shift == 64){
-        return uint128_t(LOWER, 0);
+    if (biased < Bias){
+        return;
     }
-    else if (shift == 0){
-        return *this;
+    if (negative){
+        throw std::domain_error("Error: negative value converted to uint128_t");
     }
-    else if (shift < 64){
-        return uint128_t((UPPER << shift) + (LOWER >> (64 - shift)), LOWER << shift);
+    const unsigned e = biased - Bias;
+    if (e >= 128){
+        throw std::overflow_error("Error: value too large for uint128_t");
     }
-    else if ((128 > shift) && (shift > 64)){
-        return uint128_t(LOWER << (shift - 64), 0);
+
+    const uint64_t m = (uint64_t) fraction | ((uint64_t) 1 << Fraction);
+    if (e < Fraction){
+        lower = m >> (Fraction - e);
+    }
+    else if (e - Fraction == 0){
+        lower = m;
+    }
+    else if (e - Fraction < 64){
+        upper = m >> (64 - (e - Fraction));
+        lower = m << (e - Fraction);
     }
     else{
-        return uint128_0;
+        upper = m << (e - Fraction - 64);
     }
 }
 
-uint128_t & uint128_t::operator<<=(const uint128_t & rhs){
-    *this = *this << rhs;
-    return *this;
+static inline void uint128_from_double(const double value, uint64_t & upper, uint64_t & lower){
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint128_from_ieee <uint64_t, 52, 1023> (bits, upper, lower);
+}
+
+UINT128_T_INLINE uint128_t::uint128_t(const float & rhs)
+    : uint128_t(0, 0)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &rhs, sizeof(bits));
+    uint128_from_ieee <uint32_t, 23, 127> (bits, UPPER, LOWER);
 }
 
-uint128_t uint128_t::operator>>(const uint128_t & rhs) const{
-    const uint64_t shift = rhs.LOWER;
-    if (((bool) rhs.UPPER) || (shift >= 128)){
-        return uint128_0;
+UINT128_T_INLINE uint128_t::uint128_t(const double & rhs)
+    : uint128_t(0, 0)
+{
+    uint128_from_double(rhs, UPPER, LOWER);
+}
+
+// The layout of long double varies (x87, binary128, or the same as double),
+// so this one goes through <cmath>. Scaling by 2^-64 is exact, and so is the
+// subtraction of the upper limb, which leaves less than 2^64.
+UINT128_T_INLINE uint128_t::uint128_t(const long double & rhs)
+    : uint128_t(0, 0)
+{
+    if (std::numeric_limits <long double>::digits < 64){
+        uint128_from_double((double) rhs, UPPER, LOWER);
+        return;
     }
-    else if (shift == 64){
-        return uint128_t(0, UPPER);
+    if (std::isnan(rhs)){
+        throw std::domain_error("Error: NaN converted to uint128_t");
     }
-    else if (shift == 0){
-        return *this;
+    if (rhs < 1){
+        if (rhs <= -1){
+            throw std::domain_error("Error: negative value converted to uint128_t");
+        }
+        return;
     }
-    else if (shift < 64){
-        return uint128_t(UPPER >> shift, (UPPER << (64 - shift)) + (LOWER >> shift));
+    if (rhs >= std::ldexp(1.0L, 128)){
+        throw std::overflow_error("Error: value too large for uint128_t");
     }
-    else if ((128 > shift) && (shift > 64)){
-        return uint128_t(0, (UPPER >> (shift - 64)));
+    if (rhs < std::ldexp(1.0L, 64)){
+        LOWER = (uint64_t) rhs;
+        return;
     }
-    else{
-        return uint128_0;
+    UPPER = (uint64_t) std::ldexp(rhs, -64);
+    LOWER = (uint64_t) (rhs - std::ldexp((long double) UPPER, 64));
+}
+
+UINT128_T_INLINE uint128_t::operator float() const{
+    if (!UPPER){
+        return (float) LOWER;
     }
+    unsigned top;
+    const uint32_t m = (uint32_t) uint128_round <24> (UPPER, LOWER, top);
+    const uint32_t bits = ((uint32_t) (top + 126) << 23) + m;     // 2^128 and up round to inf
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
 }
 
-uint128_t & uint128_t::operator>>=(const uint128_t & rhs){
-    *this = *this >> rhs;
+UINT128_T_INLINE uint128_t::operator double() const{
+    return uint128_to_double(UPPER, LOWER);
+}
+
+// with 64 or more digits the upper limb and its scaling are exact, leaving
+// the addition as the only rounding
+UINT128_T_INLINE uint128_t::operator long double() const{
+    if (std::numeric_limits <long double>::digits < 64){
+        return uint128_to_double(UPPER, LOWER);
+    }
+    return std::ldexp((long double) UPPER, 64) + (long double) LOWER;
+}
+
+UINT128_T_INLINE uint128_t uint128_t::operator&(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(bit_and);
+    return uint128_t(UPPER & rhs.UPPER, LOWER & rhs.LOWER);
+}
+
+UINT128_T_INLINE uint128_t & uint128_t::operator&=(const uint128_t & rhs){
+    UINT128_T_COUNT_OP(bit_and);
+    UPPER &= rhs.UPPER;
+    LOWER &= rhs.LOWER;
     return *this;
 }
 
-bool uint128_t::operator!() const{
+UINT128_T_INLINE uint128_t uint128_t::operator|(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(bit_or);
+    return uint128_t(UPPER | rhs.UPPER, LOWER | rhs.LOWER);
+}
+
+UINT128_T_INLINE uint128_t & uint128_t::operator|=(const uint128_t & rhs){
+    UINT128_T_COUNT_OP(bit_or);
+    UPPER |= rhs.UPPER;
+    LOWER |= rhs.LOWER;
+    return *this;
+}
+
+UINT128_T_INLINE uint128_t uint128_t::operator^(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(bit_xor);
+    return uint128_t(UPPER ^ rhs.UPPER, LOWER ^ rhs.LOWER);
+}
+
+UINT128_T_INLINE uint128_t & uint128_t::operator^=(const uint128_t & rhs){
+    UINT128_T_COUNT_OP(bit_xor);
+    UPPER ^= rhs.UPPER;
+    LOWER ^= rhs.LOWER;
+    return *this;
+}
+
+UINT128_T_INLINE uint128_t uint128_t::operator~() const{
+    UINT128_T_COUNT_OP(bit_not);
+    return uint128_t(~UPPER, ~LOWER);
+}
+
+UINT128_T_INLINE bool uint128_t::operator!() const{
     return !(bool) (UPPER | LOWER);
 }
 
-bool uint128_t::operator&&(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator&&(const uint128_t & rhs) const{
     return ((bool) *this && rhs);
 }
 
-bool uint128_t::operator||(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator||(const uint128_t & rhs) const{
      return ((bool) *this || rhs);
 }
 
-bool uint128_t::operator==(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator==(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(compare);
     return ((UPPER == rhs.UPPER) && (LOWER == rhs.LOWER));
 }
 
-bool uint128_t::operator!=(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator!=(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(compare);
     return ((UPPER != rhs.UPPER) | (LOWER != rhs.LOWER));
 }
 
-bool uint128_t::operator>(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator>(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(compare);
     if (UPPER == rhs.UPPER){
         return (LOWER > rhs.LOWER);
     }
     return (UPPER > rhs.UPPER);
 }
 
-bool uint128_t::operator<(const uint128_t & rhs) const{
+UINT128_T_INLINE bool uint128_t::operator<(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(compare);
     if (UPPER == rhs.UPPER){
         return (LOWER < rhs.LOWER);
     }
     return (UPPER < rhs.UPPER);
 }
 
-bool uint128_t::operator>=(const uint128_t & rhs) const{
-    return ((*this > rhs) | (*this == rhs));
+UINT128_T_INLINE bool uint128_t::operator>=(const uint128_t & rhs) const{
+    return !(*this < rhs);
 }
 
-bool uint128_t::operator<=(const uint128_t & rhs) const{
-    return ((*this < rhs) | (*this == rhs));
+UINT128_T_INLINE bool uint128_t::operator<=(const uint128_t & rhs) const{
+    return !(*this > rhs);
 }
 
-uint128_t uint128_t::operator+(const uint128_t & rhs) const{
+UINT128_T_INLINE uint128_t uint128_t::operator+(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(add);
     return uint128_t(UPPER + rhs.UPPER + ((LOWER + rhs.LOWER) < LOWER), LOWER + rhs.LOWER);
 }
 
-uint128_t & uint128_t::operator+=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator+=(const uint128_t & rhs){
+    UINT128_T_COUNT_OP(add);
     UPPER += rhs.UPPER + ((LOWER + rhs.LOWER) < LOWER);
     LOWER += rhs.LOWER;
     return *this;
 }
 
-uint128_t uint128_t::operator-(const uint128_t & rhs) const{
+UINT128_T_INLINE uint128_t uint128_t::operator-(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(sub);
     return uint128_t(UPPER - rhs.UPPER - ((LOWER - rhs.LOWER) > LOWER), LOWER - rhs.LOWER);
 }
 
-uint128_t & uint128_t::operator-=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator-=(const uint128_t & rhs){
     *this = *this - rhs;
     return *this;
 }
 
-uint128_t uint128_t::operator*(const uint128_t & rhs) const{
-    // split values into 4 32-bit parts
-    uint64_t top[4] = {UPPER >> 32, UPPER & 0xffffffff, LOWER >> 32, LOWER & 0xffffffff};
-    uint64_t bottom[4] = {rhs.UPPER >> 32, rhs.UPPER & 0xffffffff, rhs.LOWER >> 32, rhs.LOWER & 0xffffffff};
-    uint64_t products[4][4];
-
-    // multiply each component of the values
-    for(int y = 3; y > -1; y--){
-        for(int x = 3; x > -1; x--){
-            products[3 - x][y] = top[x] * bottom[y];
-        }
-    }
-
-    // first row
-    uint64_t fourth32 = (products[0][3] & 0xffffffff);
-    uint64_t third32  = (products[0][2] & 0xffffffff) + (products[0][3] >> 32);
-    uint64_t second32 = (products[0][1] & 0xffffffff) + (products[0][2] >> 32);
-    uint64_t first32  = (products[0][0] & 0xffffffff) + (products[0][1] >> 32);
-
-    // second row
-    third32  += (products[1][3] & 0xffffffff);
-    second32 += (products[1][2] & 0xffffffff) + (products[1][3] >> 32);
-    first32  += (products[1][1] & 0xffffffff) + (products[1][2] >> 32);
-
-    // third row
-    second32 += (products[2][3] & 0xffffffff);
-    first32  += (products[2][2] & 0xffffffff) + (products[2][3] >> 32);
-
-    // fourth row
-    first32  += (products[3][3] & 0xffffffff);
-
-    // move carry to next digit
-    third32  += fourth32 >> 32;
-    second32 += third32  >> 32;
-    first32  += second32 >> 32;
-
-    // remove carry from current digit
-    fourth32 &= 0xffffffff;
-    third32  &= 0xffffffff;
-    second32 &= 0xffffffff;
-    first32  &= 0xffffffff;
-
-    // combine components
-    return uint128_t((first32 << 32) | second32, (third32 << 32) | fourth32);
+UINT128_T_INLINE uint128_t uint128_t::operator*(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(mul);
+    UINT128_T_COUNT_OPERANDS(*this, rhs);
+    return uint128_active_kernels().mul(*this, rhs);
 }
 
-uint128_t & uint128_t::operator*=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator*=(const uint128_t & rhs){
     *this = *this * rhs;
     return *this;
 }
 
-std::pair <uint128_t, uint128_t> uint128_t::divmod(const uint128_t & lhs, const uint128_t & rhs) const{
+UINT128_T_INLINE std::pair <uint128_t, uint128_t> uint128_t::divmod(const uint128_t & lhs, const uint128_t & rhs) const{
     // Save some calculations /////////////////////
-    if (rhs == uint128_0){
+    if (!(rhs.UPPER | rhs.LOWER)){
+        UINT128_T_COUNT_DIVMOD(by_zero, lhs, rhs);
         throw std::domain_error("Error: division or modulus by 0");
     }
-    else if (rhs == uint128_1){
+    else if (!rhs.UPPER && (rhs.LOWER == 1)){
+        UINT128_T_COUNT_DIVMOD(by_one, lhs, rhs);
         return std::pair <uint128_t, uint128_t> (lhs, uint128_0);
     }
-    else if (lhs == rhs){
+    else if ((lhs.UPPER == rhs.UPPER) && (lhs.LOWER == rhs.LOWER)){
+        UINT128_T_COUNT_DIVMOD(equal, lhs, rhs);
         return std::pair <uint128_t, uint128_t> (uint128_1, uint128_0);
     }
-    else if ((lhs == uint128_0) || (lhs < rhs)){
+    else if ((lhs.UPPER < rhs.UPPER) || ((lhs.UPPER == rhs.UPPER) && (lhs.LOWER < rhs.LOWER))){
+        UINT128_T_COUNT_DIVMOD(smaller, lhs, rhs);
         return std::pair <uint128_t, uint128_t> (uint128_0, lhs);
     }
 
-    std::pair <uint128_t, uint128_t> qr (uint128_0, uint128_0);
-    for(uint8_t x = lhs.bits(); x > 0; x--){
-        qr.first  <<= uint128_1;
-        qr.second <<= uint128_1;
-
-        if ((lhs >> (x - 1U)) & 1){
-            ++qr.second;
+    #if defined(UINT128_T_STATS)
+        if (rhs.UPPER){
+            UINT128_T_COUNT_DIVMOD(wide, lhs, rhs);
         }
-
-        if (qr.second >= rhs){
-            qr.second -= rhs;
-            ++qr.first;
+        else if (lhs.UPPER < rhs.LOWER){
+            UINT128_T_COUNT_DIVMOD(narrow_one, lhs, rhs);
         }
-    }
+        else{
+            UINT128_T_COUNT_DIVMOD(narrow_two, lhs, rhs);
+        }
+    #endif
+
+    std::pair <uint128_t, uint128_t> qr;
+    uint128_active_kernels().divmod(lhs, rhs, qr.first, qr.second);
     return qr;
 }
 
-uint128_t uint128_t::operator/(const uint128_t & rhs) const{
+UINT128_T_INLINE uint128_t uint128_t::operator/(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(div);
     return divmod(*this, rhs).first;
 }
 
-uint128_t & uint128_t::operator/=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator/=(const uint128_t & rhs){
     *this = *this / rhs;
     return *this;
 }
 
-uint128_t uint128_t::operator%(const uint128_t & rhs) const{
+UINT128_T_INLINE uint128_t uint128_t::operator%(const uint128_t & rhs) const{
+    UINT128_T_COUNT_OP(mod);
     return divmod(*this, rhs).second;
 }
 
-uint128_t & uint128_t::operator%=(const uint128_t & rhs){
+UINT128_T_INLINE uint128_t & uint128_t::operator%=(const uint128_t & rhs){
     *this = *this % rhs;
     return *this;
 }
 
-uint128_t & uint128_t::operator++(){
+UINT128_T_INLINE uint128_t & uint128_t::operator++(){
     return *this += uint128_1;
 }
 
-uint128_t uint128_t::operator++(int){
+UINT128_T_INLINE uint128_t uint128_t::operator++(int){
     uint128_t temp(*this);
     ++*this;
     return temp;
 }
 
-uint128_t & uint128_t::operator--(){
+UINT128_T_INLINE uint128_t & uint128_t::operator--(){
     return *this -= uint128_1;
 }
 
-uint128_t uint128_t::operator--(int){
+UINT128_T_INLINE uint128_t uint128_t::operator--(int){
     uint128_t temp(*this);
     --*this;
     return temp;
 }
 
-uint128_t uint128_t::operator+() const{
+UINT128_T_INLINE uint128_t uint128_t::operator+() const{
     return *this;
 }
 
-uint128_t uint128_t::operator-() const{
-    return ~*this + uint128_1;
-}
-
-const uint64_t & uint128_t::upper() const{
-    return UPPER;
-}
-
-const uint64_t & uint128_t::lower() const{
-    return LOWER;
+UINT128_T_INLINE uint128_t uint128_t::operator-() const{
+    UINT128_T_COUNT_OP(negate);
+    return uint128_t(~UPPER + !LOWER, 0 - LOWER);
 }
 
-uint8_t uint128_t::bits() const{
-    uint8_t out = 0;
-    if (UPPER){
-        out = 64;
-        uint64_t up = UPPER;
-        while (up){
-            up >>= 1;
-            out++;
-        }
-    }
-    else{
-        uint64_t low = LOWER;
-        while (low){
-            low >>= 1;
-            out++;
-        }
-    }
+UINT128_T_INLINE uint8_t uint128_t::bits() const{
+    const uint8_t out = uint128_active_kernels().bits(*this);
+    UINT128_T_COUNT_BITS(out);
     return out;
 }
 
-std::string uint128_t::str(uint8_t base, const unsigned int & len) const{
+UINT128_T_INLINE std::string uint128_t::str(uint8_t base, const unsigned int & len) const{
     if ((base < 2) || (base > 16)){
         throw std::invalid_argument("Base must be in the range [2, 16]");
     }
-    std::string out = "";
-    if (!(*this)){
-        out = "0";
-    }
-    else{
-        std::pair <uint128_t, uint128_t> qr(*this, uint128_0);
-        do{
-            qr = divmod(qr.first, base);
-            out = "0123456789abcdef"[(uint8_t) qr.second] + out;
-        } while (qr.first);
-    }
-    if (out.size() < len){
-        out = std::string(len - out.size(), '0') + out;
+    char digits[128];
+    const std::size_t size = uint128_active_kernels().format(*this, base, digits);
+    std::string out;
+    if (size < len){
+        out.reserve(len);
+        out.assign(len - size, '0');
     }
+    out.append(digits, size);
+    UINT128_T_COUNT_STR(out);
     return out;
 }
 
-uint128_t operator<<(const bool & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const bool & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const uint8_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const uint8_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const uint16_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const uint16_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const uint32_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const uint32_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const uint64_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const uint64_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const int8_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const int8_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const int16_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const int16_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const int32_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const int32_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator<<(const int64_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator<<(const int64_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) << rhs;
 }
 
-uint128_t operator>>(const bool & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const bool & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const uint8_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const uint8_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const uint16_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const uint16_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const uint32_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const uint32_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const uint64_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const uint64_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const int8_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const int8_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const int16_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const int16_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const int32_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const int32_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-uint128_t operator>>(const int64_t & lhs, const uint128_t & rhs){
+UINT128_T_INLINE uint128_t operator>>(const int64_t & lhs, const uint128_t & rhs){
     return uint128_t(lhs) >> rhs;
 }
 
-std::ostream & operator<<(std::ostream & stream, const uint128_t & rhs){
+UINT128_T_INLINE void to_double(const uint128_t * in, std::size_t count, double * out){
+    for(std::size_t i = 0; i < count; i++){
+        out[i] = uint128_to_double(in[i].upper(), in[i].lower());
+    }
+}
+
+UINT128_T_INLINE void from_double(const double * in, std::size_t count, uint128_t * out){
+    for(std::size_t i = 0; i < count; i++){
+        uint64_t upper, lower;
+        uint128_from_double(in[i], upper, lower);
+        out[i] = uint128_t(upper, lower);
+    }
+}
+
+UINT128_T_INLINE std::ostream & operator<<(std::ostream & stream, const uint128_t & rhs){
     if (stream.flags() & stream.oct){
         stream << rhs.str(8);
     }
@@ -2,7 +2,17 @@
 #ifndef _UINT128_H_
 #define _UINT128_H_
 #include "uint128_t_config.include"
-#define UINT128_T_EXTERN _UINT128_T_IMPORT
+#ifndef UINT128_T_EXTERN
+  #define UINT128_T_EXTERN _UINT128_T_IMPORT
+#endif
 #include "uint128_t.include"
+#if defined(UINT128_T_HEADER_ONLY)
+  // the implementation calls through the dispatch table, so it is pulled in from there
+  #include "uint128_t_dispatch.h"
+  #if defined(UINT128_T_STATS)
+    // and the counters behind the hooks
+    #include "uint128_t_stats.h"
+  #endif
+#endif
 #endif
 
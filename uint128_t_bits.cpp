@@ -0,0 +1,11 @@
+#include "uint128_t.build"
+#include "uint128_t_bits.h"
+#include "uint128_t_dispatch.h"
+
+UINT128_T_INLINE uint128_t pdep(const uint128_t & src, const uint128_t & mask){
+    return uint128_active_kernels().pdep(src, mask);
+}
+
+UINT128_T_INLINE uint128_t pext(const uint128_t & src, const uint128_t & mask){
+    return uint128_active_kernels().pext(src, mask);
+}
@@ -0,0 +1,165 @@
+// PUBLIC IMPORT HEADER
+// Bit field and bit permutation functions
+//
+//     extract_bits(v, pos, len)         - bits pos to pos + len - 1 of v, moved down to bit 0
+//     insert_bits(v, field, pos, len)   - v with those bits replaced by the low len bits of field
+//     pdep(src, mask)                   - the low bits of src scattered to the set bits of mask
+//     pext(src, mask)                   - the bits of src under mask gathered down to bit 0
+//     byteswap(v)                       - byte order reversed
+//     bit_reverse(v)                    - bit i moved to bit 127 - i
+//     parity(v)                         - true if an odd number of bits is set
+//
+// and for amounts known at compile time, all constexpr:
+//
+//     shl<N>(v), shr<N>(v)              - v << N and v >> N, for N up to 128
+//     rotl<N>(v), rotr<N>(v)            - v rotated by N mod 128
+//     low_mask<N>(), high_mask<N>()     - the low or high N bits set, for N up to 128
+//     bit<N>()                          - only bit N set, for N below 128
+//
+// Bits past 127 read as 0 and writes to them are dropped, as with the shift
+// operators: extract_bits(v, pos, len) == (v >> pos) & ((1 << len) - 1).
+//
+// Everything except pdep and pext is inline and works on the two limbs, so
+// field access compiles to a few shifts instead of calls to the operators.
+// The templates pick their limbs when they are instantiated, so each one is
+// one or two shifts, or none: shl<64>(v) only moves the lower limb up. The
+// shift operators fold the same way when they are inlined with a constant
+// amount; the templates also work in constant expressions.
+// pdep and pext go through the dispatch table: the bmi2 and higher kernels use
+// PDEP/PEXT, the generic kernel takes one step per set bit of the mask.
+#ifndef _UINT128_T_BITS_H_
+#define _UINT128_T_BITS_H_
+
+#include "uint128_t.h"
+#include "uint128_t_intrinsics.include"
+
+namespace uint128_bits_detail {
+    // hi:lo >>= s, for s below 128. Field positions are often data
+    // dependent, so the limbs are chosen with masks rather than branches.
+    inline void shr(uint64_t & hi, uint64_t & lo, const unsigned s){
+        const unsigned t = s & 63;
+        const uint64_t down = (lo >> t) | ((hi << 1) << (63 - t));
+        const uint64_t top = hi >> t;
+        const uint64_t whole = 0 - (uint64_t) ((s >> 6) & 1);
+        lo = (down & ~whole) | (top & whole);
+        hi = top & ~whole;
+    }
+
+    // hi:lo <<= s, for s below 128
+    inline void shl(uint64_t & hi, uint64_t & lo, const unsigned s){
+        const unsigned t = s & 63;
+        const uint64_t up = (hi << t) | ((lo >> 1) >> (63 - t));
+        const uint64_t bottom = lo << t;
+        const uint64_t whole = 0 - (uint64_t) ((s >> 6) & 1);
+        hi = (up & ~whole) | (bottom & whole);
+        lo = bottom & ~whole;
+    }
+
+    // the low len bits set; all of them from 128 up
+    inline void low_mask(const unsigned len, uint64_t & hi, uint64_t & lo){
+        const uint64_t partial = ~(0xffffffffffffffffULL << (len & 63));
+        const uint64_t past_lo = 0 - (uint64_t) (len >= 64);
+        const uint64_t past_hi = 0 - (uint64_t) (len >= 128);
+        lo = partial | past_lo;
+        hi = (partial & past_lo) | past_hi;
+    }
+
+    // hi:lo rotated left by s, for s below 64
+    constexpr uint128_t rotl(const uint64_t hi, const uint64_t lo, const unsigned s){
+        return s ? uint128_t((hi << s) | (lo >> (64 - s)), (lo << s) | (hi >> (64 - s))) : uint128_t(hi, lo);
+    }
+}
+
+// Shift counts below are taken mod 64 so that branches not taken for a given
+// N still have valid shifts.
+template <unsigned N>
+constexpr uint128_t shl(const uint128_t & v){
+    static_assert(N <= 128, "shl<N>: N must be at most 128");
+    return (N == 0) ? v :
+           (N < 64)  ? uint128_t((v.upper() << (N & 63)) | (v.lower() >> ((64 - N) & 63)), v.lower() << (N & 63)) :
+           (N < 128) ? uint128_t(v.lower() << (N & 63), (uint64_t) 0) :
+                       uint128_t();
+}
+
+template <unsigned N>
+constexpr uint128_t shr(const uint128_t & v){
+    static_assert(N <= 128, "shr<N>: N must be at most 128");
+    return (N == 0) ? v :
+           (N < 64)  ? uint128_t(v.upper() >> (N & 63), (v.lower() >> (N & 63)) | (v.upper() << ((64 - N) & 63))) :
+           (N < 128) ? uint128_t((uint64_t) 0, v.upper() >> (N & 63)) :
+                       uint128_t();
+}
+
+template <unsigned N>
+constexpr uint128_t rotl(const uint128_t & v){
+    return ((N % 128) < 64) ? uint128_bits_detail::rotl(v.upper(), v.lower(), N % 64)
+                            : uint128_bits_detail::rotl(v.lower(), v.upper(), N % 64);
+}
+
+template <unsigned N>
+constexpr uint128_t rotr(const uint128_t & v){
+    return rotl <(128 - N % 128) % 128> (v);
+}
+
+template <unsigned N>
+constexpr uint128_t low_mask(){
+    static_assert(N <= 128, "low_mask<N>: N must be at most 128");
+    return (N == 0)  ? uint128_t() :
+           (N <= 64) ? uint128_t((uint64_t) 0, 0xffffffffffffffffULL >> ((64 - N) & 63)) :
+                       uint128_t(0xffffffffffffffffULL >> ((128 - N) & 63), 0xffffffffffffffffULL);
+}
+
+template <unsigned N>
+constexpr uint128_t high_mask(){
+    static_assert(N <= 128, "high_mask<N>: N must be at most 128");
+    return uint128_t(~low_mask <128 - N> ().upper(), ~low_mask <128 - N> ().lower());
+}
+
+template <unsigned N>
+constexpr uint128_t bit(){
+    static_assert(N < 128, "bit<N>: N must be below 128");
+    return (N < 64) ? uint128_t((uint64_t) 0, 1ULL << (N & 63)) : uint128_t(1ULL << (N & 63), (uint64_t) 0);
+}
+
+inline uint128_t extract_bits(const uint128_t & v, const unsigned pos, const unsigned len){
+    if (pos >= 128){
+        return 0;
+    }
+    uint64_t hi = v.upper(), lo = v.lower(), mask_hi, mask_lo;
+    uint128_bits_detail::shr(hi, lo, pos);
+    uint128_bits_detail::low_mask(len, mask_hi, mask_lo);
+    return uint128_t(hi & mask_hi, lo & mask_lo);
+}
+
+inline uint128_t insert_bits(const uint128_t & v, const uint128_t & field, const unsigned pos, const unsigned len){
+    if (pos >= 128){
+        return v;
+    }
+    uint64_t mask_hi, mask_lo, field_hi = field.upper(), field_lo = field.lower();
+    uint128_bits_detail::low_mask(len, mask_hi, mask_lo);
+    uint128_bits_detail::shl(mask_hi, mask_lo, pos);
+    uint128_bits_detail::shl(field_hi, field_lo, pos);
+    return uint128_t((v.upper() & ~mask_hi) | (field_hi & mask_hi),
+                     (v.lower() & ~mask_lo) | (field_lo & mask_lo));
+}
+
+UINT128_T_EXTERN uint128_t pdep(const uint128_t & src, const uint128_t & mask);
+UINT128_T_EXTERN uint128_t pext(const uint128_t & src, const uint128_t & mask);
+
+inline uint128_t byteswap(const uint128_t & v){
+    return uint128_t(uint128_detail::bswap64(v.lower()), uint128_detail::bswap64(v.upper()));
+}
+
+inline uint128_t bit_reverse(const uint128_t & v){
+    return uint128_t(uint128_detail::bitrev64(v.lower()), uint128_detail::bitrev64(v.upper()));
+}
+
+inline bool parity(const uint128_t & v){
+    return uint128_detail::popcount64(v.upper() ^ v.lower()) & 1;
+}
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_bits.cpp"
+#endif
+
+#endif
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_codec.h"
+
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+  #define UINT128_T_CODEC_SWAR
+#endif
+
+// longest varint: 128 bits at 7 a byte
+static const std::size_t CODEC_VARINT_MAX = 19;
+
+// 64 bit words holding n values of the given width
+static inline std::size_t codec_packed_words(const std::size_t n, const unsigned bits){
+    return (std::size_t) (((uint64_t) n * bits + 63) / 64);
+}
+
+static inline std::size_t codec_varint_write(unsigned char * out, uint64_t hi, uint64_t lo){
+    std::size_t len = 0;
+    while (hi || (lo >= 0x80)){
+        out[len++] = (unsigned char) (lo | 0x80);
+        lo = (lo >> 7) | (hi << 57);
+        hi >>= 7;
+    }
+    out[len++] = (unsigned char) lo;
+    return len;
+}
+
+// p must have 8 readable bytes
+static inline const unsigned char * codec_varint_read(const unsigned char * p, uint64_t & hi, uint64_t & lo){
+    #if defined(UINT128_T_CODEC_SWAR)
+        // up to 8 bytes (56 bits) at once: the first byte without its top
+        // bit ends the varint, and the 7 bit groups are closed up pairwise
+        uint64_t x;
+        std::memcpy(&x, p, sizeof(x));
+        const uint64_t stops = ~x & 0x8080808080808080ULL;
+        if (stops){
+            x &= (stops ^ (stops - 1)) & 0x7f7f7f7f7f7f7f7fULL;
+            x = (x & 0x007f007f007f007fULL) | ((x & 0x7f007f007f007f00ULL) >> 1);
+            x = (x & 0x00003fff00003fffULL) | ((x & 0x3fff00003fff0000ULL) >> 2);
+            x = (x & 0x000000000fffffffULL) | ((x & 0x0fffffff00000000ULL) >> 4);
+            hi = 0;
+            lo = x;
+            return p + uint128_detail::ctz64(stops) / 8 + 1;
+        }
+    #endif
+
+    hi = lo = 0;
+    for(unsigned shift = 0; ; shift += 7){
+        const uint64_t group = *p & 0x7f;
+        if (shift < 64){
+            lo |= group << shift;
+            if (shift > 57){
+                hi |= group >> (64 - shift);
+            }
+        }
+        else{
+            hi |= group << (shift - 64);
+        }
+        if (!(*p++ & 0x80)){
+            return p;
+        }
+    }
+}
+
+UINT128_T_INLINE uint128_compressed::uint128_compressed(const uint128_codec codec)
+    : method(codec),
+      count(0)
+{}
+
+UINT128_T_INLINE uint128_compressed::uint128_compressed(const uint128_t * values, const std::size_t n, const uint128_codec codec)
+    : method(codec),
+      count(0)
+{
+    assign(values, n, codec);
+}
+
+UINT128_T_INLINE void uint128_compressed::assign(const uint128_t * values, const std::size_t n, const uint128_codec codec){
+    if ((codec != uint128_codec::frame) && (codec != uint128_codec::delta) && (codec != uint128_codec::dictionary)){
+        throw std::invalid_argument("Error: unknown uint128_codec");
+    }
+
+    method = codec;
+    count = n;
+    directory.clear();
+    words.clear();
+    directory.reserve((n + block_size - 1) / block_size);
+    for(std::size_t i = 0; i < n; i += block_size){
+        encode(values + i, std::min(n - i, (std::size_t) block_size));
+    }
+    words.push_back(0);
+    words.shrink_to_fit();
+}
+
+UINT128_T_INLINE void uint128_compressed::pack(const uint64_t * values, const std::size_t n, uint64_t & base, uint8_t & bits){
+    const std::pair <const uint64_t *, const uint64_t *> range = std::minmax_element(values, values + n);
+    base = *range.first;
+    const uint64_t spread = *range.second - base;
+    bits = (uint8_t) (spread ? 64 - uint128_detail::clz64(spread) : 0);
+    if (!bits){
+        return;
+    }
+
+    const std::size_t start = words.size();
+    words.resize(start + codec_packed_words(n, bits), 0);
+    uint64_t * packed = words.data() + start;
+    uint64_t pos = 0;
+    for(std::size_t i = 0; i < n; i++, pos += bits){
+        const uint64_t v = values[i] - base;
+        const std::size_t w = (std::size_t) (pos >> 6);
+        const unsigned s = (unsigned) (pos & 63);
+        packed[w] |= v << s;
+        if (s + bits > 64){
+            packed[w + 1] |= v >> (64 - s);
+        }
+    }
+}
+
+UINT128_T_INLINE void uint128_compressed::encode(const uint128_t * values, const std::size_t n){
+    // assign() only passes whole blocks and a shorter last one
+    if (!n || (n > block_size)){
+        return;
+    }
+
+    block b = {};
+    b.offset = words.size();
+    b.count = (uint16_t) n;
+
+    uint64_t upper[block_size], lower[block_size];
+    for(std::size_t i = 0; i < n; i++){
+        upper[i] = values[i].upper();
+        lower[i] = values[i].lower();
+    }
+
+    switch (method){
+        case uint128_codec::frame:
+            pack(upper, n, b.upper_base, b.upper_bits);
+            pack(lower, n, b.lower_base, b.lower_bits);
+            break;
+        case uint128_codec::delta:
+            {
+                unsigned char bytes[block_size * CODEC_VARINT_MAX];
+                std::size_t len = 0;
+                b.upper_base = values[0].upper();
+                b.lower_base = values[0].lower();
+                for(std::size_t i = 1; i < n; i++){
+                    uint64_t hi = 0;
+                    const uint64_t lo = uint128_detail::subb64(values[i].lower(), values[i - 1].lower(), hi);
+                    len += codec_varint_write(bytes + len, values[i].upper() - values[i - 1].upper() - hi, lo);
+                }
+                const std::size_t start = words.size();
+                words.resize(start + (len + 7) / 8, 0);
+                std::memcpy(words.data() + start, bytes, len);
+            }
+            break;
+        case uint128_codec::dictionary:
+            {
+                uint64_t entries[block_size];
+                std::copy(upper, upper + n, entries);
+                std::sort(entries, entries + n);
+                b.entries = (uint32_t) (std::unique(entries, entries + n) - entries);
+                words.insert(words.end(), entries, entries + b.entries);
+
+                // indexes replace the limbs; the smallest is always 0
+                for(std::size_t i = 0; i < n; i++){
+                    upper[i] = (uint64_t) (std::lower_bound(entries, entries + b.entries, upper[i]) - entries);
+                }
+                uint64_t zero;
+                pack(upper, n, zero, b.upper_bits);
+                pack(lower, n, b.lower_base, b.lower_bits);
+            }
+            break;
+    }
+
+    directory.push_back(b);
+}
+
+UINT128_T_INLINE void uint128_compressed::decode(const block & b, const std::size_t first, const std::size_t n,
+                                                 uint64_t * upper, uint64_t * lower) const{
+    const uint128_kernels & kernels = uint128_active_kernels();
+    const uint64_t * data = words.data() + b.offset;
+
+    switch (method){
+        case uint128_codec::frame:
+            kernels.unpack_n(data, b.upper_bits, b.upper_base, first, n, upper);
+            kernels.unpack_n(data + codec_packed_words(b.count, b.upper_bits), b.lower_bits, b.lower_base, first, n, lower);
+            break;
+        case uint128_codec::delta:
+            {
+                const unsigned char * p = (const unsigned char *) data;
+                uint64_t hi = b.upper_base, lo = b.lower_base;
+                for(std::size_t i = 0; i < first + n; i++){
+                    if (i){
+                        uint64_t dhi, dlo, carry = 0;
+                        p = codec_varint_read(p, dhi, dlo);
+                        lo = uint128_detail::addc64(lo, dlo, carry);
+                        hi += dhi + carry;
+                    }
+                    if (i >= first){
+                        upper[i - first] = hi;
+                        lower[i - first] = lo;
+                    }
+                }
+            }
+            break;
+        case uint128_codec::dictionary:
+            {
+                const uint64_t * indexes = data + b.entries;
+                kernels.unpack_n(indexes, b.upper_bits, 0, first, n, upper);
+                for(std::size_t i = 0; i < n; i++){
+                    upper[i] = data[upper[i]];
+                }
+                kernels.unpack_n(indexes + codec_packed_words(b.count, b.upper_bits), b.lower_bits, b.lower_base, first, n, lower);
+            }
+            break;
+    }
+}
+
+UINT128_T_INLINE uint128_codec uint128_compressed::codec() const{
+    return method;
+}
+
+UINT128_T_INLINE std::size_t uint128_compressed::size() const{
+    return count;
+}
+
+UINT128_T_INLINE std::size_t uint128_compressed::blocks() const{
+    return directory.size();
+}
+
+UINT128_T_INLINE std::size_t uint128_compressed::bytes() const{
+    return words.size() * sizeof(uint64_t) + directory.size() * sizeof(block);
+}
+
+UINT128_T_INLINE uint128_t uint128_compressed::operator[](const std::size_t i) const{
+    if (i >= count){
+        throw std::out_of_range("Error: uint128_compressed index out of range");
+    }
+    uint64_t hi, lo;
+    decode(directory[i / block_size], i % block_size, 1, &hi, &lo);
+    return uint128_t(hi, lo);
+}
+
+UINT128_T_INLINE void uint128_compressed::decode(const std::size_t first, const std::size_t n, uint64_t * upper, uint64_t * lower) const{
+    if ((first > count) || (n > count - first)){
+        throw std::out_of_range("Error: uint128_compressed read past the end");
+    }
+    for(std::size_t done = 0; done < n;){
+        const std::size_t at = (first + done) % block_size;
+        const std::size_t take = std::min(block_size - at, n - done);
+        decode(directory[(first + done) / block_size], at, take, upper + done, lower + done);
+        done += take;
+    }
+}
+
+UINT128_T_INLINE void uint128_compressed::decode(const std::size_t first, const std::size_t n, uint128_t * out) const{
+    if ((first > count) || (n > count - first)){
+        throw std::out_of_range("Error: uint128_compressed read past the end");
+    }
+    uint64_t upper[block_size], lower[block_size];
+    for(std::size_t done = 0; done < n;){
+        const std::size_t at = (first + done) % block_size;
+        const std::size_t take = std::min(block_size - at, n - done);
+        decode(directory[(first + done) / block_size], at, take, upper, lower);
+        for(std::size_t i = 0; i < take; i++){
+            out[done + i] = uint128_t(upper[i], lower[i]);
+        }
+        done += take;
+    }
+}
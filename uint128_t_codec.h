@@ -0,0 +1,83 @@
+// PUBLIC IMPORT HEADER
+// Compressed in-memory arrays of uint128_t values
+//
+// Values are split into blocks of block_size and each block is encoded on
+// its own with one of three codecs:
+//
+//     frame       the upper limbs and the lower limbs as two planes, each
+//                 stored as its minimum plus the offsets from it, bit packed
+//                 at the width of the largest one (frame of reference)
+//     delta       the first value, then the difference to the previous value
+//                 as a varint (7 bits a byte, up to 19 bytes)
+//     dictionary  the distinct upper limbs of the block, then an index into
+//                 them and the lower limb of each value, both bit packed
+//
+// All three suit sorted keys whose upper limb repeats over long runs. frame
+// and dictionary read any value in a block directly and unpack with the
+// dispatched unpack_n kernel; delta has to add up the differences from the
+// start of the block, but packs small steps tightest. delta works on
+// unsorted values too (differences wrap around), though it compresses them
+// poorly.
+#ifndef _UINT128_T_CODEC_H_
+#define _UINT128_T_CODEC_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "uint128_t.h"
+
+enum class uint128_codec : uint8_t {
+    frame      = 0,
+    delta      = 1,
+    dictionary = 2,
+};
+
+class UINT128_T_EXTERN uint128_compressed{
+    public:
+        static constexpr std::size_t block_size = 128;
+
+    private:
+        struct block{
+            uint64_t offset;        // first word of the block in words
+            uint64_t upper_base;    // frame: plane minimums; delta: the first value;
+            uint64_t lower_base;    // dictionary: lower plane minimum
+            uint32_t entries;       // dictionary: distinct upper limbs
+            uint16_t count;
+            uint8_t upper_bits;     // frame: upper plane width; dictionary: index width
+            uint8_t lower_bits;
+        };
+
+        uint128_codec method;
+        std::size_t count;
+        std::vector <block> directory;
+        std::vector <uint64_t> words;           // ends with a spare word for unpack_n
+
+        void pack(const uint64_t * values, const std::size_t n, uint64_t & base, uint8_t & bits);
+        void encode(const uint128_t * values, const std::size_t n);
+        void decode(const block & b, const std::size_t first, const std::size_t n, uint64_t * upper, uint64_t * lower) const;
+
+    public:
+        explicit uint128_compressed(const uint128_codec codec = uint128_codec::frame);
+        uint128_compressed(const uint128_t * values, const std::size_t n, const uint128_codec codec = uint128_codec::frame);
+
+        // replaces the contents
+        void assign(const uint128_t * values, const std::size_t n, const uint128_codec codec);
+
+        uint128_codec codec() const;
+        std::size_t size() const;
+        std::size_t blocks() const;
+
+        // memory held by the encoded values and the block directory
+        std::size_t bytes() const;
+
+        // throw std::out_of_range past the end
+        uint128_t operator[](const std::size_t i) const;
+        void decode(const std::size_t first, const std::size_t n, uint128_t * out) const;
+        void decode(const std::size_t first, const std::size_t n, uint64_t * upper, uint64_t * lower) const;
+};
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_codec.cpp"
+#endif
+
+#endif
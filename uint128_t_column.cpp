@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_column.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define UINT128_T_COLUMN_MMAP
+#endif
+
+static_assert(sizeof(uint128_column_header) == 64, "uint128_column_header must be 64 bytes");
+static_assert(sizeof(uint128_column_block) == 64, "uint128_column_block must be 64 bytes");
+static_assert(sizeof(uint128_t) == 16, "interleaved blocks need uint128_t to be two packed limbs");
+
+static const char UINT128_COLUMN_MAGIC[8] = {'U', '1', '2', '8', 'C', 'O', 'L', '1'};
+
+static inline uint64_t column_round_up(const uint64_t size){
+    return (size + 63) & ~(uint64_t) 63;
+}
+
+// 64 bit words holding n values of the given width
+static inline std::size_t column_packed_words(const std::size_t n, const unsigned bits){
+    return (std::size_t) (((uint64_t) n * bits + 63) / 64);
+}
+
+// bytes a plane takes in the file, before alignment
+static inline uint64_t column_plane_bytes(const uint128_column_layout layout, const std::size_t n, const unsigned bits){
+    return (layout == uint128_column_layout::packed) ? 8 * (uint64_t) column_packed_words(n, bits) : 8 * (uint64_t) n;
+}
+
+static inline bool column_upper_first(){
+    const uint128_t probe(1, 0);
+    uint64_t first;
+    std::memcpy(&first, &probe, sizeof(first));
+    return first == 1;
+}
+
+// values [first, first + n) of a plane packed bits wide above base; the
+// word after a plane is always in the file (the next plane or the directory)
+static inline void column_unpack(const uint64_t * words, const unsigned bits, const uint64_t base,
+                                 const std::size_t first, const std::size_t n, uint64_t * out){
+    uint128_active_kernels().unpack_n(words, bits, base, first, n, out);
+}
+
+UINT128_T_INLINE uint128_column_writer::uint128_column_writer(const std::string & path, const uint128_column_layout layout,
+                                                              const std::size_t block_size, const bool stats)
+    : file(nullptr), layout(layout), block_size((uint32_t) block_size), stats(stats), count(0), offset(0),
+      upper(), lower(), packed(), directory()
+{
+    if (!block_size || (block_size > 0xffffffffULL)){
+        throw std::invalid_argument("Error: column block size must be between 1 and 2^32 - 1");
+    }
+    if ((uint8_t) layout > (uint8_t) uint128_column_layout::packed){
+        throw std::invalid_argument("Error: unknown column layout");
+    }
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file){
+        throw std::runtime_error("Error: cannot create " + path);
+    }
+
+    // placeholder until close() knows the count and the directory
+    const uint128_column_header header = {};
+    write_bytes(&header, sizeof(header));
+
+    upper.reserve(block_size);
+    lower.reserve(block_size);
+}
+
+UINT128_T_INLINE uint128_column_writer::~uint128_column_writer(){
+    if (file){
+        try{
+            close();
+        }
+        catch (...){
+            if (file){
+                std::fclose(file);
+            }
+        }
+    }
+}
+
+UINT128_T_INLINE void uint128_column_writer::write_bytes(const void * data, const std::size_t size){
+    if (size && (std::fwrite(data, 1, size, file) != size)){
+        throw std::runtime_error("Error: could not write column file");
+    }
+    offset += size;
+}
+
+UINT128_T_INLINE void uint128_column_writer::align(){
+    static const unsigned char zeros[64] = {};
+    write_bytes(zeros, (std::size_t) (column_round_up(offset) - offset));
+}
+
+UINT128_T_INLINE void uint128_column_writer::write_plane(const std::vector <uint64_t> & plane, const std::size_t n,
+                                                         uint64_t & base, uint8_t & bits){
+    align();
+    if (layout != uint128_column_layout::packed){
+        write_bytes(plane.data(), n * sizeof(uint64_t));
+        return;
+    }
+
+    const std::pair <std::vector <uint64_t>::const_iterator, std::vector <uint64_t>::const_iterator> range =
+        std::minmax_element(plane.begin(), plane.begin() + n);
+    base = *range.first;
+    const uint64_t spread = *range.second - base;
+    bits = (uint8_t) (spread ? 64 - uint128_detail::clz64(spread) : 0);
+
+    packed.assign(column_packed_words(n, bits), 0);
+    uint64_t pos = 0;
+    for(std::size_t i = 0; i < n; i++, pos += bits){
+        const uint64_t v = plane[i] - base;
+        const std::size_t w = (std::size_t) (pos >> 6);
+        const unsigned s = (unsigned) (pos & 63);
+        if (bits){
+            packed[w] |= v << s;
+            if (s + bits > 64){
+                packed[w + 1] |= v >> (64 - s);
+            }
+        }
+    }
+    write_bytes(packed.data(), packed.size() * sizeof(uint64_t));
+}
+
+UINT128_T_INLINE void uint128_column_writer::flush(){
+    const std::size_t n = upper.size();
+    if (!n){
+        return;
+    }
+
+    uint128_column_block block = {};
+    block.count = (uint32_t) n;
+
+    if (stats){
+        std::size_t lo = 0, hi = 0;
+        for(std::size_t i = 1; i < n; i++){
+            if ((upper[i] < upper[lo]) || ((upper[i] == upper[lo]) && (lower[i] < lower[lo]))){
+                lo = i;
+            }
+            if ((upper[i] > upper[hi]) || ((upper[i] == upper[hi]) && (lower[i] > lower[hi]))){
+                hi = i;
+            }
+        }
+        block.min_upper = upper[lo];
+        block.min_lower = lower[lo];
+        block.max_upper = upper[hi];
+        block.max_lower = lower[hi];
+    }
+
+    if (layout == uint128_column_layout::interleaved){
+        // blocks are back to back so the whole file is one array
+        if (directory.empty()){
+            align();
+        }
+        block.offset = offset;
+        std::vector <uint128_t> records(n);
+        for(std::size_t i = 0; i < n; i++){
+            records[i] = uint128_t(upper[i], lower[i]);
+        }
+        write_bytes(records.data(), n * sizeof(uint128_t));
+    }
+    else{
+        align();
+        block.offset = offset;
+        write_plane(upper, n, block.upper_base, block.upper_bits);
+        write_plane(lower, n, block.lower_base, block.lower_bits);
+    }
+
+    directory.push_back(block);
+    count += n;
+    upper.clear();
+    lower.clear();
+}
+
+UINT128_T_INLINE void uint128_column_writer::write(const uint128_t & value){
+    upper.push_back(value.upper());
+    lower.push_back(value.lower());
+    if (upper.size() == block_size){
+        flush();
+    }
+}
+
+UINT128_T_INLINE void uint128_column_writer::write(const uint128_t * values, const std::size_t n){
+    for(std::size_t i = 0; i < n; i++){
+        write(values[i]);
+    }
+}
+
+UINT128_T_INLINE void uint128_column_writer::write(const uint64_t * hi, const uint64_t * lo, const std::size_t n){
+    for(std::size_t i = 0; i < n; ){
+        const std::size_t take = std::min <std::size_t> (n - i, block_size - upper.size());
+        upper.insert(upper.end(), hi + i, hi + i + take);
+        lower.insert(lower.end(), lo + i, lo + i + take);
+        i += take;
+        if (upper.size() == block_size){
+            flush();
+        }
+    }
+}
+
+UINT128_T_INLINE void uint128_column_writer::close(){
+    if (!file){
+        return;
+    }
+
+    flush();
+    align();
+
+    uint128_column_header header = {};
+    std::memcpy(header.magic, UINT128_COLUMN_MAGIC, sizeof(header.magic));
+    header.byte_order = uint128_column_header::ORDER_MARK;
+    header.count = count;
+    header.directory = offset;
+    header.blocks = (uint32_t) directory.size();
+    header.block_size = block_size;
+    header.layout = (uint8_t) layout;
+    header.flags = (uint8_t) ((stats ? uint128_column_header::STATS : 0) |
+                              (column_upper_first() ? uint128_column_header::UPPER_FIRST : 0));
+
+    write_bytes(directory.data(), directory.size() * sizeof(uint128_column_block));
+    const bool ok = (std::fseek(file, 0, SEEK_SET) == 0) &&
+                    (std::fwrite(&header, sizeof(header), 1, file) == 1);
+    const bool closed = (std::fclose(file) == 0);
+    file = nullptr;
+    if (!ok || !closed){
+        throw std::runtime_error("Error: could not finish column file");
+    }
+}
+
+UINT128_T_INLINE uint128_column_reader::uint128_column_reader(const std::string & path)
+    : bytes(nullptr), length(0), mapped(false), copy(), header(nullptr), directory(nullptr)
+{
+    #if defined(UINT128_T_COLUMN_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0){
+            throw std::runtime_error("Error: cannot open " + path);
+        }
+        struct stat st;
+        if ((::fstat(fd, &st) != 0) || (st.st_size < (off_t) sizeof(uint128_column_header))){
+            ::close(fd);
+            throw std::runtime_error("Error: " + path + " is not a uint128_t column file");
+        }
+        length = (std::size_t) st.st_size;
+        void * p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED){
+            throw std::runtime_error("Error: cannot map " + path);
+        }
+        bytes = static_cast <const unsigned char *> (p);
+        mapped = true;
+    #else
+        std::FILE * file = std::fopen(path.c_str(), "rb");
+        if (!file){
+            throw std::runtime_error("Error: cannot open " + path);
+        }
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        length = (size > 0) ? (std::size_t) size : 0;
+        copy.resize((length + 7) / 8);
+        const bool ok = length && (std::fread(copy.data(), 1, length, file) == length);
+        std::fclose(file);
+        if (!ok){
+            throw std::runtime_error("Error: cannot read " + path);
+        }
+        bytes = reinterpret_cast <const unsigned char *> (copy.data());
+    #endif
+
+    header = reinterpret_cast <const uint128_column_header *> (bytes);
+
+    // everything the accessors rely on is checked once here
+    bool valid = (length >= sizeof(uint128_column_header)) &&
+                 !std::memcmp(header -> magic, UINT128_COLUMN_MAGIC, sizeof(header -> magic)) &&
+                 (header -> byte_order == uint128_column_header::ORDER_MARK) &&
+                 (header -> layout <= (uint8_t) uint128_column_layout::packed) &&
+                 (header -> block_size > 0) &&
+                 !(header -> directory & 63) &&
+                 (header -> directory <= length) &&
+                 ((length - header -> directory) / sizeof(uint128_column_block) >= header -> blocks);
+    if (valid){
+        directory = reinterpret_cast <const uint128_column_block *> (bytes + header -> directory);
+        uint64_t total = 0, next = column_round_up(sizeof(uint128_column_header));
+        for(uint32_t b = 0; valid && (b < header -> blocks); b++){
+            const uint128_column_block & block = directory[b];
+            // sizes are compared with the room left before the directory, not
+            // added to the offset, so that no offset can wrap them around
+            const bool inside = (block.offset >= sizeof(uint128_column_header)) && (block.offset < header -> directory);
+            const uint64_t room = inside ? header -> directory - block.offset : 0;
+            uint64_t size;
+            if (header -> layout == (uint8_t) uint128_column_layout::interleaved){
+                // back to back, so data() can span them
+                size = 16 * (uint64_t) block.count;
+                valid = (block.offset == next);
+                next = block.offset + size;
+            }
+            else{
+                // the offset is aligned, so the upper plane ends aligned too
+                size = column_round_up(column_plane_bytes(layout(), block.count, block.upper_bits)) +
+                       column_plane_bytes(layout(), block.count, block.lower_bits);
+                valid = !(block.offset & 63) && (block.upper_bits <= 64) && (block.lower_bits <= 64);
+            }
+            valid = valid && inside && (size <= room) &&
+                    (block.count > 0) && (block.count <= header -> block_size) &&
+                    ((block.count == header -> block_size) || (b + 1 == header -> blocks));
+            total += block.count;
+        }
+        valid = valid && (total == header -> count);
+    }
+
+    if (!valid){
+        #if defined(UINT128_T_COLUMN_MMAP)
+            ::munmap(const_cast <unsigned char *> (bytes), length);
+        #endif
+        throw std::runtime_error("Error: " + path + " is not a uint128_t column file");
+    }
+}
+
+UINT128_T_INLINE uint128_column_reader::~uint128_column_reader(){
+    #if defined(UINT128_T_COLUMN_MMAP)
+        if (mapped && bytes){
+            ::munmap(const_cast <unsigned char *> (bytes), length);
+        }
+    #endif
+    bytes = nullptr;
+    mapped = false;
+}
+
+UINT128_T_INLINE const uint64_t * uint128_column_reader::plane(const uint128_column_block & block, const unsigned which) const{
+    uint64_t at = block.offset;
+    if (which){
+        at = column_round_up(at + column_plane_bytes(layout(), block.count, block.upper_bits));
+    }
+    return reinterpret_cast <const uint64_t *> (bytes + at);
+}
+
+UINT128_T_INLINE std::size_t uint128_column_reader::size() const{
+    return (std::size_t) header -> count;
+}
+
+UINT128_T_INLINE std::size_t uint128_column_reader::blocks() const{
+    return header -> blocks;
+}
+
+UINT128_T_INLINE std::size_t uint128_column_reader::block_size() const{
+    return header -> block_size;
+}
+
+UINT128_T_INLINE uint128_column_layout uint128_column_reader::layout() const{
+    return (uint128_column_layout) header -> layout;
+}
+
+UINT128_T_INLINE bool uint128_column_reader::has_stats() const{
+    return header -> flags & uint128_column_header::STATS;
+}
+
+UINT128_T_INLINE const uint128_column_block & uint128_column_reader::block_info(const std::size_t b) const{
+    if (b >= blocks()){
+        throw std::out_of_range("Error: column block index out of range");
+    }
+    return directory[b];
+}
+
+UINT128_T_INLINE uint128_t uint128_column_reader::block_min(const std::size_t b) const{
+    const uint128_column_block & block = block_info(b);
+    return uint128_t(block.min_upper, block.min_lower);
+}
+
+UINT128_T_INLINE uint128_t uint128_column_reader::block_max(const std::size_t b) const{
+    const uint128_column_block & block = block_info(b);
+    return uint128_t(block.max_upper, block.max_lower);
+}
+
+UINT128_T_INLINE uint128_soa uint128_column_reader::block(const std::size_t b) const{
+    if (layout() != uint128_column_layout::planes){
+        throw std::logic_error("Error: only plane columns can be viewed as uint128_soa");
+    }
+    const uint128_column_block & info = block_info(b);
+    const uint128_soa soa = {plane(info, 0), plane(info, 1), info.count};
+    return soa;
+}
+
+UINT128_T_INLINE const uint128_t * uint128_column_reader::data() const{
+    const bool upper_first = header -> flags & uint128_column_header::UPPER_FIRST;
+    if ((layout() != uint128_column_layout::interleaved) || (upper_first != column_upper_first())){
+        return nullptr;
+    }
+    return header -> blocks ? reinterpret_cast <const uint128_t *> (bytes + directory[0].offset) : nullptr;
+}
+
+UINT128_T_INLINE uint128_t uint128_column_reader::operator[](const std::size_t i) const{
+    uint64_t hi, lo;
+    read(i, 1, &hi, &lo);
+    return uint128_t(hi, lo);
+}
+
+UINT128_T_INLINE void uint128_column_reader::read(const std::size_t first, const std::size_t n, uint64_t * hi, uint64_t * lo) const{
+    if ((first > size()) || (n > size() - first)){
+        throw std::out_of_range("Error: column read past the end");
+    }
+
+    const bool upper_first = header -> flags & uint128_column_header::UPPER_FIRST;
+    std::size_t b = first / block_size();
+    std::size_t at = first % block_size();
+    for(std::size_t done = 0; done < n; b++, at = 0){
+        const uint128_column_block & block = directory[b];
+        const std::size_t take = std::min <std::size_t> (n - done, block.count - at);
+        switch (layout()){
+            case uint128_column_layout::planes:
+                std::memcpy(hi + done, plane(block, 0) + at, take * sizeof(uint64_t));
+                std::memcpy(lo + done, plane(block, 1) + at, take * sizeof(uint64_t));
+                break;
+            case uint128_column_layout::interleaved:{
+                const uint64_t * words = reinterpret_cast <const uint64_t *> (bytes + block.offset) + 2 * at;
+                for(std::size_t i = 0; i < take; i++){
+                    hi[done + i] = words[2 * i + !upper_first];
+                    lo[done + i] = words[2 * i + upper_first];
+                }
+                break;
+            }
+            case uint128_column_layout::packed:
+                column_unpack(plane(block, 0), block.upper_bits, block.upper_base, at, take, hi + done);
+                column_unpack(plane(block, 1), block.lower_bits, block.lower_base, at, take, lo + done);
+                break;
+        }
+        done += take;
+    }
+}
+
+UINT128_T_INLINE void uint128_column_reader::read(const std::size_t first, const std::size_t n, uint128_t * out) const{
+    if ((first > size()) || (n > size() - first)){
+        throw std::out_of_range("Error: column read past the end");
+    }
+
+    // through small limb buffers that stay in L1
+    const std::size_t CHUNK = 512;
+    uint64_t hi[CHUNK], lo[CHUNK];
+    for(std::size_t done = 0; done < n; ){
+        const std::size_t take = std::min(CHUNK, n - done);
+        read(first + done, take, hi, lo);
+        for(std::size_t i = 0; i < take; i++){
+            out[done + i] = uint128_t(hi[i], lo[i]);
+        }
+        done += take;
+    }
+}
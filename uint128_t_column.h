@@ -0,0 +1,172 @@
+// PUBLIC IMPORT HEADER
+// Columnar files of uint128_t values
+//
+// Values are written in blocks of up to block_size values, each block in one
+// of three layouts:
+//
+//     planes       the upper words of the block, then the lower words
+//     interleaved  uint128_t records exactly as they are laid out in memory
+//     packed       each plane as its minimum plus the differences bit packed
+//                  at the width of the largest one (frame of reference)
+//
+// Each block can also record the minimum and maximum value it holds, so
+// readers can skip blocks that cannot match. A directory of the blocks
+// follows the last one, and the header at the start says where it is.
+//
+//     header                 64 bytes, see uint128_column_header
+//     block 0 ... block n-1  each plane starting on a 64 byte boundary
+//                            (interleaved blocks follow each other directly)
+//     directory              one uint128_column_block per block
+//
+// Files are written in the byte order of the host and rejected by hosts with
+// another byte order.
+//
+// uint128_column_reader maps the file into memory (on POSIX systems;
+// elsewhere the file is read in full). Plane blocks are handed out as
+// uint128_soa columns and interleaved files as a const uint128_t array, both
+// pointing into the mapping. Any layout can be decoded with read().
+#ifndef _UINT128_T_COLUMN_H_
+#define _UINT128_T_COLUMN_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "uint128_t.h"
+
+// two parallel columns of limbs
+struct uint128_soa{
+    const uint64_t * upper;
+    const uint64_t * lower;
+    std::size_t size;
+
+    uint128_t operator[](const std::size_t i) const{
+        return uint128_t(upper[i], lower[i]);
+    }
+};
+
+enum class uint128_column_layout : uint8_t {
+    planes      = 0,
+    interleaved = 1,
+    packed      = 2,
+};
+
+struct uint128_column_header{
+    static constexpr uint64_t ORDER_MARK = 0x0102030405060708ULL;
+
+    enum flag : uint8_t {
+        STATS       = 1,    // blocks record their minimum and maximum
+        UPPER_FIRST = 2,    // interleaved records hold the upper limb first
+    };
+
+    char magic[8];          // "U128COL1"
+    uint64_t byte_order;    // ORDER_MARK as written by the host
+    uint64_t count;         // values in the file
+    uint64_t directory;     // offset of the block directory
+    uint32_t blocks;
+    uint32_t block_size;    // values per block; the last one may hold fewer
+    uint8_t layout;         // uint128_column_layout
+    uint8_t flags;
+    uint8_t reserved[22];
+};
+
+struct uint128_column_block{
+    uint64_t offset;        // of the first plane
+    uint64_t upper_base;    // packed: the minimum of each plane
+    uint64_t lower_base;
+    uint64_t min_upper;     // with STATS: smallest and largest value
+    uint64_t min_lower;
+    uint64_t max_upper;
+    uint64_t max_lower;
+    uint32_t count;
+    uint8_t upper_bits;     // packed: bits per value in each plane
+    uint8_t lower_bits;
+    uint8_t reserved[2];
+};
+
+// Streams values into a new file. Nothing is readable until close(), which
+// the destructor calls if it has not been (ignoring errors there). I/O
+// errors throw std::runtime_error.
+class UINT128_T_EXTERN uint128_column_writer{
+    private:
+        std::FILE * file;
+        uint128_column_layout layout;
+        uint32_t block_size;
+        bool stats;
+        uint64_t count;
+        uint64_t offset;
+        std::vector <uint64_t> upper, lower;    // the block being filled
+        std::vector <uint64_t> packed;
+        std::vector <uint128_column_block> directory;
+
+        void write_bytes(const void * data, const std::size_t size);
+        void align();
+        void write_plane(const std::vector <uint64_t> & plane, const std::size_t n, uint64_t & base, uint8_t & bits);
+        void flush();
+
+    public:
+        explicit uint128_column_writer(const std::string & path,
+                                       const uint128_column_layout layout = uint128_column_layout::planes,
+                                       const std::size_t block_size = 65536,
+                                       const bool stats = true);
+        ~uint128_column_writer();
+
+        uint128_column_writer(const uint128_column_writer &) = delete;
+        uint128_column_writer & operator=(const uint128_column_writer &) = delete;
+
+        void write(const uint128_t & value);
+        void write(const uint128_t * values, const std::size_t n);
+        void write(const uint64_t * upper, const uint64_t * lower, const std::size_t n);
+
+        void close();
+};
+
+// Opens a column file read only; throws std::runtime_error if it cannot be
+// opened or is not a valid file
+class UINT128_T_EXTERN uint128_column_reader{
+    private:
+        const unsigned char * bytes;
+        std::size_t length;
+        bool mapped;
+        std::vector <uint64_t> copy;            // the file when it is not mapped
+        const uint128_column_header * header;
+        const uint128_column_block * directory;
+
+        const uint64_t * plane(const uint128_column_block & block, const unsigned which) const;
+
+    public:
+        explicit uint128_column_reader(const std::string & path);
+        ~uint128_column_reader();
+
+        uint128_column_reader(const uint128_column_reader &) = delete;
+        uint128_column_reader & operator=(const uint128_column_reader &) = delete;
+
+        std::size_t size() const;
+        std::size_t blocks() const;
+        std::size_t block_size() const;
+        uint128_column_layout layout() const;
+        bool has_stats() const;
+
+        const uint128_column_block & block_info(const std::size_t b) const;
+        uint128_t block_min(const std::size_t b) const;
+        uint128_t block_max(const std::size_t b) const;
+
+        // planes layout: the limbs of block b, in place; throws std::logic_error otherwise
+        uint128_soa block(const std::size_t b) const;
+
+        // interleaved layout written by a host with the same uint128_t layout:
+        // all values in place; nullptr otherwise
+        const uint128_t * data() const;
+
+        // any layout; throw std::out_of_range past the end
+        uint128_t operator[](const std::size_t i) const;
+        void read(const std::size_t first, const std::size_t n, uint128_t * out) const;
+        void read(const std::size_t first, const std::size_t n, uint64_t * upper, uint64_t * lower) const;
+};
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_column.cpp"
+#endif
+
+#endif
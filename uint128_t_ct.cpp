@@ -0,0 +1,61 @@
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_ct.h"
+
+// Halves the range holding the top set bit six times, on a mask each time
+UINT128_T_INLINE uint8_t ct::bits(const uint128_t & v){
+    using namespace uint128_ct_detail;
+    const mask high = to_mask(nonzero(v.upper()));
+    uint64_t w = choose(high, v.upper(), v.lower());
+    uint64_t n = high & 64;
+    for(unsigned k = 32; k; k >>= 1){
+        const mask m = to_mask(nonzero(w >> k));
+        w = choose(m, w >> k, w);
+        n += m & k;
+    }
+    // w is 0 or 1 here
+    return (uint8_t) (n + w);
+}
+
+// Restoring division: one bit of the quotient per step, for all 128 bits, with
+// the subtraction kept or dropped by a mask
+UINT128_T_INLINE void ct::divmod(const uint128_t & a, const uint128_t & b, uint128_t & quotient, uint128_t & remainder){
+    using namespace uint128_ct_detail;
+    if (!(b.upper() | b.lower())){
+        throw std::domain_error("Error: division or modulus by 0");
+    }
+
+    uint64_t a_hi = a.upper(), a_lo = a.lower();
+    uint64_t q_hi = 0, q_lo = 0, r_hi = 0, r_lo = 0;
+    for(unsigned i = 0; i < 128; i++){
+        // r = 2r + the next bit of a; the bit pushed out of r is kept in top
+        const uint64_t top = r_hi >> 63;
+        r_hi = (r_hi << 1) | (r_lo >> 63);
+        r_lo = (r_lo << 1) | (a_hi >> 63);
+        a_hi = (a_hi << 1) | (a_lo >> 63);
+        a_lo <<= 1;
+
+        // subtract b if r (with top) is at least b
+        uint64_t d_hi, d_lo;
+        const mask take = to_mask(top | (sub(r_hi, r_lo, b.upper(), b.lower(), d_hi, d_lo) ^ 1));
+        r_hi = choose(take, d_hi, r_hi);
+        r_lo = choose(take, d_lo, r_lo);
+        q_hi = (q_hi << 1) | (q_lo >> 63);
+        q_lo = (q_lo << 1) | (take & 1);
+    }
+    quotient = uint128_t(q_hi, q_lo);
+    remainder = uint128_t(r_hi, r_lo);
+}
+
+UINT128_T_INLINE uint128_t ct::div(const uint128_t & a, const uint128_t & b){
+    uint128_t q, r;
+    divmod(a, b, q, r);
+    return q;
+}
+
+UINT128_T_INLINE uint128_t ct::mod(const uint128_t & a, const uint128_t & b){
+    uint128_t q, r;
+    divmod(a, b, q, r);
+    return r;
+}
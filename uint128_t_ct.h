@@ -0,0 +1,150 @@
+// PUBLIC IMPORT HEADER
+// Constant time operations, for code whose timing must not depend on the
+// values it handles (keys, nonces, anything signed or compared in secret)
+//
+//     ct::eq(a, b), ct::ne, ct::lt, ct::le, ct::gt, ct::ge, ct::is_zero(a)
+//                                        - all ones if true, 0 if false
+//     ct::select(m, a, b)                - a if m is all ones, b if it is 0
+//     ct::cswap(m, a, b)                 - swaps a and b if m is all ones
+//     ct::shl(v, s), ct::shr(v, s)       - shifts by a secret amount; 128 and up give 0
+//     ct::rotl(v, s), ct::rotr(v, s)     - rotations by s mod 128
+//     ct::bits(v)                        - significant bits, like v.bits()
+//     ct::divmod(a, b, q, r)             - quotient and remainder in 128 fixed steps
+//     ct::div(a, b), ct::mod(a, b)
+//
+// None of these branch on their arguments or use them to index memory.
+// Comparisons come from the borrow of a subtraction, choices are made with
+// masks, and masks pass through an empty asm statement so that the optimizer
+// cannot turn them back into branches. Division by 0 still throws
+// std::domain_error, so whether the divisor is 0 is not hidden.
+//
+// +, -, *, &, |, ^ and ~ are branch free on uint128_t already, and so are the
+// shifts when the amount is public. Comparisons, /, %, bits() and shifts by
+// secret amounts are not, and should be replaced by the functions here. Whether
+// the hardware multiplies and shifts in constant time is up to the CPU.
+#ifndef _UINT128_T_CT_H_
+#define _UINT128_T_CT_H_
+
+#include "uint128_t.h"
+
+namespace uint128_ct_detail {
+    // x, hidden from the optimizer so that masks made from it stay masks
+    inline uint64_t opaque(uint64_t x){
+        #if defined(__GNUC__)
+            __asm__("" : "+r"(x));
+            return x;
+        #else
+            const volatile uint64_t hidden = x;
+            return hidden;
+        #endif
+    }
+
+    // all ones if the low bit of b is set, else 0
+    inline uint64_t to_mask(const uint64_t b){
+        return 0 - opaque(b & 1);
+    }
+
+    // 1 if x is not 0
+    inline uint64_t nonzero(const uint64_t x){
+        return (x | (0 - x)) >> 63;
+    }
+
+    // a if m is all ones, b if it is 0
+    inline uint64_t choose(const uint64_t m, const uint64_t a, const uint64_t b){
+        return b ^ (m & (a ^ b));
+    }
+
+    // hi:lo = a - b; returns the borrow out of the top
+    inline uint64_t sub(const uint64_t a_hi, const uint64_t a_lo, const uint64_t b_hi, const uint64_t b_lo,
+                        uint64_t & hi, uint64_t & lo){
+        lo = a_lo - b_lo;
+        const uint64_t borrow = ((~a_lo & b_lo) | (~(a_lo ^ b_lo) & lo)) >> 63;
+        hi = a_hi - b_hi - borrow;
+        return ((~a_hi & b_hi) | (~(a_hi ^ b_hi) & hi)) >> 63;
+    }
+}
+
+namespace ct {
+    // all ones for true, 0 for false
+    typedef uint64_t mask;
+
+    inline mask is_zero(const uint128_t & a){
+        return uint128_ct_detail::to_mask(uint128_ct_detail::nonzero(a.upper() | a.lower()) ^ 1);
+    }
+
+    inline mask eq(const uint128_t & a, const uint128_t & b){
+        return is_zero(uint128_t(a.upper() ^ b.upper(), a.lower() ^ b.lower()));
+    }
+
+    inline mask ne(const uint128_t & a, const uint128_t & b){
+        return ~eq(a, b);
+    }
+
+    inline mask lt(const uint128_t & a, const uint128_t & b){
+        uint64_t hi, lo;
+        return uint128_ct_detail::to_mask(uint128_ct_detail::sub(a.upper(), a.lower(), b.upper(), b.lower(), hi, lo));
+    }
+
+    inline mask gt(const uint128_t & a, const uint128_t & b){
+        return lt(b, a);
+    }
+
+    inline mask le(const uint128_t & a, const uint128_t & b){
+        return ~lt(b, a);
+    }
+
+    inline mask ge(const uint128_t & a, const uint128_t & b){
+        return ~lt(a, b);
+    }
+
+    inline uint128_t select(const mask m, const uint128_t & a, const uint128_t & b){
+        return uint128_t(uint128_ct_detail::choose(m, a.upper(), b.upper()),
+                         uint128_ct_detail::choose(m, a.lower(), b.lower()));
+    }
+
+    inline void cswap(const mask m, uint128_t & a, uint128_t & b){
+        const uint128_t d(m & (a.upper() ^ b.upper()), m & (a.lower() ^ b.lower()));
+        a = uint128_t(a.upper() ^ d.upper(), a.lower() ^ d.lower());
+        b = uint128_t(b.upper() ^ d.upper(), b.lower() ^ d.lower());
+    }
+
+    inline uint128_t shl(const uint128_t & v, const uint64_t s){
+        const unsigned t = (unsigned) (s & 63);
+        const uint64_t up = (v.upper() << t) | ((v.lower() >> 1) >> (63 - t));
+        const uint64_t bottom = v.lower() << t;
+        const mask whole = uint128_ct_detail::to_mask(s >> 6);
+        const mask keep = ~uint128_ct_detail::to_mask(uint128_ct_detail::nonzero(s >> 7));
+        return uint128_t(uint128_ct_detail::choose(whole, bottom, up) & keep, bottom & ~whole & keep);
+    }
+
+    inline uint128_t shr(const uint128_t & v, const uint64_t s){
+        const unsigned t = (unsigned) (s & 63);
+        const uint64_t down = (v.lower() >> t) | ((v.upper() << 1) << (63 - t));
+        const uint64_t top = v.upper() >> t;
+        const mask whole = uint128_ct_detail::to_mask(s >> 6);
+        const mask keep = ~uint128_ct_detail::to_mask(uint128_ct_detail::nonzero(s >> 7));
+        return uint128_t(top & ~whole & keep, uint128_ct_detail::choose(whole, top, down) & keep);
+    }
+
+    inline uint128_t rotl(const uint128_t & v, const uint64_t s){
+        const uint128_t l = shl(v, s & 127), r = shr(v, (128 - (s & 127)) & 127);
+        return uint128_t(l.upper() | r.upper(), l.lower() | r.lower());
+    }
+
+    inline uint128_t rotr(const uint128_t & v, const uint64_t s){
+        return rotl(v, (128 - (s & 127)) & 127);
+    }
+
+    UINT128_T_EXTERN uint8_t bits(const uint128_t & v);
+
+    // b must not be 0
+    UINT128_T_EXTERN void divmod(const uint128_t & a, const uint128_t & b, uint128_t & quotient, uint128_t & remainder);
+    UINT128_T_EXTERN uint128_t div(const uint128_t & a, const uint128_t & b);
+    UINT128_T_EXTERN uint128_t mod(const uint128_t & a, const uint128_t & b);
+}
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_ct.cpp"
+#endif
+
+#endif
@@ -0,0 +1,359 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_intrinsics.include"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+  #define UINT128_T_X86_KERNELS
+  #include <cpuid.h>
+  #include <immintrin.h>
+#endif
+
+// Everything below that the kernels and the dispatch functions refer to has
+// external linkage (class template members, or functions that are inline in
+// header-only builds), so that every translation unit of a header-only build
+// shares one copy of it
+
+// largest power of each base that fits in 64 bits and its number of digits
+struct uint128_chunk{
+    uint64_t power;
+    unsigned digits;
+};
+
+// constants shared by every kernel variant
+template <typename Unused = void>
+struct uint128_kernel_constants{
+    // 10^19, the largest power of 10 that fits in 64 bits
+    static constexpr uint64_t CHUNK_10 = 10000000000000000000ULL;
+
+    static constexpr uint128_chunk chunk_for(const uint64_t base, const uint64_t power = 1, const unsigned digits = 0){
+        return (power > ~0ULL / base) ? uint128_chunk{power, digits} : chunk_for(base, power * base, digits + 1);
+    }
+
+    static constexpr uint128_chunk CHUNKS[17] = {
+        {0, 0}, {0, 0},
+        chunk_for( 2), chunk_for( 3), chunk_for( 4), chunk_for( 5), chunk_for( 6), chunk_for( 7), chunk_for( 8),
+        chunk_for( 9), chunk_for(10), chunk_for(11), chunk_for(12), chunk_for(13), chunk_for(14), chunk_for(15),
+        chunk_for(16),
+    };
+};
+
+template <typename Unused> constexpr uint64_t uint128_kernel_constants <Unused>::CHUNK_10;
+template <typename Unused> constexpr uint128_chunk uint128_kernel_constants <Unused>::CHUNKS[17];
+
+#define UINT128_T_KERNEL_NS     uint128_kernels_generic
+#define UINT128_T_KERNEL_LEVEL  0
+#define UINT128_T_KERNEL_TARGET
+#include "uint128_t_kernels.include"
+#undef UINT128_T_KERNEL_NS
+#undef UINT128_T_KERNEL_LEVEL
+#undef UINT128_T_KERNEL_TARGET
+
+#if defined(UINT128_T_X86_KERNELS)
+  #define UINT128_T_KERNEL_NS     uint128_kernels_bmi2
+  #define UINT128_T_KERNEL_LEVEL  1
+  #define UINT128_T_KERNEL_TARGET __attribute__((target("bmi,bmi2,adx,lzcnt,popcnt,pclmul,ssse3")))
+  #include "uint128_t_kernels.include"
+  #undef UINT128_T_KERNEL_NS
+  #undef UINT128_T_KERNEL_LEVEL
+  #undef UINT128_T_KERNEL_TARGET
+
+  #define UINT128_T_KERNEL_NS     uint128_kernels_avx2
+  #define UINT128_T_KERNEL_LEVEL  2
+  #define UINT128_T_KERNEL_TARGET __attribute__((target("bmi,bmi2,adx,lzcnt,popcnt,pclmul,ssse3,avx2")))
+  #include "uint128_t_kernels.include"
+  #undef UINT128_T_KERNEL_NS
+  #undef UINT128_T_KERNEL_LEVEL
+  #undef UINT128_T_KERNEL_TARGET
+
+  // GCC reports the deliberately undefined pass-through operand inside the
+  // AVX-512 unpack intrinsics as maybe-uninitialized
+  #if !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+  #endif
+  #define UINT128_T_KERNEL_NS     uint128_kernels_avx512
+  #define UINT128_T_KERNEL_LEVEL  3
+  #define UINT128_T_KERNEL_TARGET __attribute__((target("bmi,bmi2,adx,lzcnt,popcnt,pclmul,ssse3,avx2,avx512f,avx512dq,avx512bw,avx512vl")))
+  #include "uint128_t_kernels.include"
+  #undef UINT128_T_KERNEL_NS
+  #undef UINT128_T_KERNEL_LEVEL
+  #undef UINT128_T_KERNEL_TARGET
+  #if !defined(__clang__)
+    #pragma GCC diagnostic pop
+  #endif
+#endif
+
+namespace uint128_dispatch_detail {
+
+    UINT128_T_INLINE uint128_isa detect_isa(){
+        #if defined(UINT128_T_X86_KERNELS)
+            unsigned eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)){
+                return uint128_isa::generic;
+            }
+            const bool osxsave = ecx & (1U << 27);
+            const bool pclmul  = ecx & (1U << 1);
+            const bool ssse3   = ecx & (1U << 9);
+            const bool popcnt  = ecx & (1U << 23);
+
+            unsigned ext_ecx = 0;
+            if (__get_cpuid(0x80000001, &eax, &ebx, &ext_ecx, &edx)){
+                ext_ecx &= (1U << 5);   // LZCNT
+            }
+
+            if (__get_cpuid_max(0, nullptr) < 7){
+                return uint128_isa::generic;
+            }
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            const bool bmi1     = ebx & (1U <<  3);
+            const bool avx2     = ebx & (1U <<  5);
+            const bool bmi2     = ebx & (1U <<  8);
+            const bool avx512f  = ebx & (1U << 16);
+            const bool avx512dq = ebx & (1U << 17);
+            const bool adx      = ebx & (1U << 19);
+            const bool avx512bw = ebx & (1U << 30);
+            const bool avx512vl = ebx & (1U << 31);
+
+            if (!(bmi1 && bmi2 && adx && ext_ecx && popcnt && pclmul && ssse3)){
+                return uint128_isa::generic;
+            }
+
+            // the OS has to save the vector registers too
+            uint64_t xcr0 = 0;
+            if (osxsave){
+                unsigned lo, hi;
+                __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                xcr0 = ((uint64_t) hi << 32) | lo;
+            }
+            const bool ymm_state = (xcr0 & 0x06) == 0x06;
+            const bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+            if (avx2 && ymm_state){
+                if (avx512f && avx512dq && avx512bw && avx512vl && zmm_state){
+                    return uint128_isa::avx512;
+                }
+                return uint128_isa::avx2;
+            }
+            return uint128_isa::bmi2;
+        #else
+            return uint128_isa::generic;
+        #endif
+    }
+
+    UINT128_T_INLINE const uint128_kernels * table_for(const uint128_isa isa){
+        switch (isa){
+            #if defined(UINT128_T_X86_KERNELS)
+            case uint128_isa::avx512:
+                return &uint128_kernels_avx512 <>::TABLE;
+            case uint128_isa::avx2:
+                return &uint128_kernels_avx2 <>::TABLE;
+            case uint128_isa::bmi2:
+                return &uint128_kernels_bmi2 <>::TABLE;
+            #endif
+            default:
+                return &uint128_kernels_generic <>::TABLE;
+        }
+    }
+
+    // the level used when nothing was forced: the CPU's best, unless UINT128_T_ISA says otherwise
+    UINT128_T_INLINE uint128_isa startup_isa(){
+        uint128_isa isa = uint128_detected_isa();
+        if (const char * env = std::getenv("UINT128_T_ISA")){
+            try{
+                const uint128_isa forced = uint128_isa_from_name(env);
+                if (forced < isa){
+                    isa = forced;
+                }
+            }
+            catch (const std::invalid_argument &){
+                // unknown names are ignored, keep the detected level
+            }
+        }
+        return isa;
+    }
+
+}
+
+// Until the first call the table points at these stubs, which select the
+// real table and forward to it. This keeps uint128_t usable from other
+// static initializers, whatever order they run in.
+template <typename Unused = void>
+struct uint128_kernels_resolve{
+    static const uint128_kernels & select(){
+        uint128_set_isa(uint128_dispatch_detail::startup_isa());
+        return uint128_active_kernels();
+    }
+
+    static uint128_t mul(const uint128_t & lhs, const uint128_t & rhs){
+        return select().mul(lhs, rhs);
+    }
+
+    static void divmod(const uint128_t & lhs, const uint128_t & rhs, uint128_t & quotient, uint128_t & remainder){
+        select().divmod(lhs, rhs, quotient, remainder);
+    }
+
+    static uint8_t bits(const uint128_t & value){
+        return select().bits(value);
+    }
+
+    static std::size_t format(const uint128_t & value, uint8_t base, char * out){
+        return select().format(value, base, out);
+    }
+
+    static void mul_n(const uint128_t * lhs, const uint128_t * rhs, uint128_t * out, std::size_t count){
+        select().mul_n(lhs, rhs, out, count);
+    }
+
+    static void dot(const uint64_t * a, const uint64_t * b, std::size_t n, uint64_t out[3]){
+        select().dot(a, b, n, out);
+    }
+
+    static void uuid_format_n(const uint128_t * values, std::size_t count, char * out, std::size_t stride){
+        select().uuid_format_n(values, count, out, stride);
+    }
+
+    static std::size_t uuid_parse_n(const char * in, std::size_t stride, std::size_t count, uint128_t * out){
+        return select().uuid_parse_n(in, stride, count, out);
+    }
+
+    static void unpack_n(const uint64_t * words, unsigned bits, uint64_t base, std::size_t first, std::size_t count, uint64_t * out){
+        select().unpack_n(words, bits, base, first, count, out);
+    }
+
+    static void clmul(const uint128_t & a, const uint128_t & b, uint64_t out[4]){
+        select().clmul(a, b, out);
+    }
+
+    static uint128_t gf2_mul(const uint128_t & a, const uint128_t & b){
+        return select().gf2_mul(a, b);
+    }
+
+    static void ghash_n(const uint128_t & h, uint128_t & acc, const unsigned char * data, std::size_t blocks){
+        select().ghash_n(h, acc, data, blocks);
+    }
+
+    static uint128_t pdep(const uint128_t & src, const uint128_t & mask){
+        return select().pdep(src, mask);
+    }
+
+    static uint128_t pext(const uint128_t & src, const uint128_t & mask){
+        return select().pext(src, mask);
+    }
+
+    static void morton_encode_n(const uint64_t * x, const uint64_t * y, std::size_t count, uint128_t * out){
+        select().morton_encode_n(x, y, count, out);
+    }
+
+    static void morton_decode_n(const uint128_t * keys, std::size_t count, uint64_t * x, uint64_t * y){
+        select().morton_decode_n(keys, count, x, y);
+    }
+
+    static std::size_t parse_lines(const char * in, std::size_t len, uint8_t base, uint128_t * out){
+        return select().parse_lines(in, len, base, out);
+    }
+
+    static std::size_t format_lines(const uint128_t * values, std::size_t count, uint8_t base, char * out){
+        return select().format_lines(values, count, base, out);
+    }
+
+    static const uint128_kernels TABLE;
+};
+
+template <typename Unused>
+const uint128_kernels uint128_kernels_resolve <Unused>::TABLE = {
+    uint128_isa::generic,
+    mul,
+    divmod,
+    bits,
+    format,
+    mul_n,
+    dot,
+    uuid_format_n,
+    uuid_parse_n,
+    unpack_n,
+    clmul,
+    gf2_mul,
+    ghash_n,
+    pdep,
+    pext,
+    morton_encode_n,
+    morton_decode_n,
+    parse_lines,
+    format_lines,
+};
+
+#if defined(UINT128_T_HEADER_ONLY)
+template <typename T>
+std::atomic <const uint128_kernels *> uint128_dispatch_slot <T>::table(&uint128_kernels_resolve <>::TABLE);
+#else
+std::atomic <const uint128_kernels *> uint128_dispatch(&uint128_kernels_resolve <>::TABLE);
+
+// pick the table at load time so the first call does not pay for it; a
+// header-only build has no single unit to do this from, and selects on the
+// first call instead
+static const struct uint128_dispatch_init{
+    uint128_dispatch_init(){
+        if (UINT128_T_DISPATCH.load() == &uint128_kernels_resolve <>::TABLE){
+            uint128_set_isa(uint128_dispatch_detail::startup_isa());
+        }
+    }
+} uint128_dispatch_init_instance;
+#endif
+
+UINT128_T_INLINE const uint128_kernels * uint128_kernels_for(const uint128_isa isa){
+    if (isa > uint128_detected_isa()){
+        return nullptr;
+    }
+    const uint128_kernels * table = uint128_dispatch_detail::table_for(isa);
+    return (table -> isa == isa) ? table : nullptr;
+}
+
+UINT128_T_INLINE uint128_isa uint128_detected_isa(){
+    static const uint128_isa detected = uint128_dispatch_detail::detect_isa();
+    return detected;
+}
+
+UINT128_T_INLINE uint128_isa uint128_active_isa(){
+    const uint128_kernels * table = UINT128_T_DISPATCH.load();
+    if (table == &uint128_kernels_resolve <>::TABLE){
+        table = &uint128_kernels_resolve <>::select();
+    }
+    return table -> isa;
+}
+
+UINT128_T_INLINE uint128_isa uint128_set_isa(const uint128_isa isa){
+    const uint128_isa detected = uint128_detected_isa();
+    const uint128_kernels * table = uint128_dispatch_detail::table_for((isa < detected) ? isa : detected);
+    UINT128_T_DISPATCH.store(table);
+    return table -> isa;
+}
+
+UINT128_T_INLINE const char * uint128_isa_name(const uint128_isa isa){
+    switch (isa){
+        case uint128_isa::generic:
+            return "generic";
+        case uint128_isa::bmi2:
+            return "bmi2";
+        case uint128_isa::avx2:
+            return "avx2";
+        case uint128_isa::avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+UINT128_T_INLINE uint128_isa uint128_isa_from_name(const std::string & name){
+    for(const uint128_isa isa : {uint128_isa::generic, uint128_isa::bmi2, uint128_isa::avx2, uint128_isa::avx512}){
+        if (name == uint128_isa_name(isa)){
+            return isa;
+        }
+    }
+    throw std::invalid_argument("Error: unknown instruction set level \"" + name + "\"");
+}
+
+UINT128_T_INLINE void multiply(const uint128_t * lhs, const uint128_t * rhs, uint128_t * out, std::size_t count){
+    uint128_active_kernels().mul_n(lhs, rhs, out, count);
+}
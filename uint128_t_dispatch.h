@@ -0,0 +1,134 @@
+// PUBLIC IMPORT HEADER
+// Runtime selection of the uint128_t hot kernels
+//
+// Every hot path (multiply, divmod, bit counting, formatting and the batch
+// kernels) goes through a table of function pointers. The table is picked
+// once, at startup, from the best instruction set the CPU supports:
+//
+//     generic - portable C++, no intrinsics
+//     bmi2    - MULX, ADCX/ADOX, LZCNT, PDEP/PEXT, PCLMULQDQ and DIV based
+//               128/64 division
+//     avx2    - bmi2 plus 4-wide batch kernels
+//     avx512  - bmi2 plus 8-wide batch kernels (AVX-512 F/DQ/BW/VL)
+//
+// Setting the environment variable UINT128_T_ISA to one of the names above
+// forces that level (it is lowered to what the CPU supports), which is useful
+// for benchmarking and for testing every variant on one machine.
+#ifndef _UINT128_T_DISPATCH_H_
+#define _UINT128_T_DISPATCH_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "uint128_t.h"
+
+enum class uint128_isa : uint8_t {
+    generic = 0,
+    bmi2    = 1,
+    avx2    = 2,
+    avx512  = 3,
+};
+
+struct uint128_kernels{
+    uint128_isa isa;
+
+    // lhs * rhs, lower 128 bits
+    uint128_t (*mul)(const uint128_t & lhs, const uint128_t & rhs);
+
+    // rhs must not be 0
+    void (*divmod)(const uint128_t & lhs, const uint128_t & rhs, uint128_t & quotient, uint128_t & remainder);
+
+    uint8_t (*bits)(const uint128_t & value);
+
+    // writes the digits of value in base [2, 16] to out (at least 128 chars,
+    // not null terminated) and returns how many were written
+    std::size_t (*format)(const uint128_t & value, uint8_t base, char * out);
+
+    // out[i] = lhs[i] * rhs[i]
+    void (*mul_n)(const uint128_t * lhs, const uint128_t * rhs, uint128_t * out, std::size_t count);
+
+    // sum of a[i] * b[i] as a 192 bit value, most significant limb first
+    void (*dot)(const uint64_t * a, const uint64_t * b, std::size_t n, uint64_t out[3]);
+
+    // writes values[i] as 8-4-4-4-12 lowercase hex to out + i * stride
+    void (*uuid_format_n)(const uint128_t * values, std::size_t count, char * out, std::size_t stride);
+
+    // reads count 36 character UUIDs stride bytes apart, either case; returns
+    // how many leading ones were valid
+    std::size_t (*uuid_parse_n)(const char * in, std::size_t stride, std::size_t count, uint128_t * out);
+
+    // out[i] = base + value first + i of an array packed bits (0 to 64) wide,
+    // lowest bits first; words must be readable one word past the last value
+    void (*unpack_n)(const uint64_t * words, unsigned bits, uint64_t base, std::size_t first, std::size_t count, uint64_t * out);
+
+    // carry-less product, most significant limb first
+    void (*clmul)(const uint128_t & a, const uint128_t & b, uint64_t out[4]);
+
+    // product in GF(2^128), in GCM's bit order (see uint128_t_gf2.h)
+    uint128_t (*gf2_mul)(const uint128_t & a, const uint128_t & b);
+
+    // acc = (acc + block) * h for each 16 byte block, read big endian (GHASH)
+    void (*ghash_n)(const uint128_t & h, uint128_t & acc, const unsigned char * data, std::size_t blocks);
+
+    // bit scatter and gather over 128 bits, as PDEP and PEXT (see uint128_t_bits.h)
+    uint128_t (*pdep)(const uint128_t & src, const uint128_t & mask);
+    uint128_t (*pext)(const uint128_t & src, const uint128_t & mask);
+
+    // Z-order keys: bit i of x[i] goes to bit 2i of out[i], bit i of y[i] to bit 2i + 1
+    void (*morton_encode_n)(const uint64_t * x, const uint64_t * y, std::size_t count, uint128_t * out);
+    void (*morton_decode_n)(const uint128_t * keys, std::size_t count, uint64_t * x, uint64_t * y);
+
+    // Reads one number per line in base 10 or 16 (see uint128_t_text.h) from
+    // [in, in + len) into out and returns how many lines were read, which
+    // stops short at the first invalid one
+    std::size_t (*parse_lines)(const char * in, std::size_t len, uint8_t base, uint128_t * out);
+
+    // writes values[i] in base 10 or 16, each followed by '\n', to out (40
+    // chars per value are enough) and returns the number of chars written
+    std::size_t (*format_lines)(const uint128_t * values, std::size_t count, uint8_t base, char * out);
+};
+
+// currently selected table; never null
+#if defined(UINT128_T_HEADER_ONLY)
+    // a static member of a class template has a single instance across all
+    // translation units, which is what an inline variable would give in C++17
+    template <typename T = void>
+    struct uint128_dispatch_slot{
+        static std::atomic <const uint128_kernels *> table;
+    };
+    #define UINT128_T_DISPATCH uint128_dispatch_slot <>::table
+#else
+    UINT128_T_EXTERN extern std::atomic <const uint128_kernels *> uint128_dispatch;
+    #define UINT128_T_DISPATCH uint128_dispatch
+#endif
+
+inline const uint128_kernels & uint128_active_kernels(){
+    return *UINT128_T_DISPATCH.load(std::memory_order_relaxed);
+}
+
+// table for a specific level, or nullptr if it is not compiled in or not supported by this CPU
+UINT128_T_EXTERN const uint128_kernels * uint128_kernels_for(const uint128_isa isa);
+
+// best level supported by this CPU
+UINT128_T_EXTERN uint128_isa uint128_detected_isa();
+
+// level of the active table
+UINT128_T_EXTERN uint128_isa uint128_active_isa();
+
+// select a level, lowered to the best supported one; returns the level that was selected
+UINT128_T_EXTERN uint128_isa uint128_set_isa(const uint128_isa isa);
+
+UINT128_T_EXTERN const char * uint128_isa_name(const uint128_isa isa);
+
+// parses a level name; throws std::invalid_argument on unknown names
+UINT128_T_EXTERN uint128_isa uint128_isa_from_name(const std::string & name);
+
+// Batch multiply: out[i] = lhs[i] * rhs[i]
+UINT128_T_EXTERN void multiply(const uint128_t * lhs, const uint128_t * rhs, uint128_t * out, std::size_t count);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t.cpp"
+  #include "uint128_t_dispatch.cpp"
+#endif
+
+#endif
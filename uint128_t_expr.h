@@ -0,0 +1,432 @@
+// PUBLIC IMPORT HEADER
+// Opt-in expression templates for uint128_t
+//
+// Wrapping one operand with lazy() turns the rest of the expression into a
+// tree of small node objects instead of a chain of uint128_t temporaries:
+//
+//     uint128_t r = (lazy(a) * b + c) % m;
+//     uint128_t s = (lazy(x) << 3) | ((y >> 5) ^ z);
+//
+// The tree is evaluated on raw 64 bit limbs, inline, when it is converted to
+// uint128_t. On top of that some chains are fused:
+//
+//     a * b % m, (a * b + c) % m, (c + a * b) % m
+//         the product is kept at its full 256 bits and reduced once, so the
+//         result is the exact modular product. (The plain operators reduce
+//         the product truncated to 128 bits.)
+//     (e << i) << j, (e >> i) >> j
+//         become a single shift
+//
+// Nodes hold references to their uint128_t operands, so an expression has to
+// be converted before the end of the full expression it was written in. Do
+// not keep one in an auto variable.
+#ifndef _UINT128_T_EXPR_H_
+#define _UINT128_T_EXPR_H_
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "uint128_t.h"
+#include "uint128_t_intrinsics.include"
+
+namespace uint128_expr {
+
+    // value being computed, most significant limb first
+    struct limbs{
+        uint64_t hi;
+        uint64_t lo;
+    };
+
+    struct expr_base {};
+
+    // every node derives from expr <itself> and has limbs eval() const
+    template <typename Derived>
+    struct expr : expr_base{
+        const Derived & self() const{
+            return static_cast <const Derived &> (*this);
+        }
+
+        uint128_t value() const{
+            const limbs v = self().eval();
+            return uint128_t(v.hi, v.lo);
+        }
+
+        operator uint128_t() const{
+            return value();
+        }
+    };
+
+    // leaves
+    struct term : expr <term>{
+        const uint128_t & v;
+
+        explicit term(const uint128_t & value)
+            : v(value)
+        {}
+
+        limbs eval() const{
+            return limbs{v.upper(), v.lower()};
+        }
+    };
+
+    struct constant : expr <constant>{
+        limbs v;
+
+        constant(const uint64_t hi, const uint64_t lo)
+            : v(limbs{hi, lo})
+        {}
+
+        limbs eval() const{
+            return v;
+        }
+    };
+
+    template <typename T>
+    struct is_node : std::is_base_of <expr_base, T> {};
+
+    // maps an operand (node, uint128_t or built-in integer) to its node type
+    template <typename T, typename = void>
+    struct node_of{};
+
+    template <typename T>
+    struct node_of <T, typename std::enable_if <is_node <T>::value>::type>{
+        typedef T type;
+        static const T & make(const T & node){ return node; }
+    };
+
+    template <>
+    struct node_of <uint128_t>{
+        typedef term type;
+        static term make(const uint128_t & value){ return term(value); }
+    };
+
+    template <typename T>
+    struct node_of <T, typename std::enable_if <uint128_detail::is_limb_integral <T>::value>::type>{
+        typedef constant type;
+        static constant make(const T & value){ return constant(0, (uint64_t) value); }
+    };
+
+#if defined(__SIZEOF_INT128__)
+    template <typename T>
+    struct node_of <T, typename std::enable_if <uint128_detail::is_native <T>::value>::type>{
+        typedef constant type;
+        static constant make(const T & value){ return constant((uint64_t) ((uint128_detail::native_u128) value >> 64), (uint64_t) value); }
+    };
+#endif
+
+    template <typename T>
+    using node_t = typename node_of <T>::type;
+
+    template <typename T>
+    node_t <T> make_node(const T & operand){
+        return node_of <T>::make(operand);
+    }
+
+    template <typename T, typename = void>
+    struct is_operand : std::false_type {};
+
+    template <typename T>
+    struct is_operand <T, typename std::enable_if <sizeof(typename node_of <T>::type) != 0>::type> : std::true_type {};
+
+    // true when both are operands and at least one of them is already a node,
+    // so plain uint128_t expressions never pick up these operators
+    template <typename A, typename B>
+    struct enable_binary : std::enable_if <(is_node <A>::value || is_node <B>::value) &&
+                                           is_operand <A>::value && is_operand <B>::value> {};
+
+    // limb arithmetic
+    struct add_op{
+        static limbs apply(const limbs & a, const limbs & b){
+            uint64_t carry = 0;
+            const uint64_t lo = uint128_detail::addc64(a.lo, b.lo, carry);
+            return limbs{a.hi + b.hi + carry, lo};
+        }
+    };
+
+    struct sub_op{
+        static limbs apply(const limbs & a, const limbs & b){
+            uint64_t borrow = 0;
+            const uint64_t lo = uint128_detail::subb64(a.lo, b.lo, borrow);
+            return limbs{a.hi - b.hi - borrow, lo};
+        }
+    };
+
+    struct mul_op{
+        static limbs apply(const limbs & a, const limbs & b){
+            uint64_t hi;
+            const uint64_t lo = uint128_detail::mul64(a.lo, b.lo, hi);
+            return limbs{hi + a.lo * b.hi + a.hi * b.lo, lo};
+        }
+    };
+
+    struct div_op{
+        static limbs apply(const limbs & a, const limbs & b){
+            const uint128_t q = uint128_t(a.hi, a.lo) / uint128_t(b.hi, b.lo);
+            return limbs{q.upper(), q.lower()};
+        }
+    };
+
+    struct mod_op{
+        static limbs apply(const limbs & a, const limbs & b){
+            const uint128_t r = uint128_t(a.hi, a.lo) % uint128_t(b.hi, b.lo);
+            return limbs{r.upper(), r.lower()};
+        }
+    };
+
+    struct and_op{
+        static limbs apply(const limbs & a, const limbs & b){ return limbs{a.hi & b.hi, a.lo & b.lo}; }
+    };
+
+    struct or_op{
+        static limbs apply(const limbs & a, const limbs & b){ return limbs{a.hi | b.hi, a.lo | b.lo}; }
+    };
+
+    struct xor_op{
+        static limbs apply(const limbs & a, const limbs & b){ return limbs{a.hi ^ b.hi, a.lo ^ b.lo}; }
+    };
+
+    template <typename L, typename R, typename Op>
+    struct binary : expr <binary <L, R, Op> >{
+        L lhs;
+        R rhs;
+
+        binary(const L & l, const R & r)
+            : lhs(l), rhs(r)
+        {}
+
+        limbs eval() const{
+            return Op::apply(lhs.eval(), rhs.eval());
+        }
+    };
+
+    template <typename E>
+    struct invert : expr <invert <E> >{
+        E e;
+
+        explicit invert(const E & node)
+            : e(node)
+        {}
+
+        limbs eval() const{
+            const limbs v = e.eval();
+            return limbs{~v.hi, ~v.lo};
+        }
+    };
+
+    template <typename E>
+    struct negate : expr <negate <E> >{
+        E e;
+
+        explicit negate(const E & node)
+            : e(node)
+        {}
+
+        limbs eval() const{
+            return sub_op::apply(limbs{0, 0}, e.eval());
+        }
+    };
+
+    // shift amounts are clamped to 128, which shifts everything out
+    template <typename T>
+    typename std::enable_if <uint128_detail::is_limb_integral <T>::value, unsigned>::type
+    shift_amount(const T & n){
+        return ((n < (T) 0) || ((uint64_t) n >= 128)) ? 128 : (unsigned) n;
+    }
+
+    inline unsigned shift_amount(const uint128_t & n){
+        return (n.upper() || (n.lower() >= 128)) ? 128 : (unsigned) n.lower();
+    }
+
+    template <typename E>
+    unsigned shift_amount(const expr <E> & n){
+        const limbs v = n.self().eval();
+        return (v.hi || (v.lo >= 128)) ? 128 : (unsigned) v.lo;
+    }
+
+    template <typename E>
+    struct shift_left : expr <shift_left <E> >{
+        E e;
+        unsigned n;
+
+        shift_left(const E & node, const unsigned amount)
+            : e(node), n(amount)
+        {}
+
+        limbs eval() const{
+            const limbs v = e.eval();
+            if (n >= 128){
+                return limbs{0, 0};
+            }
+            if (n >= 64){
+                return limbs{v.lo << (n - 64), 0};
+            }
+            if (!n){
+                return v;
+            }
+            return limbs{(v.hi << n) | (v.lo >> (64 - n)), v.lo << n};
+        }
+    };
+
+    template <typename E>
+    struct shift_right : expr <shift_right <E> >{
+        E e;
+        unsigned n;
+
+        shift_right(const E & node, const unsigned amount)
+            : e(node), n(amount)
+        {}
+
+        limbs eval() const{
+            const limbs v = e.eval();
+            if (n >= 128){
+                return limbs{0, 0};
+            }
+            if (n >= 64){
+                return limbs{0, v.hi >> (n - 64)};
+            }
+            if (!n){
+                return v;
+            }
+            return limbs{v.hi >> n, (v.lo >> n) | (v.hi << (64 - n))};
+        }
+    };
+
+    // stands in for the missing addend of a * b % m
+    struct zero : expr <zero>{
+        limbs eval() const{
+            return limbs{0, 0};
+        }
+    };
+
+    // (a * b + c) mod m with the full 256 bit product
+    template <typename A, typename B, typename C, typename M>
+    struct mul_add_mod : expr <mul_add_mod <A, B, C, M> >{
+        A a;
+        B b;
+        C c;
+        M m;
+
+        mul_add_mod(const A & a_, const B & b_, const C & c_, const M & m_)
+            : a(a_), b(b_), c(c_), m(m_)
+        {}
+
+        limbs eval() const{
+            const limbs x = a.eval(), y = b.eval(), z = c.eval(), d = m.eval();
+            if (!(d.hi | d.lo)){
+                throw std::domain_error("Error: division or modulus by 0");
+            }
+
+            // (2^128 - 1)^2 + 2^128 - 1 < 2^256, so the sum cannot overflow
+            uint64_t p[4];
+            uint128_detail::mul128(x.hi, x.lo, y.hi, y.lo, p);
+            uint64_t carry = 0;
+            p[3] = uint128_detail::addc64(p[3], z.lo, carry);
+            p[2] = uint128_detail::addc64(p[2], z.hi, carry);
+            p[1] = uint128_detail::addc64(p[1], 0, carry);
+            p[0] += carry;
+
+            uint64_t q[4];
+            limbs r;
+            uint128_detail::div256by128(p, d.hi, d.lo, q, r.hi, r.lo);
+            return r;
+        }
+    };
+
+    // generic operators
+    #define UINT128_T_EXPR_BINARY(OP, OP_TYPE)                                                          \
+        template <typename A, typename B, typename = typename enable_binary <A, B>::type>              \
+        binary <node_t <A>, node_t <B>, OP_TYPE> operator OP(const A & lhs, const B & rhs){            \
+            return binary <node_t <A>, node_t <B>, OP_TYPE> (make_node(lhs), make_node(rhs));          \
+        }
+
+    UINT128_T_EXPR_BINARY(+, add_op)
+    UINT128_T_EXPR_BINARY(-, sub_op)
+    UINT128_T_EXPR_BINARY(*, mul_op)
+    UINT128_T_EXPR_BINARY(/, div_op)
+    UINT128_T_EXPR_BINARY(%, mod_op)
+    UINT128_T_EXPR_BINARY(&, and_op)
+    UINT128_T_EXPR_BINARY(|, or_op)
+    UINT128_T_EXPR_BINARY(^, xor_op)
+
+    #undef UINT128_T_EXPR_BINARY
+
+    #define UINT128_T_EXPR_COMPARE(OP)                                                                 \
+        template <typename A, typename B, typename = typename enable_binary <A, B>::type>              \
+        bool operator OP(const A & lhs, const B & rhs){                                                \
+            const limbs a = make_node(lhs).eval(), b = make_node(rhs).eval();                          \
+            return (a.hi != b.hi) ? (a.hi OP b.hi) : (a.lo OP b.lo);                                   \
+        }
+
+    UINT128_T_EXPR_COMPARE(==)
+    UINT128_T_EXPR_COMPARE(!=)
+    UINT128_T_EXPR_COMPARE(<)
+    UINT128_T_EXPR_COMPARE(<=)
+    UINT128_T_EXPR_COMPARE(>)
+    UINT128_T_EXPR_COMPARE(>=)
+
+    #undef UINT128_T_EXPR_COMPARE
+
+    template <typename E>
+    invert <E> operator~(const expr <E> & e){
+        return invert <E> (e.self());
+    }
+
+    template <typename E>
+    negate <E> operator-(const expr <E> & e){
+        return negate <E> (e.self());
+    }
+
+    template <typename A, typename B, typename = typename enable_binary <A, B>::type>
+    shift_left <node_t <A> > operator<<(const A & lhs, const B & rhs){
+        return shift_left <node_t <A> > (make_node(lhs), shift_amount(rhs));
+    }
+
+    template <typename A, typename B, typename = typename enable_binary <A, B>::type>
+    shift_right <node_t <A> > operator>>(const A & lhs, const B & rhs){
+        return shift_right <node_t <A> > (make_node(lhs), shift_amount(rhs));
+    }
+
+    // fused shifts
+    template <typename E, typename B, typename = typename std::enable_if <!is_node <B>::value>::type>
+    shift_left <E> operator<<(const shift_left <E> & lhs, const B & rhs){
+        const unsigned n = lhs.n + shift_amount(rhs);
+        return shift_left <E> (lhs.e, (n > 128) ? 128 : n);
+    }
+
+    template <typename E, typename B, typename = typename std::enable_if <!is_node <B>::value>::type>
+    shift_right <E> operator>>(const shift_right <E> & lhs, const B & rhs){
+        const unsigned n = lhs.n + shift_amount(rhs);
+        return shift_right <E> (lhs.e, (n > 128) ? 128 : n);
+    }
+
+    // fused multiply-modulo
+    template <typename A, typename B, typename M, typename = typename std::enable_if <is_operand <M>::value>::type>
+    mul_add_mod <A, B, zero, node_t <M> > operator%(const binary <A, B, mul_op> & lhs, const M & rhs){
+        return mul_add_mod <A, B, zero, node_t <M> > (lhs.lhs, lhs.rhs, zero(), make_node(rhs));
+    }
+
+    template <typename A, typename B, typename C, typename M, typename = typename std::enable_if <is_operand <M>::value>::type>
+    mul_add_mod <A, B, C, node_t <M> > operator%(const binary <binary <A, B, mul_op>, C, add_op> & lhs, const M & rhs){
+        return mul_add_mod <A, B, C, node_t <M> > (lhs.lhs.lhs, lhs.lhs.rhs, lhs.rhs, make_node(rhs));
+    }
+
+    template <typename A, typename B, typename C, typename M, typename = typename std::enable_if <is_operand <M>::value>::type>
+    mul_add_mod <A, B, C, node_t <M> > operator%(const binary <C, binary <A, B, mul_op>, add_op> & lhs, const M & rhs){
+        return mul_add_mod <A, B, C, node_t <M> > (lhs.rhs.lhs, lhs.rhs.rhs, lhs.lhs, make_node(rhs));
+    }
+
+    // a * b + c * d would match both forms above; it is left unfused
+    template <typename A, typename B, typename C, typename D, typename M, typename = typename std::enable_if <is_operand <M>::value>::type>
+    binary <binary <binary <A, B, mul_op>, binary <C, D, mul_op>, add_op>, node_t <M>, mod_op>
+    operator%(const binary <binary <A, B, mul_op>, binary <C, D, mul_op>, add_op> & lhs, const M & rhs){
+        return binary <binary <binary <A, B, mul_op>, binary <C, D, mul_op>, add_op>, node_t <M>, mod_op> (lhs, make_node(rhs));
+    }
+
+    inline term lazy(const uint128_t & value){
+        return term(value);
+    }
+}
+
+using uint128_expr::lazy;
+
+#endif
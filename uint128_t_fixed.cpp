@@ -0,0 +1,457 @@
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_fixed.h"
+#include "uint128_t_intrinsics.include"
+
+// A one limb divisor: its value, the value shifted left until the top bit
+// is set, the reciprocal floor((2^128 - 1) / normalized) - 2^64 and the shift.
+// None of the divisors below has its top bit set, so the shift is in [1, 63].
+struct fixed128_divisor{
+    uint64_t value;
+    uint64_t d;
+    uint64_t v;
+    unsigned shift;
+};
+
+// 10^k for k = 0 to 18
+static const fixed128_divisor FIXED128_DIV10[19] = {
+    {0x0000000000000001ULL, 0x8000000000000000ULL, 0xffffffffffffffffULL, 63},   // 10^0
+    {0x000000000000000aULL, 0xa000000000000000ULL, 0x9999999999999999ULL, 60},   // 10^1
+    {0x0000000000000064ULL, 0xc800000000000000ULL, 0x47ae147ae147ae14ULL, 57},   // 10^2
+    {0x00000000000003e8ULL, 0xfa00000000000000ULL, 0x0624dd2f1a9fbe76ULL, 54},   // 10^3
+    {0x0000000000002710ULL, 0x9c40000000000000ULL, 0xa36e2eb1c432ca57ULL, 50},   // 10^4
+    {0x00000000000186a0ULL, 0xc350000000000000ULL, 0x4f8b588e368f0846ULL, 47},   // 10^5
+    {0x00000000000f4240ULL, 0xf424000000000000ULL, 0x0c6f7a0b5ed8d36bULL, 44},   // 10^6
+    {0x0000000000989680ULL, 0x9896800000000000ULL, 0xad7f29abcaf48578ULL, 40},   // 10^7
+    {0x0000000005f5e100ULL, 0xbebc200000000000ULL, 0x5798ee2308c39df9ULL, 37},   // 10^8
+    {0x000000003b9aca00ULL, 0xee6b280000000000ULL, 0x12e0be826d694b2eULL, 34},   // 10^9
+    {0x00000002540be400ULL, 0x9502f90000000000ULL, 0xb7cdfd9d7bdbab7dULL, 30},   // 10^10
+    {0x000000174876e800ULL, 0xba43b74000000000ULL, 0x5fd7fe17964955fdULL, 27},   // 10^11
+    {0x000000e8d4a51000ULL, 0xe8d4a51000000000ULL, 0x19799812dea11197ULL, 24},   // 10^12
+    {0x000009184e72a000ULL, 0x9184e72a00000000ULL, 0xc25c268497681c26ULL, 20},   // 10^13
+    {0x00005af3107a4000ULL, 0xb5e620f480000000ULL, 0x6849b86a12b9b01eULL, 17},   // 10^14
+    {0x00038d7ea4c68000ULL, 0xe35fa931a0000000ULL, 0x203af9ee756159b2ULL, 14},   // 10^15
+    {0x002386f26fc10000ULL, 0x8e1bc9bf04000000ULL, 0xcd2b297d889bc2b6ULL, 10},   // 10^16
+    {0x016345785d8a0000ULL, 0xb1a2bc2ec5000000ULL, 0x70ef54646d496892ULL,  7},   // 10^17
+    {0x0de0b6b3a7640000ULL, 0xde0b6b3a76400000ULL, 0x2725dd1d243aba0eULL,  4},   // 10^18
+};
+
+// 5^k for k = 0 to 27, for the larger powers of 10
+static const fixed128_divisor FIXED128_DIV5[28] = {
+    {0x0000000000000001ULL, 0x8000000000000000ULL, 0xffffffffffffffffULL, 63},   // 5^0
+    {0x0000000000000005ULL, 0xa000000000000000ULL, 0x9999999999999999ULL, 61},   // 5^1
+    {0x0000000000000019ULL, 0xc800000000000000ULL, 0x47ae147ae147ae14ULL, 59},   // 5^2
+    {0x000000000000007dULL, 0xfa00000000000000ULL, 0x0624dd2f1a9fbe76ULL, 57},   // 5^3
+    {0x0000000000000271ULL, 0x9c40000000000000ULL, 0xa36e2eb1c432ca57ULL, 54},   // 5^4
+    {0x0000000000000c35ULL, 0xc350000000000000ULL, 0x4f8b588e368f0846ULL, 52},   // 5^5
+    {0x0000000000003d09ULL, 0xf424000000000000ULL, 0x0c6f7a0b5ed8d36bULL, 50},   // 5^6
+    {0x000000000001312dULL, 0x9896800000000000ULL, 0xad7f29abcaf48578ULL, 47},   // 5^7
+    {0x000000000005f5e1ULL, 0xbebc200000000000ULL, 0x5798ee2308c39df9ULL, 45},   // 5^8
+    {0x00000000001dcd65ULL, 0xee6b280000000000ULL, 0x12e0be826d694b2eULL, 43},   // 5^9
+    {0x00000000009502f9ULL, 0x9502f90000000000ULL, 0xb7cdfd9d7bdbab7dULL, 40},   // 5^10
+    {0x0000000002e90eddULL, 0xba43b74000000000ULL, 0x5fd7fe17964955fdULL, 38},   // 5^11
+    {0x000000000e8d4a51ULL, 0xe8d4a51000000000ULL, 0x19799812dea11197ULL, 36},   // 5^12
+    {0x0000000048c27395ULL, 0x9184e72a00000000ULL, 0xc25c268497681c26ULL, 33},   // 5^13
+    {0x000000016bcc41e9ULL, 0xb5e620f480000000ULL, 0x6849b86a12b9b01eULL, 31},   // 5^14
+    {0x000000071afd498dULL, 0xe35fa931a0000000ULL, 0x203af9ee756159b2ULL, 29},   // 5^15
+    {0x0000002386f26fc1ULL, 0x8e1bc9bf04000000ULL, 0xcd2b297d889bc2b6ULL, 26},   // 5^16
+    {0x000000b1a2bc2ec5ULL, 0xb1a2bc2ec5000000ULL, 0x70ef54646d496892ULL, 24},   // 5^17
+    {0x000003782dace9d9ULL, 0xde0b6b3a76400000ULL, 0x2725dd1d243aba0eULL, 22},   // 5^18
+    {0x00001158e460913dULL, 0x8ac7230489e80000ULL, 0xd83c94fb6d2ac34aULL, 19},   // 5^19
+    {0x000056bc75e2d631ULL, 0xad78ebc5ac620000ULL, 0x79ca10c9242235d5ULL, 17},   // 5^20
+    {0x0001b1ae4d6e2ef5ULL, 0xd8d726b7177a8000ULL, 0x2e3b40a0e9b4f7ddULL, 15},   // 5^21
+    {0x000878678326eac9ULL, 0x878678326eac9000ULL, 0xe392010175ee5962ULL, 12},   // 5^22
+    {0x002a5a058fc295edULL, 0xa968163f0a57b400ULL, 0x82db34012b25144eULL, 10},   // 5^23
+    {0x00d3c21bcecceda1ULL, 0xd3c21bcecceda100ULL, 0x357c299a88ea76a5ULL,  8},   // 5^24
+    {0x0422ca8b0a00a425ULL, 0x84595161401484a0ULL, 0xef2d0f5da7dd8aa2ULL,  5},   // 5^25
+    {0x14adf4b7320334b9ULL, 0xa56fa5b99019a5c8ULL, 0x8c240c4aecb13bb5ULL,  3},   // 5^26
+    {0x6765c793fa10079dULL, 0xcecb8f27f4200f3aULL, 0x3ce9a36f23c0fc90ULL,  1},   // 5^27
+};
+
+// 10^k as {upper, lower}, for k = 0 to 38
+static const uint64_t FIXED128_POW10[39][2] = {
+    {0x0000000000000000ULL, 0x0000000000000001ULL},   // 10^0
+    {0x0000000000000000ULL, 0x000000000000000aULL},   // 10^1
+    {0x0000000000000000ULL, 0x0000000000000064ULL},   // 10^2
+    {0x0000000000000000ULL, 0x00000000000003e8ULL},   // 10^3
+    {0x0000000000000000ULL, 0x0000000000002710ULL},   // 10^4
+    {0x0000000000000000ULL, 0x00000000000186a0ULL},   // 10^5
+    {0x0000000000000000ULL, 0x00000000000f4240ULL},   // 10^6
+    {0x0000000000000000ULL, 0x0000000000989680ULL},   // 10^7
+    {0x0000000000000000ULL, 0x0000000005f5e100ULL},   // 10^8
+    {0x0000000000000000ULL, 0x000000003b9aca00ULL},   // 10^9
+    {0x0000000000000000ULL, 0x00000002540be400ULL},   // 10^10
+    {0x0000000000000000ULL, 0x000000174876e800ULL},   // 10^11
+    {0x0000000000000000ULL, 0x000000e8d4a51000ULL},   // 10^12
+    {0x0000000000000000ULL, 0x000009184e72a000ULL},   // 10^13
+    {0x0000000000000000ULL, 0x00005af3107a4000ULL},   // 10^14
+    {0x0000000000000000ULL, 0x00038d7ea4c68000ULL},   // 10^15
+    {0x0000000000000000ULL, 0x002386f26fc10000ULL},   // 10^16
+    {0x0000000000000000ULL, 0x016345785d8a0000ULL},   // 10^17
+    {0x0000000000000000ULL, 0x0de0b6b3a7640000ULL},   // 10^18
+    {0x0000000000000000ULL, 0x8ac7230489e80000ULL},   // 10^19
+    {0x0000000000000005ULL, 0x6bc75e2d63100000ULL},   // 10^20
+    {0x0000000000000036ULL, 0x35c9adc5dea00000ULL},   // 10^21
+    {0x000000000000021eULL, 0x19e0c9bab2400000ULL},   // 10^22
+    {0x000000000000152dULL, 0x02c7e14af6800000ULL},   // 10^23
+    {0x000000000000d3c2ULL, 0x1bcecceda1000000ULL},   // 10^24
+    {0x0000000000084595ULL, 0x161401484a000000ULL},   // 10^25
+    {0x000000000052b7d2ULL, 0xdcc80cd2e4000000ULL},   // 10^26
+    {0x00000000033b2e3cULL, 0x9fd0803ce8000000ULL},   // 10^27
+    {0x00000000204fce5eULL, 0x3e25026110000000ULL},   // 10^28
+    {0x00000001431e0faeULL, 0x6d7217caa0000000ULL},   // 10^29
+    {0x0000000c9f2c9cd0ULL, 0x4674edea40000000ULL},   // 10^30
+    {0x0000007e37be2022ULL, 0xc0914b2680000000ULL},   // 10^31
+    {0x000004ee2d6d415bULL, 0x85acef8100000000ULL},   // 10^32
+    {0x0000314dc6448d93ULL, 0x38c15b0a00000000ULL},   // 10^33
+    {0x0001ed09bead87c0ULL, 0x378d8e6400000000ULL},   // 10^34
+    {0x0013426172c74d82ULL, 0x2b878fe800000000ULL},   // 10^35
+    {0x00c097ce7bc90715ULL, 0xb34b9f1000000000ULL},   // 10^36
+    {0x0785ee10d5da46d9ULL, 0x00f436a000000000ULL},   // 10^37
+    {0x4b3b4ca85a86c47aULL, 0x098a224000000000ULL},   // 10^38
+};
+
+// Moller and Granlund, algorithm 4: (u1:u0) / d with a normalized d,
+// its reciprocal v and u1 < d. Two multiplies instead of a DIV.
+static inline uint64_t fixed128_div2by1(const uint64_t u1, const uint64_t u0, const uint64_t d, const uint64_t v, uint64_t & r){
+    uint64_t q1;
+    uint64_t q0 = uint128_detail::mul64(v, u1, q1);
+    uint64_t carry = 0;
+    q0 = uint128_detail::addc64(q0, u0, carry);
+    q1 = uint128_detail::addc64(q1, u1 + 1, carry);
+    uint64_t rem = u0 - q1 * d;
+    // taken about half the time, so done with a mask instead of a branch
+    const uint64_t adjust = 0 - (uint64_t) (rem > q0);
+    q1 += adjust;
+    rem += adjust & d;
+    if (rem >= d){
+        q1++;
+        rem -= d;
+    }
+    r = rem;
+    return q1;
+}
+
+// u (n limbs, most significant first) /= div in place; returns the remainder
+static uint64_t fixed128_div_limbs(uint64_t * u, std::size_t n, const fixed128_divisor & div){
+    const unsigned s = div.shift;
+
+    // leading zero limbs give zero quotient limbs
+    while (n && !*u){
+        u++;
+        n--;
+    }
+    if (!n){
+        return 0;
+    }
+
+    // Divide u << s by d = value << s one limb at a time. If the top limb is
+    // already below the divisor its quotient limb is 0, and u[0] << s with
+    // the top bits of u[1] is where the remainder starts.
+    std::size_t i = 0;
+    uint64_t r = u[0] >> (64 - s);
+    if (u[0] < div.value){
+        r = (u[0] << s) | ((n > 1) ? (u[1] >> (64 - s)) : 0);
+        u[0] = 0;
+        i = 1;
+    }
+    for(; i < n; i++){
+        const uint64_t next = (i + 1 < n) ? u[i + 1] : 0;
+        u[i] = fixed128_div2by1(r, (u[i] << s) | (next >> (64 - s)), div.d, div.v, r);
+    }
+    return r >> s;
+}
+
+// u (4 limbs, most significant first) /= 10^scale in place; returns the remainder
+static void fixed128_div_pow10(uint64_t u[4], const unsigned scale, uint64_t & r_hi, uint64_t & r_lo){
+    if (scale <= 18){
+        r_hi = 0;
+        r_lo = fixed128_div_limbs(u, 4, FIXED128_DIV10[scale]);
+        return;
+    }
+
+    // 10^scale = 2^scale * 5^scale, and scale < 64, so the power of two is a shift
+    const uint64_t low = u[3] & ((1ULL << scale) - 1);
+    for(int i = 3; i > 0; i--){
+        u[i] = (u[i] >> scale) | (u[i - 1] << (64 - scale));
+    }
+    u[0] >>= scale;
+
+    // 5^scale only fits in a limb up to 5^27, larger ones are divided out in two steps:
+    // u = 5^27 * (5^(scale - 27) * q + r2) + r1
+    uint64_t rem_hi = 0, rem_lo;
+    if (scale <= 27){
+        rem_lo = fixed128_div_limbs(u, 4, FIXED128_DIV5[scale]);
+    }
+    else{
+        const uint64_t r1 = fixed128_div_limbs(u, 4, FIXED128_DIV5[27]);
+        const uint64_t r2 = fixed128_div_limbs(u, 4, FIXED128_DIV5[scale - 27]);
+        uint64_t carry = 0;
+        rem_lo = uint128_detail::addc64(uint128_detail::mul64(FIXED128_DIV5[27].value, r2, rem_hi), r1, carry);
+        rem_hi += carry;
+    }
+
+    // remainder = (rem << scale) | low
+    r_hi = (rem_hi << scale) | (rem_lo >> (64 - scale));
+    r_lo = (rem_lo << scale) | low;
+}
+
+// whether rounding the quotient of a division by d with remainder r (r < d) goes up
+static bool fixed128_round_up(const fixed_rounding mode, const uint64_t r_hi, const uint64_t r_lo,
+                              const uint64_t d_hi, const uint64_t d_lo, const bool odd){
+    if (!(r_hi | r_lo)){
+        return false;
+    }
+    switch (mode){
+        case fixed_rounding::down:
+            return false;
+        case fixed_rounding::up:
+            return true;
+        default:
+            break;
+    }
+
+    // compare r with d - r instead of 2r with d, which could overflow
+    uint64_t borrow = 0;
+    const uint64_t rest_lo = uint128_detail::subb64(d_lo, r_lo, borrow);
+    const uint64_t rest_hi = uint128_detail::subb64(d_hi, r_hi, borrow);
+    if ((r_hi != rest_hi) || (r_lo != rest_lo)){
+        return (r_hi > rest_hi) || ((r_hi == rest_hi) && (r_lo > rest_lo));
+    }
+    return (mode == fixed_rounding::half_up) || ((mode == fixed_rounding::half_even) && odd);
+}
+
+// rounds a 256 bit quotient and checks that it fits in 128 bits
+static uint128_t fixed128_finish(const uint64_t q[4], const uint64_t r_hi, const uint64_t r_lo,
+                                 const uint64_t d_hi, const uint64_t d_lo, const fixed_rounding mode){
+    uint64_t hi = q[2], lo = q[3];
+    bool overflow = q[0] | q[1];
+    if (fixed128_round_up(mode, r_hi, r_lo, d_hi, d_lo, lo & 1)){
+        hi += !++lo;
+        overflow |= !(hi | lo);
+    }
+    if (overflow){
+        throw std::overflow_error("Error: fixed128 result does not fit in 128 bits");
+    }
+    return uint128_t(hi, lo);
+}
+
+// value * 10^k, throwing if it does not fit
+static uint128_t fixed128_scale_up(const uint128_t & value, const unsigned k){
+    uint64_t p[4];
+    uint128_detail::mul128(value.upper(), value.lower(), FIXED128_POW10[k][0], FIXED128_POW10[k][1], p);
+    if (p[0] | p[1]){
+        throw std::overflow_error("Error: fixed128 result does not fit in 128 bits");
+    }
+    return uint128_t(p[2], p[3]);
+}
+
+// writes exactly width digits of value, with leading zeros
+static void fixed128_write_digits(uint64_t value, unsigned width, char * out){
+    char * p = out + width;
+    while (width >= 2){
+        const char * pair = uint128_detail::DIGIT_PAIRS + 2 * (value % 100);
+        *--p = pair[1];
+        *--p = pair[0];
+        value /= 100;
+        width -= 2;
+    }
+    if (width){
+        *--p = (char) ('0' + value % 10);
+    }
+}
+
+// acc = acc * 10 ^ (number of digits read) + digits, reading at most 19 digits at a time;
+// returns false on overflow
+static bool fixed128_read_digits(const char *& p, const char * end, uint64_t & hi, uint64_t & lo, unsigned & count){
+    while ((p != end) && (*p >= '0') && (*p <= '9')){
+        uint64_t chunk = 0;
+        unsigned n = 0;
+        for(; (p != end) && (*p >= '0') && (*p <= '9') && (n < 19); p++, n++){
+            chunk = chunk * 10 + (uint64_t) (*p - '0');
+        }
+        count += n;
+
+        // (hi:lo) * 10^n + chunk
+        const uint64_t m = FIXED128_POW10[n][1];
+        uint64_t lo_hi, hi_hi;
+        const uint64_t new_lo = uint128_detail::mul64(lo, m, lo_hi);
+        const uint64_t new_hi = uint128_detail::mul64(hi, m, hi_hi);
+        uint64_t carry = 0;
+        lo = uint128_detail::addc64(new_lo, chunk, carry);
+        const uint64_t sum = uint128_detail::addc64(new_hi, lo_hi, carry);
+        if (hi_hi || carry){
+            return false;
+        }
+        hi = sum;
+    }
+    return true;
+}
+
+// q = a * b / c and r = a * b % c; c must not be 0 unless the product fits in 128 bits
+static void muldiv_divide(const uint128_t & a, const uint128_t & b, const uint128_t & c, uint128_t & q, uint128_t & r){
+    uint64_t p[4];
+    uint128_detail::mul128(a.upper(), a.lower(), b.upper(), b.lower(), p);
+
+    // the product fits: one ordinary division, which also throws for c = 0
+    if (!(p[0] | p[1])){
+        const uint128_t n(p[2], p[3]);
+        q = n / c;
+        r = n - q * c;
+        return;
+    }
+
+    // the quotient fits in 128 bits only if the upper half of the product is below c
+    if ((p[0] > c.upper()) || ((p[0] == c.upper()) && (p[1] >= c.lower()))){
+        if (!(c.upper() | c.lower())){
+            throw std::domain_error("Error: division or modulus by 0");
+        }
+        throw std::overflow_error("Error: muldiv result does not fit in 128 bits");
+    }
+
+    uint64_t quotient[4], r_hi, r_lo;
+    uint128_detail::div256by128(p, c.upper(), c.lower(), quotient, r_hi, r_lo);
+    q = uint128_t(quotient[2], quotient[3]);
+    r = uint128_t(r_hi, r_lo);
+}
+
+UINT128_T_INLINE uint128_t muldiv(const uint128_t & a, const uint128_t & b, const uint128_t & c){
+    uint128_t q, r;
+    muldiv_divide(a, b, c, q, r);
+    return q;
+}
+
+UINT128_T_INLINE uint128_t muldiv_round(const uint128_t & a, const uint128_t & b, const uint128_t & c, const fixed_rounding mode){
+    uint128_t q, r;
+    muldiv_divide(a, b, c, q, r);
+    if (fixed128_round_up(mode, r.upper(), r.lower(), c.upper(), c.lower(), q.lower() & 1)){
+        if (!++q){
+            throw std::overflow_error("Error: muldiv result does not fit in 128 bits");
+        }
+    }
+    return q;
+}
+
+namespace fixed128_detail {
+
+UINT128_T_INLINE uint128_t from_integer(const uint128_t & value, const unsigned scale){
+    return fixed128_scale_up(value, scale);
+}
+
+UINT128_T_INLINE uint128_t mul(const uint128_t & lhs, const uint128_t & rhs, const unsigned scale, const fixed_rounding mode){
+    uint64_t p[4];
+    uint128_detail::mul128(lhs.upper(), lhs.lower(), rhs.upper(), rhs.lower(), p);
+    uint64_t r_hi, r_lo;
+    fixed128_div_pow10(p, scale, r_hi, r_lo);
+    return fixed128_finish(p, r_hi, r_lo, FIXED128_POW10[scale][0], FIXED128_POW10[scale][1], mode);
+}
+
+UINT128_T_INLINE uint128_t div(const uint128_t & lhs, const uint128_t & rhs, const unsigned scale, const fixed_rounding mode){
+    if (!(rhs.upper() | rhs.lower())){
+        throw std::domain_error("Error: division or modulus by 0");
+    }
+    uint64_t n[4], q[4];
+    uint128_detail::mul128(lhs.upper(), lhs.lower(), FIXED128_POW10[scale][0], FIXED128_POW10[scale][1], n);
+    uint64_t r_hi, r_lo;
+    uint128_detail::div256by128(n, rhs.upper(), rhs.lower(), q, r_hi, r_lo);
+    return fixed128_finish(q, r_hi, r_lo, rhs.upper(), rhs.lower(), mode);
+}
+
+UINT128_T_INLINE uint128_t rescale(const uint128_t & raw, const unsigned from, const unsigned to, const fixed_rounding mode){
+    if (to >= from){
+        return fixed128_scale_up(raw, to - from);
+    }
+    const unsigned k = from - to;
+    uint64_t u[4] = {0, 0, raw.upper(), raw.lower()};
+    uint64_t r_hi, r_lo;
+    fixed128_div_pow10(u, k, r_hi, r_lo);
+    return fixed128_finish(u, r_hi, r_lo, FIXED128_POW10[k][0], FIXED128_POW10[k][1], mode);
+}
+
+UINT128_T_INLINE void split(const uint128_t & raw, const unsigned scale, uint128_t & quotient, uint128_t & remainder){
+    uint64_t u[4] = {0, 0, raw.upper(), raw.lower()};
+    uint64_t r_hi, r_lo;
+    fixed128_div_pow10(u, scale, r_hi, r_lo);
+    quotient = uint128_t(u[2], u[3]);
+    remainder = uint128_t(r_hi, r_lo);
+}
+
+UINT128_T_INLINE std::size_t format(const uint128_t & raw, const unsigned scale, char * out){
+    uint64_t u[4] = {0, 0, raw.upper(), raw.lower()};
+    uint64_t r_hi, r_lo;
+    fixed128_div_pow10(u, scale, r_hi, r_lo);
+
+    std::size_t len = uint128_active_kernels().format(uint128_t(u[2], u[3]), 10, out);
+    if (!scale){
+        return len;
+    }
+    out[len++] = '.';
+
+    // the fraction is below 10^38, so at most two 19 digit chunks
+    if (scale > 19){
+        uint64_t f[4] = {0, 0, r_hi, r_lo};
+        uint64_t low_hi, low_lo;
+        fixed128_div_pow10(f, 19, low_hi, low_lo);
+        fixed128_write_digits(f[3], scale - 19, out + len);
+        fixed128_write_digits(low_lo, 19, out + len + scale - 19);
+    }
+    else{
+        fixed128_write_digits(r_lo, scale, out + len);
+    }
+    return len + scale;
+}
+
+UINT128_T_INLINE uint128_t parse(const char * str, const std::size_t len, const unsigned scale){
+    const char * p = str;
+    const char * const end = str + len;
+
+    // [0-9]+(\.[0-9]+)?
+    uint64_t int_hi = 0, int_lo = 0;
+    unsigned int_digits = 0;
+    if (!fixed128_read_digits(p, end, int_hi, int_lo, int_digits)){
+        throw std::overflow_error("Error: fixed128 value does not fit in 128 bits");
+    }
+    if (!int_digits){
+        throw std::invalid_argument("Error: fixed128 string has no digits");
+    }
+
+    uint64_t frac_hi = 0, frac_lo = 0;
+    unsigned frac_digits = 0;
+    if ((p != end) && (*p == '.')){
+        p++;
+        const char * const frac_start = p;
+        while ((p != end) && (*p >= '0') && (*p <= '9')){
+            p++;
+        }
+        if (p == frac_start){
+            throw std::invalid_argument("Error: fixed128 string has no digits after the decimal point");
+        }
+        if ((std::size_t) (p - frac_start) > scale){
+            throw std::invalid_argument("Error: fixed128 string has more fractional digits than the scale");
+        }
+        // at most 38 digits, which always fit
+        const char * q = frac_start;
+        fixed128_read_digits(q, p, frac_hi, frac_lo, frac_digits);
+    }
+    if (p != end){
+        throw std::invalid_argument("Error: unexpected character in fixed128 string");
+    }
+
+    // integer * 10^scale + fraction * 10^(scale - frac_digits); the second term is below 10^scale
+    const uint128_t whole = fixed128_scale_up(uint128_t(int_hi, int_lo), scale);
+    uint64_t f_hi;
+    const uint64_t f_lo = uint128_detail::mul64(frac_lo, FIXED128_POW10[scale - frac_digits][1], f_hi);
+    f_hi += frac_lo * FIXED128_POW10[scale - frac_digits][0] + frac_hi * FIXED128_POW10[scale - frac_digits][1];
+
+    uint64_t carry = 0;
+    const uint64_t lo = uint128_detail::addc64(whole.lower(), f_lo, carry);
+    const uint64_t hi = uint128_detail::addc64(whole.upper(), f_hi, carry);
+    if (carry){
+        throw std::overflow_error("Error: fixed128 value does not fit in 128 bits");
+    }
+    return uint128_t(hi, lo);
+}
+
+}
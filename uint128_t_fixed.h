@@ -0,0 +1,190 @@
+// PUBLIC IMPORT HEADER
+// Unsigned decimal fixed point on top of uint128_t
+//
+// fixed128<Scale> stores value * 10^Scale in a uint128_t, so fixed128<18>
+// holds amounts with 18 decimal places. Scale can be 0 to 38.
+//
+// Multiplication and division go through the full 256 bit product and round
+// with one of the fixed_rounding modes (half_even unless one is given).
+// Dividing by 10^Scale is done with precomputed reciprocals (Moller and
+// Granlund, "Improved division by invariant integers"), so neither the
+// arithmetic nor formatting and parsing touch uint128_t::operator/.
+//
+// muldiv(a, b, c) and muldiv_round(a, b, c, mode) are the same a * b / c on
+// plain integers, for when the product does not fit in 128 bits.
+//
+// Results that do not fit throw std::overflow_error, division by zero throws
+// std::domain_error and malformed strings throw std::invalid_argument.
+#ifndef _UINT128_T_FIXED_H_
+#define _UINT128_T_FIXED_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "uint128_t.h"
+
+// how to round away the digits that do not fit in the scale
+enum class fixed_rounding : uint8_t {
+    down,       // toward zero (truncate)
+    up,         // away from zero
+    half_down,  // to nearest, ties toward zero
+    half_up,    // to nearest, ties away from zero
+    half_even,  // to nearest, ties to the even neighbour
+};
+
+namespace fixed128_detail {
+    // 10^n as two limbs, usable in constant expressions
+    constexpr uint64_t mul10_carry(const uint64_t lo){
+        return (((lo >> 32) * 10) + (((lo & 0xffffffffULL) * 10) >> 32)) >> 32;
+    }
+
+    constexpr uint64_t pow10_lower(const unsigned n){
+        return n ? pow10_lower(n - 1) * 10 : 1;
+    }
+
+    constexpr uint64_t pow10_upper(const unsigned n){
+        return n ? pow10_upper(n - 1) * 10 + mul10_carry(pow10_lower(n - 1)) : 0;
+    }
+
+    // raw values are scaled by 10^scale; these do the work for every fixed128<Scale>
+    UINT128_T_EXTERN uint128_t from_integer(const uint128_t & value, const unsigned scale);
+    UINT128_T_EXTERN uint128_t mul(const uint128_t & lhs, const uint128_t & rhs, const unsigned scale, const fixed_rounding mode);
+    UINT128_T_EXTERN uint128_t div(const uint128_t & lhs, const uint128_t & rhs, const unsigned scale, const fixed_rounding mode);
+    UINT128_T_EXTERN uint128_t rescale(const uint128_t & raw, const unsigned from, const unsigned to, const fixed_rounding mode);
+
+    // raw = quotient * 10^scale + remainder
+    UINT128_T_EXTERN void split(const uint128_t & raw, const unsigned scale, uint128_t & quotient, uint128_t & remainder);
+
+    // writes at most 41 characters, not null terminated; returns the length
+    UINT128_T_EXTERN std::size_t format(const uint128_t & raw, const unsigned scale, char * out);
+
+    UINT128_T_EXTERN uint128_t parse(const char * str, const std::size_t len, const unsigned scale);
+}
+
+// a * b / c from the full 256 bit product, truncated or rounded
+UINT128_T_EXTERN uint128_t muldiv(const uint128_t & a, const uint128_t & b, const uint128_t & c);
+UINT128_T_EXTERN uint128_t muldiv_round(const uint128_t & a, const uint128_t & b, const uint128_t & c,
+                                        const fixed_rounding mode = fixed_rounding::half_even);
+
+template <unsigned Scale>
+class fixed128{
+    static_assert(Scale <= 38, "fixed128: 10^Scale has to fit in 128 bits");
+
+    private:
+        uint128_t RAW;
+
+    public:
+        static constexpr unsigned scale = Scale;
+
+        // 10^Scale, the raw value of 1
+        static constexpr uint64_t one_upper = fixed128_detail::pow10_upper(Scale);
+        static constexpr uint64_t one_lower = fixed128_detail::pow10_lower(Scale);
+
+        // longest string format() writes
+        static constexpr std::size_t max_length = 41;
+
+        constexpr fixed128()
+            : RAW(0)
+        {}
+
+        // integer value; throws std::overflow_error if it does not fit
+        explicit fixed128(const uint128_t & integer)
+            : RAW(fixed128_detail::from_integer(integer, Scale))
+        {}
+
+        // decimal string such as "12.345"
+        explicit fixed128(const std::string & str)
+            : RAW(fixed128_detail::parse(str.data(), str.size(), Scale))
+        {}
+
+        static fixed128 from_raw(const uint128_t & raw){
+            fixed128 out;
+            out.RAW = raw;
+            return out;
+        }
+
+        static fixed128 parse(const char * str, const std::size_t len){
+            return from_raw(fixed128_detail::parse(str, len, Scale));
+        }
+
+        static uint128_t one(){
+            return uint128_t(one_upper, one_lower);
+        }
+
+        const uint128_t & raw() const{
+            return RAW;
+        }
+
+        // whole part, truncated
+        uint128_t integer() const{
+            uint128_t quotient, remainder;
+            fixed128_detail::split(RAW, Scale, quotient, remainder);
+            return quotient;
+        }
+
+        // digits after the decimal point, as an integer below 10^Scale
+        uint128_t fraction() const{
+            uint128_t quotient, remainder;
+            fixed128_detail::split(RAW, Scale, quotient, remainder);
+            return remainder;
+        }
+
+        fixed128 mul(const fixed128 & rhs, const fixed_rounding mode = fixed_rounding::half_even) const{
+            return from_raw(fixed128_detail::mul(RAW, rhs.RAW, Scale, mode));
+        }
+
+        fixed128 div(const fixed128 & rhs, const fixed_rounding mode = fixed_rounding::half_even) const{
+            return from_raw(fixed128_detail::div(RAW, rhs.RAW, Scale, mode));
+        }
+
+        // same value at another scale, rounded if digits are dropped
+        template <unsigned To>
+        fixed128 <To> rescale(const fixed_rounding mode = fixed_rounding::half_even) const{
+            return fixed128 <To>::from_raw(fixed128_detail::rescale(RAW, Scale, To, mode));
+        }
+
+        // sums wrap around like uint128_t
+        fixed128 operator+(const fixed128 & rhs) const{ return from_raw(RAW + rhs.RAW); }
+        fixed128 operator-(const fixed128 & rhs) const{ return from_raw(RAW - rhs.RAW); }
+        fixed128 operator*(const fixed128 & rhs) const{ return mul(rhs); }
+        fixed128 operator/(const fixed128 & rhs) const{ return div(rhs); }
+
+        fixed128 & operator+=(const fixed128 & rhs){ RAW += rhs.RAW; return *this; }
+        fixed128 & operator-=(const fixed128 & rhs){ RAW -= rhs.RAW; return *this; }
+        fixed128 & operator*=(const fixed128 & rhs){ return *this = mul(rhs); }
+        fixed128 & operator/=(const fixed128 & rhs){ return *this = div(rhs); }
+
+        bool operator==(const fixed128 & rhs) const{ return RAW == rhs.RAW; }
+        bool operator!=(const fixed128 & rhs) const{ return RAW != rhs.RAW; }
+        bool operator< (const fixed128 & rhs) const{ return RAW <  rhs.RAW; }
+        bool operator<=(const fixed128 & rhs) const{ return RAW <= rhs.RAW; }
+        bool operator> (const fixed128 & rhs) const{ return RAW >  rhs.RAW; }
+        bool operator>=(const fixed128 & rhs) const{ return RAW >= rhs.RAW; }
+
+        // all Scale fractional digits are written
+        std::size_t format(char * out) const{
+            return fixed128_detail::format(RAW, Scale, out);
+        }
+
+        std::string str() const{
+            char buf[max_length];
+            return std::string(buf, format(buf));
+        }
+};
+
+template <unsigned Scale> constexpr unsigned    fixed128 <Scale>::scale;
+template <unsigned Scale> constexpr uint64_t    fixed128 <Scale>::one_upper;
+template <unsigned Scale> constexpr uint64_t    fixed128 <Scale>::one_lower;
+template <unsigned Scale> constexpr std::size_t fixed128 <Scale>::max_length;
+
+template <unsigned Scale>
+std::ostream & operator<<(std::ostream & stream, const fixed128 <Scale> & rhs){
+    return stream << rhs.str();
+}
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_fixed.cpp"
+#endif
+
+#endif
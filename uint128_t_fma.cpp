@@ -0,0 +1,46 @@
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_fma.h"
+#include "uint128_t_intrinsics.include"
+
+UINT128_T_INLINE bool fma(uint128_t & acc, const uint64_t a, const uint64_t b){
+    uint64_t hi;
+    const uint64_t lo = uint128_detail::mul64(a, b, hi);
+    uint64_t carry = 0;
+    const uint64_t sum_lo = uint128_detail::addc64(acc.lower(), lo, carry);
+    const uint64_t sum_hi = uint128_detail::addc64(acc.upper(), hi, carry);
+    acc = uint128_t(sum_hi, sum_lo);
+    return carry;
+}
+
+UINT128_T_INLINE bool fma(uint128_wide & acc, const uint128_t & a, const uint128_t & b){
+    uint64_t p[4];
+    uint128_detail::mul128(a.upper(), a.lower(), b.upper(), b.lower(), p);
+    uint64_t carry = 0;
+    const uint64_t w0 = uint128_detail::addc64(acc.lower.lower(), p[3], carry);
+    const uint64_t w1 = uint128_detail::addc64(acc.lower.upper(), p[2], carry);
+    const uint64_t w2 = uint128_detail::addc64(acc.upper.lower(), p[1], carry);
+    const uint64_t w3 = uint128_detail::addc64(acc.upper.upper(), p[0], carry);
+    acc.upper = uint128_t(w3, w2);
+    acc.lower = uint128_t(w1, w0);
+    return carry;
+}
+
+UINT128_T_INLINE uint128_wide mul_wide(const uint128_t & a, const uint128_t & b){
+    uint64_t p[4];
+    uint128_detail::mul128(a.upper(), a.lower(), b.upper(), b.lower(), p);
+    return uint128_wide{uint128_t(p[0], p[1]), uint128_t(p[2], p[3])};
+}
+
+UINT128_T_INLINE uint128_t dot(const uint64_t * a, const uint64_t * b, std::size_t n){
+    uint64_t sum[3];
+    uint128_active_kernels().dot(a, b, n, sum);
+    return uint128_t(sum[1], sum[2]);
+}
+
+UINT128_T_INLINE uint128_t dot(const uint64_t * a, const uint64_t * b, std::size_t n, uint64_t & overflow){
+    uint64_t sum[3];
+    uint128_active_kernels().dot(a, b, n, sum);
+    overflow = sum[0];
+    return uint128_t(sum[1], sum[2]);
+}
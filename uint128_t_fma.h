@@ -0,0 +1,41 @@
+// PUBLIC IMPORT HEADER
+// Fused multiply-add and dot products into wide accumulators
+//
+//     fma(acc, a, b)  - acc += a * b without building uint128_t temporaries;
+//                       64 x 64 + 128 and 128 x 128 + 256 bit forms
+//     dot(a, b, n)    - sum of a[i] * b[i] over uint64_t arrays, modulo 2^128,
+//                       or with the bits above 128 returned separately
+//
+// dot goes through the dispatch table; the bmi2 and higher kernels run two
+// independent ADCX/ADOX carry chains over MULX products.
+#ifndef _UINT128_T_FMA_H_
+#define _UINT128_T_FMA_H_
+
+#include <cstddef>
+
+#include "uint128_t.h"
+
+// 256 bit accumulator for the 128 x 128 bit products
+struct uint128_wide{
+    uint128_t upper;
+    uint128_t lower;
+};
+
+// acc += a * b; returns true if the sum wrapped around
+UINT128_T_EXTERN bool fma(uint128_t & acc, const uint64_t a, const uint64_t b);
+UINT128_T_EXTERN bool fma(uint128_wide & acc, const uint128_t & a, const uint128_t & b);
+
+// full 128 x 128 -> 256 bit product
+UINT128_T_EXTERN uint128_wide mul_wide(const uint128_t & a, const uint128_t & b);
+
+// sum of a[i] * b[i], modulo 2^128
+UINT128_T_EXTERN uint128_t dot(const uint64_t * a, const uint64_t * b, std::size_t n);
+
+// sum of a[i] * b[i] as a 192 bit value: bits 128 to 191 are written to overflow
+UINT128_T_EXTERN uint128_t dot(const uint64_t * a, const uint64_t * b, std::size_t n, uint64_t & overflow);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_fma.cpp"
+#endif
+
+#endif
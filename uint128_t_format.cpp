@@ -0,0 +1,77 @@
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_format.h"
+
+#include <climits>
+#include <cstring>
+
+UINT128_T_INLINE std::size_t uint128_format_body(const uint128_t & value, const uint128_format_spec & spec,
+                                                 const char * grouping, const char separator,
+                                                 char * out, std::size_t & prefix){
+    uint8_t base = 10;
+    switch (spec.type){
+        case 'b': case 'B': base = 2;  break;
+        case 'o':           base = 8;  break;
+        case 'x': case 'X': base = 16; break;
+        default:                       break;
+    }
+
+    char * p = out;
+    if (spec.sign){
+        *p++ = spec.sign;
+    }
+    if (spec.alternate){
+        switch (spec.type){
+            case 'b': case 'B': case 'x': case 'X':
+                *p++ = '0';
+                *p++ = spec.type;
+                break;
+            case 'o':
+                // 0 is already written with a leading zero
+                if (value){
+                    *p++ = '0';
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    prefix = p - out;
+
+    char digits[128];
+    const std::size_t size = uint128_active_kernels().format(value, base, digits);
+    if (spec.type == 'X'){
+        for(std::size_t i = 0; i < size; i++){
+            if (digits[i] >= 'a'){
+                digits[i] -= 'a' - 'A';
+            }
+        }
+    }
+
+    if (!spec.locale || !grouping || (*grouping <= 0) || (*grouping == CHAR_MAX)){
+        std::memcpy(p, digits, size);
+        return prefix + size;
+    }
+
+    // group from the least significant digit; the last group size repeats,
+    // and a size of 0 or CHAR_MAX ends the grouping
+    char grouped[255];
+    char * g = grouped + sizeof(grouped);
+    unsigned group = (unsigned char) *grouping, count = 0;
+    for(std::size_t i = size; i > 0; i--){
+        if (group && (count == group)){
+            *--g = separator;
+            count = 0;
+            if (grouping[1]){
+                grouping++;
+                group = ((*grouping <= 0) || (*grouping == CHAR_MAX))?0:(unsigned char) *grouping;
+            }
+        }
+        *--g = digits[i - 1];
+        count++;
+    }
+
+    const std::size_t length = grouped + sizeof(grouped) - g;
+    std::memcpy(p, g, length);
+    return prefix + length;
+}
@@ -0,0 +1,291 @@
+// PUBLIC IMPORT HEADER
+// std::format and {fmt} support for uint128_t
+//
+//     std::format("{:#018x}", value);
+//     fmt::format("{:>40L}", value);
+//
+// The full integer format specification is accepted:
+//
+//     [[fill]align][sign]['#']['0'][width]['L'][type]
+//
+// with type one of b, B, o, d, x or X. The text is built on the stack and
+// handed to the output iterator in one piece; nothing is allocated unless 'L'
+// asks for the locale's digit grouping. Widths given as nested replacement
+// fields ({:{}}) are not supported.
+//
+// std::formatter <uint128_t> is defined when the standard library provides
+// <format>. fmt::formatter <uint128_t> is defined when {fmt} has been included
+// before this header, or when UINT128_T_FMT is defined (which includes
+// <fmt/format.h>). Both use the same parser and writer, which can also be
+// called directly.
+#ifndef _UINT128_T_FORMAT_H_
+#define _UINT128_T_FORMAT_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "uint128_t.h"
+
+struct uint128_format_spec{
+    // longest output before padding: sign, 0b prefix, 128 digits and 127 separators
+    static constexpr std::size_t max_length = 258;
+
+    char fill[4];           // one UTF-8 encoded character
+    uint8_t fill_size;
+    char align;             // '<', '>', '^' or 0 for the default (right)
+    char sign;              // '+', ' ' or 0
+    bool alternate;         // '#': 0b, 0, 0x prefixes
+    bool zero_pad;          // '0': pad with zeros after the prefix
+    bool locale;            // 'L': group digits like the locale does
+    char type;              // 'b', 'B', 'o', 'd', 'x', 'X' or 0 for 'd'
+    unsigned width;
+
+    constexpr uint128_format_spec()
+        : fill{' ', 0, 0, 0}, fill_size(1), align(0), sign(0), alternate(false),
+          zero_pad(false), locale(false), type(0), width(0)
+    {}
+};
+
+namespace uint128_format_detail {
+    constexpr bool is_align(const char c){
+        return (c == '<') || (c == '>') || (c == '^');
+    }
+
+    constexpr bool is_type(const char c){
+        return (c == 'b') || (c == 'B') || (c == 'o') || (c == 'd') || (c == 'x') || (c == 'X');
+    }
+
+    // length of the UTF-8 sequence starting with c
+    constexpr unsigned char_size(const char c){
+        return (((unsigned char) c & 0xe0) == 0xc0)?2:
+               (((unsigned char) c & 0xf0) == 0xe0)?3:
+               (((unsigned char) c & 0xf8) == 0xf0)?4:
+               1;
+    }
+}
+
+// Parses the part of a replacement field after the ':' up to the closing
+// '}' (or end). Returns a pointer to where parsing stopped, or nullptr if
+// the specification is not valid for an integer.
+UINT128_T_CONSTEXPR14 const char * uint128_parse_format_spec(const char * it, const char * end, uint128_format_spec & spec){
+    using namespace uint128_format_detail;
+
+    if ((it == end) || (*it == '}')){
+        return it;
+    }
+
+    // fill and alignment
+    const unsigned size = char_size(*it);
+    if (((std::size_t) (end - it) > size) && is_align(it[size])){
+        if ((*it == '{') || (*it == '}')){
+            return nullptr;
+        }
+        for(unsigned i = 0; i < size; i++){
+            spec.fill[i] = it[i];
+        }
+        spec.fill_size = (uint8_t) size;
+        spec.align = it[size];
+        it += size + 1;
+    }
+    else if (is_align(*it)){
+        spec.align = *it++;
+    }
+
+    if ((it != end) && ((*it == '+') || (*it == '-') || (*it == ' '))){
+        spec.sign = (*it == '-')?0:*it;
+        it++;
+    }
+
+    if ((it != end) && (*it == '#')){
+        spec.alternate = true;
+        it++;
+    }
+
+    if ((it != end) && (*it == '0')){
+        spec.zero_pad = true;
+        it++;
+    }
+
+    while ((it != end) && (*it >= '0') && (*it <= '9')){
+        if (spec.width > 100000000){
+            return nullptr;
+        }
+        spec.width = spec.width * 10 + (unsigned) (*it++ - '0');
+    }
+
+    // integers take no precision, and dynamic widths are not supported
+    if ((it != end) && ((*it == '.') || (*it == '{'))){
+        return nullptr;
+    }
+
+    if ((it != end) && (*it == 'L')){
+        spec.locale = true;
+        it++;
+    }
+
+    if ((it != end) && is_type(*it)){
+        spec.type = *it++;
+    }
+
+    if ((it != end) && (*it != '}')){
+        return nullptr;
+    }
+    return it;
+}
+
+// Writes the sign, base prefix and digits of value to out (at least
+// uint128_format_spec::max_length chars) and returns how many were written.
+// prefix is set to the length of the sign and base prefix, where zero
+// padding goes. grouping and separator are as in std::numpunct and only used
+// when spec.locale is set.
+UINT128_T_EXTERN std::size_t uint128_format_body(const uint128_t & value, const uint128_format_spec & spec,
+                                                 const char * grouping, const char separator,
+                                                 char * out, std::size_t & prefix);
+
+namespace uint128_format_detail {
+    template <typename OutputIt>
+    OutputIt fill(OutputIt out, const std::size_t count, const uint128_format_spec & spec){
+        if (spec.fill_size == 1){
+            return std::fill_n(out, count, spec.fill[0]);
+        }
+        for(std::size_t i = 0; i < count; i++){
+            out = std::copy(spec.fill, spec.fill + spec.fill_size, out);
+        }
+        return out;
+    }
+}
+
+// formats value according to spec into an output iterator
+template <typename OutputIt>
+OutputIt uint128_format_to(OutputIt out, const uint128_t & value, const uint128_format_spec & spec,
+                           const char * grouping = "", const char separator = ','){
+    char body[uint128_format_spec::max_length];
+    std::size_t prefix = 0;
+    const std::size_t size = uint128_format_body(value, spec, grouping, separator, body, prefix);
+
+    std::size_t left = 0, zeros = 0, right = 0;
+    if (spec.width > size){
+        const std::size_t pad = spec.width - size;
+        if (!spec.align && spec.zero_pad){
+            zeros = pad;
+        }
+        else if (spec.align == '<'){
+            right = pad;
+        }
+        else if (spec.align == '^'){
+            left = pad / 2;
+            right = pad - left;
+        }
+        else{
+            left = pad;
+        }
+    }
+
+    out = uint128_format_detail::fill(out, left, spec);
+    out = std::copy(body, body + prefix, out);
+    out = std::fill_n(out, zeros, '0');
+    out = std::copy(body + prefix, body + size, out);
+    return uint128_format_detail::fill(out, right, spec);
+}
+
+#if defined(__has_include)
+  #if __has_include(<version>)
+    #include <version>
+  #endif
+#endif
+
+#if defined(__cpp_lib_format)
+#include <format>
+#include <locale>
+#include <memory>
+#include <string>
+#include <string_view>
+
+template <>
+struct std::formatter <uint128_t, char>{
+    uint128_format_spec spec;
+
+    constexpr std::format_parse_context::iterator parse(std::format_parse_context & ctx){
+        if (ctx.begin() == ctx.end()){
+            return ctx.begin();
+        }
+        const char * begin = std::to_address(ctx.begin());
+        const char * end = uint128_parse_format_spec(begin, begin + (ctx.end() - ctx.begin()), spec);
+        if (!end){
+            throw std::format_error("invalid format specification for uint128_t");
+        }
+        return ctx.begin() + (end - begin);
+    }
+
+    template <typename FormatContext>
+    typename FormatContext::iterator format(const uint128_t & value, FormatContext & ctx) const{
+        std::string grouping;
+        char separator = ',';
+        if (spec.locale){
+            const std::numpunct <char> & punct = std::use_facet <std::numpunct <char> > (ctx.locale());
+            grouping = punct.grouping();
+            separator = punct.thousands_sep();
+        }
+
+        // format into a local buffer and hand it over in one piece
+        if (spec.width <= uint128_format_spec::max_length){
+            char buf[uint128_format_spec::max_length * 4];
+            const char * end = uint128_format_to(buf, value, spec, grouping.c_str(), separator);
+            return std::formatter <std::string_view, char> ().format(std::string_view(buf, end - buf), ctx);
+        }
+        return uint128_format_to(ctx.out(), value, spec, grouping.c_str(), separator);
+    }
+};
+#endif
+
+#if defined(UINT128_T_FMT)
+  #include <fmt/format.h>
+#endif
+
+#if defined(FMT_VERSION)
+#include <locale>
+#include <string>
+
+template <>
+struct fmt::formatter <uint128_t>{
+    uint128_format_spec spec;
+
+    UINT128_T_CONSTEXPR14 auto parse(fmt::format_parse_context & ctx) -> decltype(ctx.begin()){
+        if (ctx.begin() == ctx.end()){
+            return ctx.begin();
+        }
+        const char * begin = &*ctx.begin();
+        const char * end = uint128_parse_format_spec(begin, begin + (ctx.end() - ctx.begin()), spec);
+        if (!end){
+            throw fmt::format_error("invalid format specification for uint128_t");
+        }
+        return ctx.begin() + (end - begin);
+    }
+
+    template <typename FormatContext>
+    auto format(const uint128_t & value, FormatContext & ctx) const -> decltype(ctx.out()){
+        std::string grouping;
+        char separator = ',';
+        if (spec.locale){
+            const std::locale loc = ctx.locale().template get <std::locale> ();
+            const std::numpunct <char> & punct = std::use_facet <std::numpunct <char> > (loc);
+            grouping = punct.grouping();
+            separator = punct.thousands_sep();
+        }
+
+        // format into a local buffer and hand it over in one piece
+        if (spec.width <= uint128_format_spec::max_length){
+            char buf[uint128_format_spec::max_length * 4];
+            const char * end = uint128_format_to(buf, value, spec, grouping.c_str(), separator);
+            return fmt::formatter <fmt::string_view> ().format(fmt::string_view(buf, end - buf), ctx);
+        }
+        return uint128_format_to(ctx.out(), value, spec, grouping.c_str(), separator);
+    }
+};
+#endif
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_format.cpp"
+#endif
+
+#endif
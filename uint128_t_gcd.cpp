@@ -0,0 +1,207 @@
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_gcd.h"
+#include "uint128_t_intrinsics.include"
+
+// significant bits of hi:lo
+static inline unsigned gcd_width(const uint64_t hi, const uint64_t lo){
+    return hi ? 128 - uint128_detail::clz64(hi) : lo ? 64 - uint128_detail::clz64(lo) : 0;
+}
+
+// trailing zeros of hi:lo, which must not be 0
+static inline unsigned gcd_ctz(const uint64_t hi, const uint64_t lo){
+    return lo ? uint128_detail::ctz64(lo) : 64 + uint128_detail::ctz64(hi);
+}
+
+// hi:lo >>= its trailing zeros; hi:lo must not be 0
+static inline void gcd_strip(uint64_t & hi, uint64_t & lo){
+    if (!lo){
+        lo = hi;
+        hi = 0;
+    }
+    const unsigned s = uint128_detail::ctz64(lo);
+    if (s){
+        lo = (lo >> s) | (hi << (64 - s));
+        hi >>= s;
+    }
+}
+
+// gcd of two odd values: |u - v| is even, so each step strips at least one bit
+static inline uint64_t gcd_odd64(uint64_t u, uint64_t v){
+    while (u != v){
+        const uint64_t d = v - u;
+        const uint64_t m = (u < v) ? u : v;
+        v = ((u > v) ? u - v : d) >> uint128_detail::ctz64(d);
+        u = m;
+    }
+    return u;
+}
+
+UINT128_T_INLINE uint128_t gcd(const uint128_t & a, const uint128_t & b){
+    if (!(a.upper() | a.lower())){
+        return b;
+    }
+    if (!(b.upper() | b.lower())){
+        return a;
+    }
+
+    // a division evens out operands of very different widths, which the
+    // binary steps would take one bit at a time
+    uint128_t x = a, y = b;
+    const unsigned x_bits = gcd_width(x.upper(), x.lower()), y_bits = gcd_width(y.upper(), y.lower());
+    if (x_bits > y_bits + 32){
+        x %= y;
+    }
+    else if (y_bits > x_bits + 32){
+        y %= x;
+    }
+
+    uint64_t x_hi = x.upper(), x_lo = x.lower(), y_hi = y.upper(), y_lo = y.lower();
+    if (!(x_hi | x_lo)){
+        return y;
+    }
+    if (!(y_hi | y_lo)){
+        return x;
+    }
+
+    // gcd(2^k x, 2^k y) = 2^k gcd(x, y), and with x odd the factors of 2 in y do not matter
+    const unsigned k = gcd_ctz(x_hi | y_hi, x_lo | y_lo);
+    gcd_strip(x_hi, x_lo);
+    gcd_strip(y_hi, y_lo);
+
+    // the smaller one and the difference, until both fit in 64 bits
+    while (x_hi | y_hi){
+        if ((x_hi == y_hi) && (x_lo == y_lo)){
+            return uint128_t(x_hi, x_lo) << k;
+        }
+        const bool swap = (y_hi < x_hi) || ((y_hi == x_hi) && (y_lo < x_lo));
+        uint64_t borrow = 0, d_hi, d_lo;
+        if (swap){
+            d_lo = uint128_detail::subb64(x_lo, y_lo, borrow);
+            d_hi = uint128_detail::subb64(x_hi, y_hi, borrow);
+            x_hi = y_hi;
+            x_lo = y_lo;
+        }
+        else{
+            d_lo = uint128_detail::subb64(y_lo, x_lo, borrow);
+            d_hi = uint128_detail::subb64(y_hi, x_hi, borrow);
+        }
+        gcd_strip(d_hi, d_lo);
+        y_hi = d_hi;
+        y_lo = d_lo;
+    }
+
+    return uint128_t(gcd_odd64(x_lo, y_lo)) << k;
+}
+
+UINT128_T_INLINE uint128_t lcm(const uint128_t & a, const uint128_t & b){
+    if (!(a.upper() | a.lower()) || !(b.upper() | b.lower())){
+        return 0;
+    }
+    const uint128_t q = a / gcd(a, b);
+    uint64_t p[4];
+    uint128_detail::mul128(q.upper(), q.lower(), b.upper(), b.lower(), p);
+    if (p[0] | p[1]){
+        throw std::overflow_error("Error: lcm does not fit in 128 bits");
+    }
+    return uint128_t(p[2], p[3]);
+}
+
+UINT128_T_INLINE uint128_bezout ext_gcd(const uint128_t & a, const uint128_t & b){
+    // u = a x0 + b y0 and v = a x1 + b y1, modulo 2^128; the Bezout
+    // coefficients are small enough that the result is exact
+    const bool swap = a < b;
+    uint128_t u = swap ? b : a, v = swap ? a : b;
+    uint128_t x0 = !swap, y0 = swap, x1 = swap, y1 = !swap;
+
+    while (v.upper()){
+        // Euclid's steps on the leading 62 bits (Knuth, TAOCP 4.5.2 algorithm L):
+        // a quotient is certain when both ends of the range it could take agree
+        const unsigned s = gcd_width(u.upper(), u.lower()) - 62;
+        int64_t uh = (int64_t) (u >> s).lower(), vh = (int64_t) (v >> s).lower();
+        int64_t A = 1, B = 0, C = 0, D = 1;
+        while ((vh + C) && (vh + D)){
+            const int64_t q = (uh + A) / (vh + C);
+            if (q != (uh + B) / (vh + D)){
+                break;
+            }
+            int64_t t = A - q * C;
+            A = C;
+            C = t;
+            t = B - q * D;
+            B = D;
+            D = t;
+            t = uh - q * vh;
+            uh = vh;
+            vh = t;
+        }
+
+        if (!B){
+            // no step was certain: one full division
+            const uint128_t q = u / v;
+            uint128_t t = u - q * v;
+            u = v;
+            v = t;
+            t = x0 - q * x1;
+            x0 = x1;
+            x1 = t;
+            t = y0 - q * y1;
+            y0 = y1;
+            y1 = t;
+        }
+        else{
+            uint128_t t = u * A + v * B;
+            v = u * C + v * D;
+            u = t;
+            t = x0 * A + x1 * B;
+            x1 = x0 * C + x1 * D;
+            x0 = t;
+            t = y0 * A + y1 * B;
+            y1 = y0 * C + y1 * D;
+            y0 = t;
+        }
+    }
+
+    // v fits in 64 bits: one step leaves u there too, then hardware divisions
+    if (v){
+        const uint128_t q = u / v;
+        const uint128_t t = u - q * v;
+        u = v;
+        v = t;
+        uint128_t c = x0 - q * x1;
+        x0 = x1;
+        x1 = c;
+        c = y0 - q * y1;
+        y0 = y1;
+        y1 = c;
+    }
+    uint64_t uu = u.lower(), vv = v.lower();
+    while (vv){
+        const uint64_t q = uu / vv;
+        const uint64_t t = uu - q * vv;
+        uu = vv;
+        vv = t;
+        uint128_t c = x0 - x1 * q;
+        x0 = x1;
+        x1 = c;
+        c = y0 - y1 * q;
+        y0 = y1;
+        y1 = c;
+    }
+
+    return uint128_bezout{uint128_t(u.upper(), uu), x0, y0};
+}
+
+UINT128_T_INLINE bool mod_inverse(const uint128_t & a, const uint128_t & m, uint128_t & inverse){
+    if (!(m.upper() | m.lower())){
+        return false;
+    }
+    const uint128_bezout r = ext_gcd(a % m, m);
+    if ((r.gcd.upper() != 0) || (r.gcd.lower() != 1)){
+        return false;
+    }
+    // |x| < m, so a negative x needs one m added
+    inverse = (r.x.upper() >> 63) ? r.x + m : r.x;
+    return true;
+}
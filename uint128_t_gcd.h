@@ -0,0 +1,43 @@
+// PUBLIC IMPORT HEADER
+// Greatest common divisor, least common multiple and extended Euclid
+//
+//     gcd(a, b)          - binary GCD (Stein): shifts by the trailing zero
+//                          count instead of dividing, on 64 bit limbs
+//     lcm(a, b)          - throws std::overflow_error past 128 bits
+//     ext_gcd(a, b)      - gcd and Bezout coefficients x, y with
+//                          a * x + b * y = gcd, by Lehmer's algorithm
+//     mod_inverse(a, m)  - a^-1 modulo m, from ext_gcd
+//
+// Lehmer's algorithm runs Euclid's steps on the leading 62 bits in machine
+// words and applies the collected steps to the full values at once, so
+// operands wider than 64 bits take a few 128 bit updates instead of a
+// division per step.
+#ifndef _UINT128_T_GCD_H_
+#define _UINT128_T_GCD_H_
+
+#include "uint128_t.h"
+
+// x and y are signed, in two's complement (negative when bit 127 is set);
+// they are the ones Euclid's algorithm gives, no larger than 2^127
+struct uint128_bezout{
+    uint128_t gcd;
+    uint128_t x;
+    uint128_t y;
+};
+
+// gcd(0, 0) is 0
+UINT128_T_EXTERN uint128_t gcd(const uint128_t & a, const uint128_t & b);
+
+// lcm(a, 0) is 0
+UINT128_T_EXTERN uint128_t lcm(const uint128_t & a, const uint128_t & b);
+
+UINT128_T_EXTERN uint128_bezout ext_gcd(const uint128_t & a, const uint128_t & b);
+
+// returns false if a and m are not coprime or m is 0
+UINT128_T_EXTERN bool mod_inverse(const uint128_t & a, const uint128_t & m, uint128_t & inverse);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_gcd.cpp"
+#endif
+
+#endif
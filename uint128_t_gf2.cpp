@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_gf2.h"
+
+UINT128_T_INLINE uint128_wide clmul(const uint128_t & a, const uint128_t & b){
+    uint64_t p[4];
+    uint128_active_kernels().clmul(a, b, p);
+    return uint128_wide{uint128_t(p[0], p[1]), uint128_t(p[2], p[3])};
+}
+
+UINT128_T_INLINE gf2_128 gf2_128::load(const unsigned char * block){
+    uint64_t hi = 0, lo = 0;
+    for(unsigned i = 0; i < 8; i++){
+        hi = (hi << 8) | block[i];
+        lo = (lo << 8) | block[i + 8];
+    }
+    return gf2_128(uint128_t(hi, lo));
+}
+
+UINT128_T_INLINE void gf2_128::store(unsigned char * block) const{
+    for(unsigned i = 0; i < 8; i++){
+        block[i]     = (unsigned char) (VALUE.upper() >> (56 - 8 * i));
+        block[i + 8] = (unsigned char) (VALUE.lower() >> (56 - 8 * i));
+    }
+}
+
+UINT128_T_INLINE gf2_128 gf2_128::operator*(const gf2_128 & rhs) const{
+    return gf2_128(uint128_active_kernels().gf2_mul(VALUE, rhs.VALUE));
+}
+
+UINT128_T_INLINE gf2_128 & gf2_128::operator*=(const gf2_128 & rhs){
+    VALUE = uint128_active_kernels().gf2_mul(VALUE, rhs.VALUE);
+    return *this;
+}
+
+UINT128_T_INLINE gf2_128 gf2_128::square() const{
+    return *this * *this;
+}
+
+UINT128_T_INLINE gf2_128 gf2_128::inverse() const{
+    if (!VALUE){
+        throw std::domain_error("Error: 0 has no inverse in GF(2^128)");
+    }
+
+    // a^-1 = a^(2^128 - 2) (Itoh and Tsujii): with b_k = a^(2^k - 1),
+    // b_2k = b_k^(2^k) * b_k and b_(2k + 1) = b_2k^2 * a, so k runs through
+    // 1, 3, 7, ..., 127 in 127 squarings and 12 multiplications
+    gf2_128 b = *this;
+    for(unsigned k = 1; k < 127; k = 2 * k + 1){
+        const gf2_128 bk = b;
+        for(unsigned i = 0; i < k; i++){
+            b = b.square();
+        }
+        b = (b * bk).square() * *this;
+    }
+
+    // a^(2^128 - 2) = (a^(2^127 - 1))^2
+    return b.square();
+}
+
+UINT128_T_INLINE gf2_128 ghash(const gf2_128 & h, const void * data, std::size_t blocks, const gf2_128 & acc){
+    uint128_t x = acc.value();
+    uint128_active_kernels().ghash_n(h.value(), x, static_cast <const unsigned char *> (data), blocks);
+    return gf2_128(x);
+}
+
+UINT128_T_INLINE gf2_128 ghash(const gf2_128 & h, const gf2_128 * blocks, std::size_t count, const gf2_128 & acc){
+    // the kernels read bytes, so the elements go through a buffer
+    unsigned char buffer[16 * 64];
+    uint128_t x = acc.value();
+    while (count){
+        const std::size_t n = std::min <std::size_t> (count, 64);
+        for(std::size_t i = 0; i < n; i++){
+            blocks[i].store(buffer + 16 * i);
+        }
+        uint128_active_kernels().ghash_n(h.value(), x, buffer, n);
+        blocks += n;
+        count -= n;
+    }
+    return gf2_128(x);
+}
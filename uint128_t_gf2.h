@@ -0,0 +1,97 @@
+// PUBLIC IMPORT HEADER
+// Carry-less multiplication and arithmetic in GCM's GF(2^128)
+//
+//     clmul(a, b)          - 256 bit carry-less (polynomial over GF(2)) product
+//     gf2_128              - element of GF(2^128) modulo x^128 + x^7 + x^2 + x + 1
+//                            with +, *, square() and inverse()
+//     ghash(h, data, n)    - GHASH over n 16 byte blocks: acc = (acc + block) * h
+//
+// gf2_128 uses the bit order of the GCM specification (NIST SP 800-38D): a
+// 16 byte block is read big endian, and the coefficient of x^0 is bit 127,
+// the top bit of the first byte. clmul uses the plain order, bit i being x^i.
+//
+// The work goes through the dispatch table: the bmi2 and higher kernels use
+// PCLMULQDQ and ghash reduces once per 4 blocks with H^2, H^3 and H^4; the
+// generic kernel uses Shoup's 4 bit tables.
+#ifndef _UINT128_T_GF2_H_
+#define _UINT128_T_GF2_H_
+
+#include <cstddef>
+
+#include "uint128_t.h"
+#include "uint128_t_fma.h"
+
+UINT128_T_EXTERN uint128_wide clmul(const uint128_t & a, const uint128_t & b);
+
+class UINT128_T_EXTERN gf2_128{
+    private:
+        uint128_t VALUE;
+
+    public:
+        gf2_128()
+            : VALUE(0)
+        {}
+
+        explicit gf2_128(const uint128_t & value)
+            : VALUE(value)
+        {}
+
+        // the multiplicative identity, x^0
+        static gf2_128 one(){
+            return gf2_128(uint128_t(0x8000000000000000ULL, 0));
+        }
+
+        // 16 bytes, big endian
+        static gf2_128 load(const unsigned char * block);
+        void store(unsigned char * block) const;
+
+        const uint128_t & value() const{
+            return VALUE;
+        }
+
+        // addition and subtraction are both xor
+        gf2_128 operator+(const gf2_128 & rhs) const{
+            return gf2_128(VALUE ^ rhs.VALUE);
+        }
+
+        gf2_128 operator-(const gf2_128 & rhs) const{
+            return gf2_128(VALUE ^ rhs.VALUE);
+        }
+
+        gf2_128 & operator+=(const gf2_128 & rhs){
+            VALUE ^= rhs.VALUE;
+            return *this;
+        }
+
+        gf2_128 & operator-=(const gf2_128 & rhs){
+            VALUE ^= rhs.VALUE;
+            return *this;
+        }
+
+        gf2_128 operator*(const gf2_128 & rhs) const;
+        gf2_128 & operator*=(const gf2_128 & rhs);
+
+        gf2_128 square() const;
+
+        // throws std::domain_error for 0
+        gf2_128 inverse() const;
+
+        bool operator==(const gf2_128 & rhs) const{
+            return VALUE == rhs.VALUE;
+        }
+
+        bool operator!=(const gf2_128 & rhs) const{
+            return VALUE != rhs.VALUE;
+        }
+};
+
+// GHASH of blocks 16 byte blocks starting from acc; GCM's tag feeds it the
+// padded additional data, the padded ciphertext and the length block
+UINT128_T_EXTERN gf2_128 ghash(const gf2_128 & h, const void * data, std::size_t blocks, const gf2_128 & acc = gf2_128());
+UINT128_T_EXTERN gf2_128 ghash(const gf2_128 & h, const gf2_128 * blocks, std::size_t count, const gf2_128 & acc = gf2_128());
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_gf2.cpp"
+#endif
+
+#endif
@@ -0,0 +1,307 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_ipv6.h"
+
+// 0-15 for a hex digit, 16 otherwise
+static inline unsigned ipv6_hex_digit(const char c){
+    const unsigned d = (unsigned) (unsigned char) c - '0';
+    if (d < 10){
+        return d;
+    }
+    const unsigned a = ((unsigned) (unsigned char) c | 0x20) - 'a';
+    return (a < 6) ? a + 10 : 16;
+}
+
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+  #define UINT128_T_IPV6_SWAR
+#endif
+
+#if defined(UINT128_T_IPV6_SWAR)
+// Reads the hex digits at the start of 8 readable bytes, 8 at a time. Every
+// byte is classified as digit or letter with carry-free range checks, the
+// run length comes from the first byte that is neither, and the group value
+// is assembled from the nibbles without a loop. Returns the number of digits;
+// value is only meaningful for 1 to 4 of them.
+static inline unsigned ipv6_hex_group(const char * p, unsigned & value){
+    const uint64_t ONES = 0x0101010101010101ULL;
+    const uint64_t HIGH = 0x8080808080808080ULL;
+
+    uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    const uint64_t ascii = x & ~HIGH;
+    const uint64_t lower = ascii | (0x20 * ONES);
+    const uint64_t digit  = (ascii + 0x50 * ONES) & ~(ascii + 0x46 * ONES);     // '0' to '9'
+    const uint64_t letter = (lower + 0x1f * ONES) & ~(lower + 0x19 * ONES);     // 'a' to 'f', either case
+    const uint64_t stop = (~(digit | letter) | x) & HIGH;
+    const unsigned length = stop ? (uint128_detail::ctz64(stop) / 8) : 8;
+
+    if (length <= 4){
+        // nibble per byte, first digit lowest; shifted so the last digit is byte 3
+        const uint64_t nibbles = (x & (0x0f * ONES)) + ((x >> 6) & ONES) * 9;
+        const uint64_t w = (nibbles << (8 * (4 - length))) & 0xffffffffULL;
+        const uint64_t pairs = ((w << 4) + (w >> 8)) & 0x00ff00ffULL;
+        value = (unsigned) (((pairs & 0xff) << 8) | (pairs >> 16));
+    }
+    return length;
+}
+#endif
+
+// dotted quad filling [p, end) exactly; leading zeros are rejected like inet_pton does
+static bool ipv6_parse_ipv4(const char * p, const char * end, uint32_t & value){
+    value = 0;
+    for(unsigned octet = 0; octet < 4; octet++){
+        if (octet){
+            if ((p == end) || (*p != '.')){
+                return false;
+            }
+            p++;
+        }
+        unsigned v = 0, digits = 0;
+        while ((p != end) && ((unsigned) (*p - '0') < 10) && (digits < 3)){
+            v = v * 10 + (unsigned) (*p++ - '0');
+            digits++;
+        }
+        if (!digits || (v > 255) || ((digits > 1) && (p[-(int) digits] == '0'))){
+            return false;
+        }
+        value = (value << 8) | v;
+    }
+    return p == end;
+}
+
+UINT128_T_INLINE bool ipv6_parse(const char * str, const std::size_t len, uint128_t & addr){
+    const char * p = str;
+    const char * const end = str + len;
+
+    uint16_t groups[8];
+    unsigned n = 0;
+    int gap = -1;       // index of the group :: stands in front of
+
+    if ((len >= 2) && (p[0] == ':') && (p[1] == ':')){
+        gap = 0;
+        p += 2;
+    }
+
+    while (p != end){
+        const char * start = p;
+        unsigned value = 0, digits = 0, d;
+        #if defined(UINT128_T_IPV6_SWAR)
+        if (end - p >= 8){
+            digits = ipv6_hex_group(p, value);
+            p += digits;
+        }
+        else
+        #endif
+        while ((p != end) && (digits < 5) && ((d = ipv6_hex_digit(*p)) < 16)){
+            value = (value << 4) | d;
+            digits++;
+            p++;
+        }
+
+        // the last 32 bits may be written as an IPv4 address
+        if ((p != end) && (*p == '.')){
+            uint32_t v4;
+            if ((n > 6) || !ipv6_parse_ipv4(start, end, v4)){
+                return false;
+            }
+            groups[n++] = (uint16_t) (v4 >> 16);
+            groups[n++] = (uint16_t) v4;
+            break;
+        }
+
+        if (!digits || (digits > 4) || (n == 8)){
+            return false;
+        }
+        groups[n++] = (uint16_t) value;
+
+        if (p == end){
+            break;
+        }
+        if ((*p++ != ':') || (p == end)){
+            return false;
+        }
+        if (*p == ':'){
+            if (gap >= 0){
+                return false;
+            }
+            gap = (int) n;
+            p++;
+        }
+    }
+
+    // :: stands for at least one group
+    if ((gap < 0) ? (n != 8) : (n > 7)){
+        return false;
+    }
+
+    uint16_t full[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    if (gap < 0){
+        std::memcpy(full, groups, sizeof(full));
+    }
+    else{
+        const unsigned tail = n - (unsigned) gap;
+        std::memcpy(full, groups, gap * sizeof(uint16_t));
+        std::memcpy(full + 8 - tail, groups + gap, tail * sizeof(uint16_t));
+    }
+
+    uint64_t hi = 0, lo = 0;
+    for(unsigned i = 0; i < 4; i++){
+        hi = (hi << 16) | full[i];
+        lo = (lo << 16) | full[i + 4];
+    }
+    addr = uint128_t(hi, lo);
+    return true;
+}
+
+UINT128_T_INLINE bool ipv6_parse(const char * str, const std::size_t len, ipv6_cidr & cidr){
+    const char * slash = static_cast <const char *> (std::memchr(str, '/', len));
+    if (!slash){
+        return false;
+    }
+
+    const char * p = slash + 1;
+    const char * const end = str + len;
+    unsigned length = 0;
+    if ((p == end) || ((end - p) > 3) || ((*p == '0') && ((end - p) > 1))){
+        return false;
+    }
+    for(; p != end; p++){
+        if ((unsigned) (*p - '0') >= 10){
+            return false;
+        }
+        length = length * 10 + (unsigned) (*p - '0');
+    }
+    if (length > 128){
+        return false;
+    }
+
+    uint128_t addr;
+    if (!ipv6_parse(str, slash - str, addr)){
+        return false;
+    }
+    cidr = ipv6_cidr(addr, length);
+    return true;
+}
+
+UINT128_T_INLINE uint128_t ipv6_parse(const std::string & str){
+    uint128_t addr;
+    if (!ipv6_parse(str.data(), str.size(), addr)){
+        throw std::invalid_argument("Error: not an IPv6 address: " + str);
+    }
+    return addr;
+}
+
+UINT128_T_INLINE ipv6_cidr ipv6_parse_cidr(const std::string & str){
+    ipv6_cidr cidr;
+    if (!ipv6_parse(str.data(), str.size(), cidr)){
+        throw std::invalid_argument("Error: not an IPv6 network: " + str);
+    }
+    return cidr;
+}
+
+// Writes one group without leading zeros. The four nibbles are spread over
+// the bytes of a word and turned into hex digits all at once: adding 6 carries
+// into the high half of each byte exactly for the nibbles above 9, and those
+// get 'a' - '0' - 10 added on top of '0'.
+static inline char * ipv6_write_group(char * out, const unsigned group){
+    uint32_t x = group;
+    x = ((x << 8) | x) & 0x00ff00ffU;
+    x = ((x << 4) | x) & 0x0f0f0f0fU;       // byte i holds nibble i
+    const uint32_t letters = ((x + 0x06060606U) >> 4) & 0x01010101U;
+    const uint32_t hex = x + 0x30303030U + letters * ('a' - '0' - 10);
+
+    int i = 3;
+    while ((i > 0) && !((group >> (4 * i)) & 0xf)){
+        i--;
+    }
+    for(; i >= 0; i--){
+        *out++ = (char) (hex >> (8 * i));
+    }
+    return out;
+}
+
+static inline char * ipv6_write_octet(char * out, const unsigned octet){
+    if (octet >= 100){
+        *out++ = (char) ('0' + octet / 100);
+    }
+    if (octet >= 10){
+        *out++ = (char) ('0' + octet / 10 % 10);
+    }
+    *out++ = (char) ('0' + octet % 10);
+    return out;
+}
+
+UINT128_T_INLINE std::size_t ipv6_format(const uint128_t & addr, char * out){
+    const uint64_t hi = addr.upper(), lo = addr.lower();
+    char * p = out;
+
+    // ::ffff:0:0/96 is shown with the IPv4 address in dotted form (RFC 5952 section 5)
+    if (!hi && ((lo >> 32) == 0xffff)){
+        std::memcpy(p, "::ffff:", 7);
+        p += 7;
+        for(unsigned i = 0; i < 4; i++){
+            if (i){
+                *p++ = '.';
+            }
+            p = ipv6_write_octet(p, (unsigned) (lo >> (24 - 8 * i)) & 0xff);
+        }
+        return p - out;
+    }
+
+    unsigned groups[8];
+    for(unsigned i = 0; i < 4; i++){
+        groups[i]     = (unsigned) (hi >> (48 - 16 * i)) & 0xffff;
+        groups[i + 4] = (unsigned) (lo >> (48 - 16 * i)) & 0xffff;
+    }
+
+    // the longest run of two or more zero groups is shortened; the first wins a tie
+    int best = -1, best_length = 1;
+    for(int i = 0; i < 8; ){
+        if (groups[i]){
+            i++;
+            continue;
+        }
+        int j = i;
+        while ((j < 8) && !groups[j]){
+            j++;
+        }
+        if (j - i > best_length){
+            best = i;
+            best_length = j - i;
+        }
+        i = j;
+    }
+
+    for(int i = 0; i < 8; ){
+        if (i == best){
+            *p++ = ':';
+            *p++ = ':';
+            i += best_length;
+            continue;
+        }
+        if (i && (i != best + best_length)){
+            *p++ = ':';
+        }
+        p = ipv6_write_group(p, groups[i++]);
+    }
+    return p - out;
+}
+
+UINT128_T_INLINE std::size_t ipv6_format(const ipv6_cidr & cidr, char * out){
+    char * p = out + ipv6_format(cidr.network, out);
+    *p++ = '/';
+    return ipv6_write_octet(p, cidr.length) - out;
+}
+
+UINT128_T_INLINE std::string ipv6_str(const uint128_t & addr){
+    char buf[ipv6_max_length];
+    return std::string(buf, ipv6_format(addr, buf));
+}
+
+UINT128_T_INLINE std::string ipv6_str(const ipv6_cidr & cidr){
+    char buf[ipv6_cidr_max_length];
+    return std::string(buf, ipv6_format(cidr, buf));
+}
@@ -0,0 +1,267 @@
+// PUBLIC IMPORT HEADER
+// IPv6 addresses held in uint128_t
+//
+// The first group of the address is the most significant 16 bits, so
+// 2001:db8::1 is uint128_t(0x20010db800000000, 1) and numeric order is
+// address order.
+//
+//     ipv6_parse / ipv6_format  - text <-> uint128_t; output follows RFC 5952
+//                                 (lowercase, no leading zeros, longest run of
+//                                 two or more zero groups shortened to ::,
+//                                 ::ffff:a.b.c.d for IPv4-mapped addresses)
+//     ipv6_mask(n)              - the /n netmask
+//     ipv6_cidr, contains       - networks and membership tests
+//     ipv6_trie <Value>         - path compressed longest-prefix-match table
+//
+// Parsing accepts everything RFC 4291 allows, including a dotted IPv4 tail;
+// zone indices (%eth0) are not accepted.
+#ifndef _UINT128_T_IPV6_H_
+#define _UINT128_T_IPV6_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "uint128_t.h"
+
+// longest text ipv6_format writes for an address and for a network
+constexpr std::size_t ipv6_max_length = 39;
+constexpr std::size_t ipv6_cidr_max_length = 43;
+
+// /length netmask; lengths above 128 are treated as 128
+inline uint128_t ipv6_mask(const unsigned length){
+    if (length <= 64){
+        return uint128_t(length ? (~0ULL << (64 - length)) : 0ULL, 0ULL);
+    }
+    return uint128_t(~0ULL, (length >= 128) ? ~0ULL : (~0ULL << (128 - length)));
+}
+
+// number of leading bits a and b have in common (128 if they are equal)
+inline unsigned ipv6_common_prefix(const uint128_t & a, const uint128_t & b){
+    const uint64_t hi = a.upper() ^ b.upper();
+    if (hi){
+        return uint128_detail::clz64(hi);
+    }
+    const uint64_t lo = a.lower() ^ b.lower();
+    return lo ? 64 + uint128_detail::clz64(lo) : 128;
+}
+
+// length of a netmask, or -1 if its bits are not contiguous
+inline int ipv6_prefix_length(const uint128_t & mask){
+    const unsigned length = ipv6_common_prefix(mask, uint128_t(~0ULL, ~0ULL));
+    const uint128_t expected = ipv6_mask(length);
+    return ((mask.upper() == expected.upper()) && (mask.lower() == expected.lower())) ? (int) length : -1;
+}
+
+// bit i of addr, counting from the most significant; i must be below 128
+inline unsigned ipv6_bit(const uint128_t & addr, const unsigned i){
+    return (unsigned) (((i < 64) ? (addr.upper() >> (63 - i)) : (addr.lower() >> (127 - i))) & 1);
+}
+
+struct ipv6_cidr{
+    uint128_t network;  // host bits are always zero
+    unsigned length;
+
+    ipv6_cidr()
+        : network(), length(0)
+    {}
+
+    // host bits of addr are cleared
+    ipv6_cidr(const uint128_t & addr, const unsigned prefix_length)
+        : network(addr & ipv6_mask(prefix_length)), length((prefix_length > 128) ? 128 : prefix_length)
+    {}
+
+    bool operator==(const ipv6_cidr & rhs) const{
+        return (length == rhs.length) && (network == rhs.network);
+    }
+
+    bool operator!=(const ipv6_cidr & rhs) const{
+        return !(*this == rhs);
+    }
+};
+
+inline bool contains(const ipv6_cidr & cidr, const uint128_t & addr){
+    return ipv6_common_prefix(cidr.network, addr) >= cidr.length;
+}
+
+// true if inner is the same network as outer or a subnet of it
+inline bool contains(const ipv6_cidr & outer, const ipv6_cidr & inner){
+    return (inner.length >= outer.length) && contains(outer, inner.network);
+}
+
+// Returns false if str is not an address ("addr") or network ("addr/length").
+// Host bits set in a network are cleared.
+UINT128_T_EXTERN bool ipv6_parse(const char * str, const std::size_t len, uint128_t & addr);
+UINT128_T_EXTERN bool ipv6_parse(const char * str, const std::size_t len, ipv6_cidr & cidr);
+
+// throws std::invalid_argument
+UINT128_T_EXTERN uint128_t ipv6_parse(const std::string & str);
+UINT128_T_EXTERN ipv6_cidr ipv6_parse_cidr(const std::string & str);
+
+// writes at most ipv6_max_length / ipv6_cidr_max_length characters, not null
+// terminated; returns the length
+UINT128_T_EXTERN std::size_t ipv6_format(const uint128_t & addr, char * out);
+UINT128_T_EXTERN std::size_t ipv6_format(const ipv6_cidr & cidr, char * out);
+
+UINT128_T_EXTERN std::string ipv6_str(const uint128_t & addr);
+UINT128_T_EXTERN std::string ipv6_str(const ipv6_cidr & cidr);
+
+// Longest-prefix-match table from networks to values
+//
+// A path compressed binary trie: every node holds a full prefix, and a node
+// only exists where a network was inserted or where two branches split, so a
+// lookup visits at most one node per distinct prefix length on its path.
+// Nodes live in one vector and refer to each other by index.
+template <typename Value>
+class ipv6_trie{
+    private:
+        static constexpr uint32_t NONE = 0xffffffff;
+
+        struct node{
+            uint128_t prefix;
+            uint32_t child[2];
+            uint8_t length;
+            bool has_value;
+            Value value;
+        };
+
+        std::vector <node> nodes;
+        uint32_t root;
+        std::size_t count;
+
+        uint32_t make(const uint128_t & prefix, const unsigned length){
+            node n = node();
+            n.prefix = prefix;
+            n.child[0] = n.child[1] = NONE;
+            n.length = (uint8_t) length;
+            n.has_value = false;
+            nodes.push_back(n);
+            return (uint32_t) (nodes.size() - 1);
+        }
+
+        void set(const uint32_t index, const Value & value){
+            node & n = nodes[index];
+            count += !n.has_value;
+            n.has_value = true;
+            n.value = value;
+        }
+
+        void attach(const uint32_t parent, const unsigned side, const uint32_t child){
+            if (parent == NONE){
+                root = child;
+            }
+            else{
+                nodes[parent].child[side] = child;
+            }
+        }
+
+    public:
+        ipv6_trie()
+            : nodes(), root(NONE), count(0)
+        {}
+
+        // number of networks with a value
+        std::size_t size() const{
+            return count;
+        }
+
+        bool empty() const{
+            return !count;
+        }
+
+        void clear(){
+            nodes.clear();
+            root = NONE;
+            count = 0;
+        }
+
+        void reserve(const std::size_t networks){
+            // one leaf and at most one split per network
+            nodes.reserve(2 * networks);
+        }
+
+        // adds cidr, or replaces its value if it is already there
+        void insert(const ipv6_cidr & cidr, const Value & value){
+            uint32_t parent = NONE, current = root;
+            unsigned side = 0;
+            while (current != NONE){
+                const unsigned length = nodes[current].length;
+                unsigned common = ipv6_common_prefix(cidr.network, nodes[current].prefix);
+                common = (common < length) ? common : length;
+                common = (common < cidr.length) ? common : cidr.length;
+
+                if (common == length){
+                    if (cidr.length == length){
+                        set(current, value);
+                        return;
+                    }
+                    parent = current;
+                    side = ipv6_bit(cidr.network, length);
+                    current = nodes[current].child[side];
+                    continue;
+                }
+
+                // the paths part at bit common: put a node there
+                const uint32_t split = make(cidr.network & ipv6_mask(common), common);
+                nodes[split].child[ipv6_bit(nodes[current].prefix, common)] = current;
+                if (common == cidr.length){
+                    set(split, value);
+                }
+                else{
+                    const uint32_t leaf = make(cidr.network, cidr.length);
+                    set(leaf, value);
+                    nodes[split].child[ipv6_bit(cidr.network, common)] = leaf;
+                }
+                attach(parent, side, split);
+                return;
+            }
+
+            const uint32_t leaf = make(cidr.network, cidr.length);
+            set(leaf, value);
+            attach(parent, side, leaf);
+        }
+
+        // value of the longest network containing addr, or nullptr
+        const Value * lookup(const uint128_t & addr) const{
+            const Value * best = nullptr;
+            uint32_t current = root;
+            while (current != NONE){
+                const node & n = nodes[current];
+                if (ipv6_common_prefix(addr, n.prefix) < n.length){
+                    break;
+                }
+                if (n.has_value){
+                    best = &n.value;
+                }
+                if (n.length == 128){
+                    break;
+                }
+                current = n.child[ipv6_bit(addr, n.length)];
+            }
+            return best;
+        }
+
+        // value stored for exactly this network, or nullptr
+        const Value * find(const ipv6_cidr & cidr) const{
+            uint32_t current = root;
+            while (current != NONE){
+                const node & n = nodes[current];
+                if ((n.length > cidr.length) || (ipv6_common_prefix(cidr.network, n.prefix) < n.length)){
+                    return nullptr;
+                }
+                if (n.length == cidr.length){
+                    return n.has_value ? &n.value : nullptr;
+                }
+                current = n.child[ipv6_bit(cidr.network, n.length)];
+            }
+            return nullptr;
+        }
+};
+
+template <typename Value> constexpr uint32_t ipv6_trie <Value>::NONE;
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_ipv6.cpp"
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+#include <algorithm>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_morton.h"
+
+// the bits of x and of y in a key
+static const uint64_t MORTON_X = 0x5555555555555555ULL;
+static const uint64_t MORTON_Y = 0xaaaaaaaaaaaaaaaaULL;
+
+UINT128_T_INLINE uint128_t morton_encode(const uint64_t x, const uint64_t y){
+    uint128_t key;
+    uint128_active_kernels().morton_encode_n(&x, &y, 1, &key);
+    return key;
+}
+
+UINT128_T_INLINE void morton_decode(const uint128_t & key, uint64_t & x, uint64_t & y){
+    uint128_active_kernels().morton_decode_n(&key, 1, &x, &y);
+}
+
+UINT128_T_INLINE void morton_encode_n(const uint64_t * x, const uint64_t * y, std::size_t count, uint128_t * out){
+    uint128_active_kernels().morton_encode_n(x, y, count, out);
+}
+
+UINT128_T_INLINE void morton_decode_n(const uint128_t * keys, std::size_t count, uint64_t * x, uint64_t * y){
+    uint128_active_kernels().morton_decode_n(keys, count, x, y);
+}
+
+// the bits of one coordinate compare in the same order as the coordinate
+static inline bool morton_between(const uint128_t & key, const uint128_t & min, const uint128_t & max, const uint64_t mask){
+    const uint128_t m(mask, mask);
+    const uint128_t k = key & m;
+    return ((min & m) <= k) && (k <= (max & m));
+}
+
+UINT128_T_INLINE bool morton_in_box(const uint128_t & key, const uint128_t & min, const uint128_t & max){
+    return morton_between(key, min, max, MORTON_X) && morton_between(key, min, max, MORTON_Y);
+}
+
+// Tropf and Herzog, "Multidimensional Range Search in Dynamically Balanced
+// Trees" (1981). From the top bit down, where z leaves the box in one
+// coordinate the box is cut in half along it: the half past z gives BIGMIN
+// candidates and the half before z LITMAX candidates.
+static void morton_split(const uint128_t & z, uint128_t min, uint128_t max,
+                         bool & found_bigmin, uint128_t & bigmin, bool & found_litmax, uint128_t & litmax){
+    found_bigmin = found_litmax = false;
+    for(unsigned i = 128; i-- > 0;){
+        const uint128_t bit = uint128_t(1) << i;
+        const uint64_t dimension = (i & 1) ? MORTON_Y : MORTON_X;
+        const uint128_t below = uint128_t(dimension, dimension) & (bit - 1);
+
+        const unsigned bits = (((z & bit) != 0) << 2) | (((min & bit) != 0) << 1) | ((max & bit) != 0);
+        switch (bits){
+            case 0x1:   // 0 0 1: z is in the lower half
+                bigmin = (min | bit) & ~below;
+                found_bigmin = true;
+                max = (max & ~bit) | below;
+                break;
+            case 0x3:   // 0 1 1: the whole box is above z
+                bigmin = min;
+                found_bigmin = true;
+                return;
+            case 0x4:   // 1 0 0: the whole box is below z
+                litmax = max;
+                found_litmax = true;
+                return;
+            case 0x5:   // 1 0 1: z is in the upper half
+                litmax = (max & ~bit) | below;
+                found_litmax = true;
+                min = (min | bit) & ~below;
+                break;
+            case 0x2:   // min above max in this coordinate: an empty box
+            case 0x6:
+                return;
+            default:    // 0 0 0 and 1 1 1: same side as both corners
+                break;
+        }
+    }
+}
+
+UINT128_T_INLINE bool morton_bigmin(const uint128_t & z, const uint128_t & min, const uint128_t & max, uint128_t & bigmin){
+    bool found_bigmin, found_litmax;
+    uint128_t litmax;
+    morton_split(z, min, max, found_bigmin, bigmin, found_litmax, litmax);
+    return found_bigmin;
+}
+
+UINT128_T_INLINE bool morton_litmax(const uint128_t & z, const uint128_t & min, const uint128_t & max, uint128_t & litmax){
+    bool found_bigmin, found_litmax;
+    uint128_t bigmin;
+    morton_split(z, min, max, found_bigmin, bigmin, found_litmax, litmax);
+    return found_litmax;
+}
+
+UINT128_T_INLINE std::vector <std::size_t> morton_query(const uint128_t * keys, std::size_t count,
+                                                        const uint64_t x0, const uint64_t y0,
+                                                        const uint64_t x1, const uint64_t y1){
+    std::vector <std::size_t> out;
+    if ((x0 > x1) || (y0 > y1)){
+        return out;
+    }
+    const uint128_t min = morton_encode(x0, y0), max = morton_encode(x1, y1);
+
+    // walk the keys between the corners, and jump to BIGMIN at the first one
+    // outside the box
+    std::size_t i = std::lower_bound(keys, keys + count, min) - keys;
+    while ((i < count) && (keys[i] <= max)){
+        if (morton_in_box(keys[i], min, max)){
+            out.push_back(i++);
+            continue;
+        }
+        uint128_t next;
+        if (!morton_bigmin(keys[i], min, max, next)){
+            break;
+        }
+        i = std::lower_bound(keys + i + 1, keys + count, next) - keys;
+    }
+    return out;
+}
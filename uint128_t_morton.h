@@ -0,0 +1,52 @@
+// PUBLIC IMPORT HEADER
+// Morton (Z-order) keys of two 64 bit coordinates
+//
+//     morton_encode(x, y)                 - bit i of x goes to bit 2i, bit i of y to bit 2i + 1
+//     morton_decode(key, x, y)            - the inverse
+//     morton_encode_n / morton_decode_n   - the same over arrays
+//     morton_bigmin(z, min, max)          - next key after z inside a box (Tropf and Herzog)
+//     morton_litmax(z, min, max)          - last key before z inside a box
+//     morton_query(keys, count, ...)      - positions of the sorted keys inside a box
+//
+// Sorting by key orders points along the Z curve, and a box [x0, x1] x [y0, y1]
+// lies between the keys of its corners (x0, y0) and (x1, y1). A range scan
+// over sorted keys uses BIGMIN to jump over the parts of that range that
+// leave the box.
+//
+// Encoding and decoding go through the dispatch table: the bmi2 kernel uses
+// PDEP/PEXT, the avx2 and avx512 kernels spread or gather 4 bit groups with
+// byte shuffle tables, 4 keys at a time, and the generic kernel uses shifts
+// and masks.
+#ifndef _UINT128_T_MORTON_H_
+#define _UINT128_T_MORTON_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "uint128_t.h"
+
+UINT128_T_EXTERN uint128_t morton_encode(const uint64_t x, const uint64_t y);
+UINT128_T_EXTERN void morton_decode(const uint128_t & key, uint64_t & x, uint64_t & y);
+
+UINT128_T_EXTERN void morton_encode_n(const uint64_t * x, const uint64_t * y, std::size_t count, uint128_t * out);
+UINT128_T_EXTERN void morton_decode_n(const uint128_t * keys, std::size_t count, uint64_t * x, uint64_t * y);
+
+// true if key lies in the box with corner keys min and max
+UINT128_T_EXTERN bool morton_in_box(const uint128_t & key, const uint128_t & min, const uint128_t & max);
+
+// Smallest key greater than z that lies in the box, and largest key less than
+// z that does; z must lie between min and max but outside the box. Return
+// false when there is no such key.
+UINT128_T_EXTERN bool morton_bigmin(const uint128_t & z, const uint128_t & min, const uint128_t & max, uint128_t & bigmin);
+UINT128_T_EXTERN bool morton_litmax(const uint128_t & z, const uint128_t & min, const uint128_t & max, uint128_t & litmax);
+
+// indices of the keys (sorted ascending) with x0 <= x <= x1 and y0 <= y <= y1
+UINT128_T_EXTERN std::vector <std::size_t> morton_query(const uint128_t * keys, std::size_t count,
+                                                        const uint64_t x0, const uint64_t y0,
+                                                        const uint64_t x1, const uint64_t y1);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_morton.cpp"
+#endif
+
+#endif
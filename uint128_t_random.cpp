@@ -0,0 +1,204 @@
+#include "uint128_t.build"
+#include "uint128_t_random.h"
+
+// splitmix64, used to expand small seeds into full generator state
+static uint64_t splitmix64(uint64_t & x){
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+UINT128_T_INLINE pcg64::pcg64(const uint128_t & seed, const uint128_t & stream)
+    : STATE_HI(0), STATE_LO(0), INC_HI(0), INC_LO(0)
+{
+    this -> seed(seed, stream);
+}
+
+UINT128_T_INLINE void pcg64::seed(const uint128_t & seed, const uint128_t & stream){
+    // same procedure as the reference implementation
+    const uint128_t inc = (stream << 1) | 1;
+    INC_HI = inc.upper();
+    INC_LO = inc.lower();
+    STATE_HI = 0;
+    STATE_LO = 0;
+    next64();
+    const uint128_t state = uint128_t(STATE_HI, STATE_LO) + seed;
+    STATE_HI = state.upper();
+    STATE_LO = state.lower();
+    next64();
+}
+
+UINT128_T_INLINE void pcg64::discard(const uint128_t & n){
+    // Brown, "Random Number Generation with Arbitrary Stride"
+    uint128_t delta = n << 1;
+    uint128_t cur_mult(0x2360ed051fc65da4ULL, 0x4385df649fccf645ULL);
+    uint128_t cur_plus(INC_HI, INC_LO);
+    uint128_t acc_mult = 1;
+    uint128_t acc_plus = 0;
+    while (delta){
+        if (delta & 1){
+            acc_mult *= cur_mult;
+            acc_plus = acc_plus * cur_mult + cur_plus;
+        }
+        cur_plus = (cur_mult + 1) * cur_plus;
+        cur_mult *= cur_mult;
+        delta >>= 1;
+    }
+    const uint128_t state = acc_mult * uint128_t(STATE_HI, STATE_LO) + acc_plus;
+    STATE_HI = state.upper();
+    STATE_LO = state.lower();
+}
+
+UINT128_T_INLINE void pcg64::fill(uint128_t * out, std::size_t count){
+    for(std::size_t i = 0; i < count; i++){
+        const uint64_t hi = next64();
+        out[i] = uint128_t(hi, next64());
+    }
+}
+
+UINT128_T_INLINE bool pcg64::operator==(const pcg64 & rhs) const{
+    return (STATE_HI == rhs.STATE_HI) && (STATE_LO == rhs.STATE_LO) &&
+           (INC_HI   == rhs.INC_HI)   && (INC_LO   == rhs.INC_LO);
+}
+
+UINT128_T_INLINE bool pcg64::operator!=(const pcg64 & rhs) const{
+    return !(*this == rhs);
+}
+
+UINT128_T_INLINE xoshiro256::xoshiro256(const uint64_t seed){
+    this -> seed(seed);
+}
+
+UINT128_T_INLINE xoshiro256::xoshiro256(const uint64_t s0, const uint64_t s1, const uint64_t s2, const uint64_t s3){
+    S[0] = s0;
+    S[1] = s1;
+    S[2] = s2;
+    S[3] = s3;
+}
+
+UINT128_T_INLINE void xoshiro256::seed(const uint64_t seed){
+    uint64_t x = seed;
+    for(uint64_t & s : S){
+        s = splitmix64(x);
+    }
+}
+
+UINT128_T_INLINE void xoshiro256::jump(){
+    static const uint64_t JUMP[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                     0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+    for(const uint64_t j : JUMP){
+        for(int b = 0; b < 64; b++){
+            if (j & (1ULL << b)){
+                s[0] ^= S[0];
+                s[1] ^= S[1];
+                s[2] ^= S[2];
+                s[3] ^= S[3];
+            }
+            next64();
+        }
+    }
+    S[0] = s[0];
+    S[1] = s[1];
+    S[2] = s[2];
+    S[3] = s[3];
+}
+
+UINT128_T_INLINE void xoshiro256::fill(uint128_t * out, std::size_t count){
+    // keep the state in registers for the whole loop
+    uint64_t s0 = S[0], s1 = S[1], s2 = S[2], s3 = S[3];
+    uint64_t words[2];
+    for(std::size_t i = 0; i < count; i++){
+        for(uint64_t & w : words){
+            w = uint128_detail::rotl64(s0 + s3, 23) + s0;
+            const uint64_t t = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = uint128_detail::rotl64(s3, 45);
+        }
+        out[i] = uint128_t(words[0], words[1]);
+    }
+    S[0] = s0;
+    S[1] = s1;
+    S[2] = s2;
+    S[3] = s3;
+}
+
+UINT128_T_INLINE bool xoshiro256::operator==(const xoshiro256 & rhs) const{
+    return (S[0] == rhs.S[0]) && (S[1] == rhs.S[1]) && (S[2] == rhs.S[2]) && (S[3] == rhs.S[3]);
+}
+
+UINT128_T_INLINE bool xoshiro256::operator!=(const xoshiro256 & rhs) const{
+    return !(*this == rhs);
+}
+
+UINT128_T_INLINE philox2x64::philox2x64(const uint64_t key, const uint128_t & counter)
+    : KEY(key), COUNTER_HI(counter.upper()), COUNTER_LO(counter.lower())
+{}
+
+UINT128_T_INLINE const uint64_t & philox2x64::key() const{
+    return KEY;
+}
+
+UINT128_T_INLINE uint128_t philox2x64::counter() const{
+    return uint128_t(COUNTER_HI, COUNTER_LO);
+}
+
+UINT128_T_INLINE void philox2x64::set_key(const uint64_t key){
+    KEY = key;
+}
+
+UINT128_T_INLINE void philox2x64::set_counter(const uint128_t & counter){
+    COUNTER_HI = counter.upper();
+    COUNTER_LO = counter.lower();
+}
+
+UINT128_T_INLINE void philox2x64::discard(const uint128_t & n){
+    set_counter(counter() + n);
+}
+
+UINT128_T_INLINE void philox2x64::fill(uint128_t * out, std::size_t count){
+    // blocks are independent, so compute several at once to overlap the multiplies
+    const std::size_t LANES = 4;
+    uint64_t hi = COUNTER_HI, lo = COUNTER_LO;
+    std::size_t i = 0;
+    for(; i + LANES <= count; i += LANES){
+        uint64_t c0[LANES], c1[LANES];
+        for(std::size_t l = 0; l < LANES; l++){
+            c0[l] = lo;
+            c1[l] = hi;
+            hi += !++lo;
+        }
+        uint64_t k = KEY;
+        for(int round = 0; round < 10; round++){
+            for(std::size_t l = 0; l < LANES; l++){
+                uint64_t h;
+                const uint64_t m = uint128_detail::mul64(0xd2b74407b1ce6e93ULL, c0[l], h);
+                c0[l] = h ^ k ^ c1[l];
+                c1[l] = m;
+            }
+            k += 0x9e3779b97f4a7c15ULL;
+        }
+        for(std::size_t l = 0; l < LANES; l++){
+            out[i + l] = uint128_t(c1[l], c0[l]);
+        }
+    }
+    for(; i < count; i++){
+        out[i] = block(KEY, uint128_t(hi, lo));
+        hi += !++lo;
+    }
+    COUNTER_HI = hi;
+    COUNTER_LO = lo;
+}
+
+UINT128_T_INLINE bool philox2x64::operator==(const philox2x64 & rhs) const{
+    return (KEY == rhs.KEY) && (COUNTER_HI == rhs.COUNTER_HI) && (COUNTER_LO == rhs.COUNTER_LO);
+}
+
+UINT128_T_INLINE bool philox2x64::operator!=(const philox2x64 & rhs) const{
+    return !(*this == rhs);
+}
@@ -0,0 +1,195 @@
+// PUBLIC IMPORT HEADER
+// Pseudo-random generators producing uint128_t
+//
+// All generators model UniformRandomBitGenerator: they expose result_type,
+// min(), max() and operator(), each call returning 128 uniformly distributed
+// bits.
+//
+//     pcg64       - 128 bit LCG state with XSL-RR output, two steps per value
+//     xoshiro256  - xoshiro256++, two steps per value, jump() for substreams
+//     philox2x64  - counter-based Philox2x64-10, one block per value; every
+//                   (key, counter) pair can be computed independently, so
+//                   parallel streams are just different keys or counter ranges
+//
+// uniform(gen, n) draws from [0, n) without bias using Lemire's
+// multiply-shift method on the full 256 bit product.
+#ifndef _UINT128_T_RANDOM_H_
+#define _UINT128_T_RANDOM_H_
+
+#include <cstddef>
+
+#include "uint128_t.h"
+#include "uint128_t_intrinsics.include"
+
+// Unbiased value in [0, n) from any generator returning uint128_t
+template <typename Generator>
+uint128_t uniform(Generator & gen, const uint128_t & n){
+    if (!n){
+        throw std::domain_error("Error: uniform range is empty");
+    }
+
+    uint64_t m[4];
+    uint128_t x = gen();
+    uint128_detail::mul128(x.upper(), x.lower(), n.upper(), n.lower(), m);
+
+    // the low half of the product decides if this sample lands in the biased zone
+    if (uint128_t(m[2], m[3]) < n){
+        const uint128_t threshold = (-n) % n;   // 2^128 mod n
+        while (uint128_t(m[2], m[3]) < threshold){
+            x = gen();
+            uint128_detail::mul128(x.upper(), x.lower(), n.upper(), n.lower(), m);
+        }
+    }
+    return uint128_t(m[0], m[1]);
+}
+
+class UINT128_T_EXTERN pcg64{
+    private:
+        uint64_t STATE_HI, STATE_LO;
+        uint64_t INC_HI, INC_LO;
+
+        uint64_t next64(){
+            // state = state * multiplier + increment (mod 2^128)
+            static const uint64_t MUL_HI = 0x2360ed051fc65da4ULL;
+            static const uint64_t MUL_LO = 0x4385df649fccf645ULL;
+            uint64_t hi;
+            const uint64_t lo = uint128_detail::mul64(STATE_LO, MUL_LO, hi);
+            hi += STATE_LO * MUL_HI + STATE_HI * MUL_LO;
+            uint64_t carry = 0;
+            STATE_LO = uint128_detail::addc64(lo, INC_LO, carry);
+            STATE_HI = uint128_detail::addc64(hi, INC_HI, carry);
+
+            // XSL-RR output
+            return uint128_detail::rotr64(STATE_HI ^ STATE_LO, (unsigned) (STATE_HI >> 58));
+        }
+
+    public:
+        typedef uint128_t result_type;
+
+        static constexpr result_type min(){ return uint128_t(0, 0); }
+        static constexpr result_type max(){ return uint128_t(~0ULL, ~0ULL); }
+
+        explicit pcg64(const uint128_t & seed = 0xcafef00dd15ea5e5ULL, const uint128_t & stream = 0);
+
+        void seed(const uint128_t & seed, const uint128_t & stream);
+
+        result_type operator()(){
+            const uint64_t hi = next64();
+            return uint128_t(hi, next64());
+        }
+
+        // advance the state by 2 * n steps (n values) in O(log n)
+        void discard(const uint128_t & n);
+
+        void fill(uint128_t * out, std::size_t count);
+
+        uint128_t uniform(const uint128_t & n){
+            return ::uniform(*this, n);
+        }
+
+        bool operator==(const pcg64 & rhs) const;
+        bool operator!=(const pcg64 & rhs) const;
+};
+
+class UINT128_T_EXTERN xoshiro256{
+    private:
+        uint64_t S[4];
+
+        uint64_t next64(){
+            const uint64_t result = uint128_detail::rotl64(S[0] + S[3], 23) + S[0];
+            const uint64_t t = S[1] << 17;
+            S[2] ^= S[0];
+            S[3] ^= S[1];
+            S[1] ^= S[2];
+            S[0] ^= S[3];
+            S[2] ^= t;
+            S[3] = uint128_detail::rotl64(S[3], 45);
+            return result;
+        }
+
+    public:
+        typedef uint128_t result_type;
+
+        static constexpr result_type min(){ return uint128_t(0, 0); }
+        static constexpr result_type max(){ return uint128_t(~0ULL, ~0ULL); }
+
+        // state is expanded from the seed with splitmix64
+        explicit xoshiro256(const uint64_t seed = 0x9e3779b97f4a7c15ULL);
+        xoshiro256(const uint64_t s0, const uint64_t s1, const uint64_t s2, const uint64_t s3);
+
+        void seed(const uint64_t seed);
+
+        result_type operator()(){
+            const uint64_t hi = next64();
+            return uint128_t(hi, next64());
+        }
+
+        // advances by 2^127 values; use to split non-overlapping substreams
+        void jump();
+
+        void fill(uint128_t * out, std::size_t count);
+
+        uint128_t uniform(const uint128_t & n){
+            return ::uniform(*this, n);
+        }
+
+        bool operator==(const xoshiro256 & rhs) const;
+        bool operator!=(const xoshiro256 & rhs) const;
+};
+
+class UINT128_T_EXTERN philox2x64{
+    private:
+        uint64_t KEY;
+        uint64_t COUNTER_HI, COUNTER_LO;
+
+    public:
+        typedef uint128_t result_type;
+
+        static constexpr result_type min(){ return uint128_t(0, 0); }
+        static constexpr result_type max(){ return uint128_t(~0ULL, ~0ULL); }
+
+        explicit philox2x64(const uint64_t key = 0, const uint128_t & counter = 0);
+
+        // the generator itself: 10 rounds of Philox on one (key, counter) pair
+        static uint128_t block(const uint64_t key, const uint128_t & counter){
+            uint64_t k  = key;
+            uint64_t c0 = counter.lower();
+            uint64_t c1 = counter.upper();
+            for(int round = 0; round < 10; round++){
+                uint64_t hi;
+                const uint64_t lo = uint128_detail::mul64(0xd2b74407b1ce6e93ULL, c0, hi);
+                c0 = hi ^ k ^ c1;
+                c1 = lo;
+                k += 0x9e3779b97f4a7c15ULL;
+            }
+            return uint128_t(c1, c0);
+        }
+
+        result_type operator()(){
+            const uint128_t out = block(KEY, uint128_t(COUNTER_HI, COUNTER_LO));
+            COUNTER_HI += !++COUNTER_LO;
+            return out;
+        }
+
+        const uint64_t & key() const;
+        uint128_t counter() const;
+        void set_key(const uint64_t key);
+        void set_counter(const uint128_t & counter);
+
+        void discard(const uint128_t & n);
+
+        void fill(uint128_t * out, std::size_t count);
+
+        uint128_t uniform(const uint128_t & n){
+            return ::uniform(*this, n);
+        }
+
+        bool operator==(const philox2x64 & rhs) const;
+        bool operator!=(const philox2x64 & rhs) const;
+};
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_random.cpp"
+#endif
+
+#endif
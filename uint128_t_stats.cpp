@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_stats.h"
+
+static const char * const UINT128_STATS_OP_NAMES[uint128_stats::OPS] = {
+    "add", "sub", "mul", "div", "mod", "shl", "shr", "and", "or", "xor", "not", "compare", "negate",
+};
+
+static const char * const UINT128_STATS_PATH_NAMES[uint128_stats::PATHS] = {
+    "by_zero", "by_one", "equal", "smaller", "narrow_one", "narrow_two", "wide",
+};
+
+template <std::size_t N>
+static inline void stats_add(uint64_t (&to)[N], const uint64_t (&from)[N], const bool subtract){
+    for(std::size_t i = 0; i < N; i++){
+        to[i] = subtract ? (to[i] - from[i]) : (to[i] + from[i]);
+    }
+}
+
+static inline void stats_add(uint128_stats & to, const uint128_stats & from, const bool subtract = false){
+    stats_add(to.ops, from.ops, subtract);
+    stats_add(to.divmod, from.divmod, subtract);
+    stats_add(to.operand_bits, from.operand_bits, subtract);
+    stats_add(to.bits, from.bits, subtract);
+    stats_add(to.str_lengths, from.str_lengths, subtract);
+    to.str_allocations = subtract ? (to.str_allocations - from.str_allocations) : (to.str_allocations + from.str_allocations);
+}
+
+#if defined(UINT128_T_STATS)
+namespace uint128_stats_detail {
+
+    // The counters of one thread. Only that thread writes them, so counting
+    // is a relaxed load and store; snapshot() reads them from other threads.
+    struct slot{
+        std::atomic <uint64_t> ops[uint128_stats::OPS];
+        std::atomic <uint64_t> divmod[uint128_stats::PATHS];
+        std::atomic <uint64_t> operand_bits[uint128_stats::WIDTHS];
+        std::atomic <uint64_t> bits[uint128_stats::WIDTHS];
+        std::atomic <uint64_t> str_lengths[uint128_stats::LENGTHS];
+        std::atomic <uint64_t> str_allocations;
+
+        slot();
+        ~slot();
+        void read(uint128_stats & out) const;
+    };
+
+    struct registry{
+        std::mutex mutex;
+        std::vector <const slot *> live;
+        uint128_stats retired;      // threads that have exited
+        uint128_stats baseline;     // totals at the last reset()
+
+        uint128_stats totals() const{
+            uint128_stats out = retired;
+            for(const slot * s : live){
+                uint128_stats counts;
+                s -> read(counts);
+                stats_add(out, counts);
+            }
+            return out;
+        }
+    };
+
+    UINT128_T_INLINE registry & threads(){
+        static registry instance;
+        return instance;
+    }
+
+    template <std::size_t N>
+    static inline void slot_read(uint64_t (&to)[N], const std::atomic <uint64_t> (&from)[N]){
+        for(std::size_t i = 0; i < N; i++){
+            to[i] = from[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    template <std::size_t N>
+    static inline void slot_clear(std::atomic <uint64_t> (&counts)[N]){
+        for(std::size_t i = 0; i < N; i++){
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static inline void bump(std::atomic <uint64_t> & count){
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    UINT128_T_INLINE slot::slot(){
+        slot_clear(ops);
+        slot_clear(divmod);
+        slot_clear(operand_bits);
+        slot_clear(bits);
+        slot_clear(str_lengths);
+        str_allocations.store(0, std::memory_order_relaxed);
+
+        registry & r = threads();
+        std::lock_guard <std::mutex> lock(r.mutex);
+        r.live.push_back(this);
+    }
+
+    UINT128_T_INLINE slot::~slot(){
+        registry & r = threads();
+        std::lock_guard <std::mutex> lock(r.mutex);
+        uint128_stats counts;
+        read(counts);
+        stats_add(r.retired, counts);
+        r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+    }
+
+    UINT128_T_INLINE void slot::read(uint128_stats & out) const{
+        slot_read(out.ops, ops);
+        slot_read(out.divmod, divmod);
+        slot_read(out.operand_bits, operand_bits);
+        slot_read(out.bits, bits);
+        slot_read(out.str_lengths, str_lengths);
+        out.str_allocations = str_allocations.load(std::memory_order_relaxed);
+    }
+
+    UINT128_T_INLINE slot & local(){
+        static thread_local slot counts;
+        return counts;
+    }
+
+    static inline unsigned width(const uint128_t & value){
+        return value.upper() ? 128 - uint128_detail::clz64(value.upper()) :
+               value.lower() ?  64 - uint128_detail::clz64(value.lower()) : 0;
+    }
+
+    UINT128_T_INLINE void count_op(const unsigned op){
+        bump(local().ops[op]);
+    }
+
+    UINT128_T_INLINE void count_divmod(const unsigned path, const uint128_t & lhs, const uint128_t & rhs){
+        slot & counts = local();
+        bump(counts.divmod[path]);
+        bump(counts.operand_bits[width(lhs)]);
+        bump(counts.operand_bits[width(rhs)]);
+    }
+
+    UINT128_T_INLINE void count_operands(const uint128_t & lhs, const uint128_t & rhs){
+        slot & counts = local();
+        bump(counts.operand_bits[width(lhs)]);
+        bump(counts.operand_bits[width(rhs)]);
+    }
+
+    UINT128_T_INLINE void count_bits(const unsigned bits){
+        bump(local().bits[bits]);
+    }
+
+    UINT128_T_INLINE void count_str(const std::string & str){
+        slot & counts = local();
+        bump(counts.str_lengths[std::min <std::size_t> (str.size(), uint128_stats::LENGTHS - 1)]);
+        if (str.capacity() > std::string().capacity()){
+            bump(counts.str_allocations);
+        }
+    }
+}
+#endif
+
+UINT128_T_INLINE uint128_stats::uint128_stats()
+    : ops(),
+      divmod(),
+      operand_bits(),
+      bits(),
+      str_lengths(),
+      str_allocations(0)
+{}
+
+UINT128_T_INLINE bool uint128_stats::enabled(){
+    #if defined(UINT128_T_STATS)
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+UINT128_T_INLINE uint128_stats uint128_stats::snapshot(){
+    uint128_stats out;
+    #if defined(UINT128_T_STATS)
+        uint128_stats_detail::registry & r = uint128_stats_detail::threads();
+        std::lock_guard <std::mutex> lock(r.mutex);
+        out = r.totals();
+        stats_add(out, r.baseline, true);
+    #endif
+    return out;
+}
+
+UINT128_T_INLINE void uint128_stats::reset(){
+    #if defined(UINT128_T_STATS)
+        uint128_stats_detail::registry & r = uint128_stats_detail::threads();
+        std::lock_guard <std::mutex> lock(r.mutex);
+        r.baseline = r.totals();
+    #endif
+}
+
+UINT128_T_INLINE const char * uint128_stats::name(const op o){
+    return (o < OPS) ? UINT128_STATS_OP_NAMES[o] : "unknown";
+}
+
+UINT128_T_INLINE const char * uint128_stats::name(const path p){
+    return (p < PATHS) ? UINT128_STATS_PATH_NAMES[p] : "unknown";
+}
+
+// "label: key value, key value" for the nonzero entries
+template <std::size_t N, typename Key>
+static void stats_line(std::ostream & stream, const char * label, const uint64_t (&counts)[N], Key key){
+    stream << label << ":";
+    const char * separator = " ";
+    for(std::size_t i = 0; i < N; i++){
+        if (counts[i]){
+            stream << separator << key(i) << " " << counts[i];
+            separator = ", ";
+        }
+    }
+    stream << "\n";
+}
+
+UINT128_T_INLINE std::ostream & operator<<(std::ostream & stream, const uint128_stats & stats){
+    uint64_t strings = 0;
+    for(const uint64_t count : stats.str_lengths){
+        strings += count;
+    }
+
+    const std::ios_base::fmtflags flags = stream.flags();
+    stream << std::dec;
+    stats_line(stream, "ops", stats.ops, [](const std::size_t i){ return uint128_stats::name((uint128_stats::op) i); });
+    stats_line(stream, "divmod", stats.divmod, [](const std::size_t i){ return uint128_stats::name((uint128_stats::path) i); });
+    stats_line(stream, "operand bits", stats.operand_bits, [](const std::size_t i){ return i; });
+    stats_line(stream, "bits()", stats.bits, [](const std::size_t i){ return i; });
+    stream << "str(): " << strings << " calls, " << stats.str_allocations << " allocated\n";
+    stats_line(stream, "str() lengths", stats.str_lengths, [](const std::size_t i){ return i; });
+    stream.flags(flags);
+    return stream;
+}
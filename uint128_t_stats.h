@@ -0,0 +1,59 @@
+// PUBLIC IMPORT HEADER
+// Operation counters of UINT128_T_STATS builds
+//
+// Compiling the library and its users with UINT128_T_STATS defined (the
+// CMake option of the same name) makes the operators count what they do:
+//
+//     ops           calls of each operator, with uint128_t or integral operands
+//                   (++ and -- count as add and sub, >= and <= as compare)
+//     divmod        which way each division went, see uint128_stats_ids::path
+//     operand_bits  widths of both operands of every *, / and %
+//     bits          results of bits()
+//     str_lengths   lengths of the strings str() returned (the last bucket
+//                   holds everything longer than 128)
+//     str_allocations  str() results too long for std::string's own buffer
+//
+// Each thread counts into its own block; snapshot() adds up the blocks of
+// all threads, including ones that have exited. Without UINT128_T_STATS the
+// hooks compile to nothing and snapshot() returns zeros.
+#ifndef _UINT128_T_STATS_H_
+#define _UINT128_T_STATS_H_
+
+#include <ostream>
+
+#include "uint128_t.h"
+
+class UINT128_T_EXTERN uint128_stats : public uint128_stats_ids{
+    public:
+        static constexpr unsigned WIDTHS = 129;
+        static constexpr unsigned LENGTHS = 130;
+
+        uint64_t ops[OPS];
+        uint64_t divmod[PATHS];
+        uint64_t operand_bits[WIDTHS];
+        uint64_t bits[WIDTHS];
+        uint64_t str_lengths[LENGTHS];
+        uint64_t str_allocations;
+
+        // all zero
+        uint128_stats();
+
+        // whether the library was built with UINT128_T_STATS
+        static bool enabled();
+
+        // counts of all threads since the start or the last reset()
+        static uint128_stats snapshot();
+        static void reset();
+
+        static const char * name(const op o);
+        static const char * name(const path p);
+};
+
+// the counters that are not zero, one group per line
+UINT128_T_EXTERN std::ostream & operator<<(std::ostream & stream, const uint128_stats & stats);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_stats.cpp"
+#endif
+
+#endif
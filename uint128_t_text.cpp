@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_text.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define UINT128_T_TEXT_MMAP
+#endif
+
+// input smaller than this per thread is parsed on fewer threads
+static const std::size_t TEXT_MIN_PIECE = 1 << 20;
+
+// values each thread formats per round when writing
+static const std::size_t TEXT_BLOCK = 1 << 16;
+
+// longest line: 39 decimal digits and the newline
+static const std::size_t TEXT_MAX_LINE = 40;
+
+static inline void text_check_base(const uint8_t base){
+    if ((base != 10) && (base != 16)){
+        throw std::invalid_argument("Error: text base must be 10 or 16");
+    }
+}
+
+// threads to use on work units of work, at least min_work each
+static inline unsigned text_threads(unsigned threads, const std::size_t work, const std::size_t min_work){
+    if (!threads){
+        threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    return (unsigned) std::min <std::size_t> (threads, work / min_work + 1);
+}
+
+// Newlines in [p, p + len), 8 bytes at a time: a byte of x ^ '\n' is 0
+// exactly when adding 0x7f to its low 7 bits leaves its top bit clear.
+// (std::count does a byte at a time unless the compiler vectorizes it.)
+static std::size_t text_newlines(const char * p, const std::size_t len){
+    const uint64_t ONES = 0x0101010101010101ULL;
+    const uint64_t LOW7 = 0x7f * ONES;
+    std::size_t i = 0, n = 0;
+    while (len - i >= 8){
+        // one count per byte, up to 255 words before they are added up
+        uint64_t lanes = 0;
+        const std::size_t stop = i + 8 * std::min <std::size_t> (255, (len - i) / 8);
+        for(; i < stop; i += 8){
+            uint64_t x;
+            std::memcpy(&x, p + i, 8);
+            x ^= '\n' * ONES;
+            lanes += (~(((x & LOW7) + LOW7) | x) >> 7) & ONES;
+        }
+        lanes = (lanes & 0x00ff00ff00ff00ffULL) + ((lanes >> 8) & 0x00ff00ff00ff00ffULL);
+        n += (std::size_t) ((lanes * 0x0001000100010001ULL) >> 48);
+    }
+    for(; i < len; i++){
+        n += (p[i] == '\n');
+    }
+    return n;
+}
+
+// f(0) to f(n - 1), the last one on the calling thread
+template <typename F>
+static void text_run(const unsigned n, const F & f){
+    std::vector <std::thread> workers;
+    workers.reserve(n - 1);
+    for(unsigned i = 0; i + 1 < n; i++){
+        workers.emplace_back(f, i);
+    }
+    f(n - 1);
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+}
+
+UINT128_T_INLINE bool uint128_parse(const char * str, const std::size_t len, const uint8_t base, uint128_t & value){
+    text_check_base(base);
+    if (!len || std::memchr(str, '\n', len) || (str[len - 1] == '\r')){
+        return false;
+    }
+    return uint128_active_kernels().parse_lines(str, len, base, &value) == 1;
+}
+
+// Cuts the text after a newline near every 1/threads of it, counts the lines
+// of each piece to know where its values go, then parses the pieces in place
+static std::vector <uint128_t> text_parse(const char * text, const std::size_t len, const uint8_t base,
+                                          const unsigned threads, const std::string & name){
+    const unsigned pieces = text_threads(threads, len, TEXT_MIN_PIECE);
+
+    std::vector <std::size_t> cuts(pieces + 1, len);
+    cuts[0] = 0;
+    for(unsigned i = 1; i < pieces; i++){
+        const std::size_t from = std::max(cuts[i - 1], len / pieces * i);
+        const void * newline = std::memchr(text + from, '\n', len - from);
+        cuts[i] = newline ? (static_cast <const char *> (newline) - text) + 1 : len;
+    }
+
+    // first[i] is the line piece i starts at
+    std::vector <std::size_t> first(pieces + 1, 0);
+    text_run(pieces, [&](const unsigned i){
+        const char * begin = text + cuts[i];
+        const char * end = text + cuts[i + 1];
+        first[i + 1] = text_newlines(begin, end - begin) + ((end > begin) && (end[-1] != '\n'));
+    });
+    for(unsigned i = 0; i < pieces; i++){
+        first[i + 1] += first[i];
+    }
+
+    std::vector <uint128_t> out(first[pieces]);
+    std::vector <std::size_t> read(pieces);
+    const uint128_kernels & kernels = uint128_active_kernels();
+    text_run(pieces, [&](const unsigned i){
+        read[i] = kernels.parse_lines(text + cuts[i], cuts[i + 1] - cuts[i], base, out.data() + first[i]);
+    });
+
+    for(unsigned i = 0; i < pieces; i++){
+        if (read[i] < first[i + 1] - first[i]){
+            throw std::runtime_error("Error: line " + std::to_string(first[i] + read[i] + 1) + name +
+                                     " is not a base " + std::to_string(base) + " uint128_t");
+        }
+    }
+    return out;
+}
+
+UINT128_T_INLINE std::vector <uint128_t> uint128_parse_text(const char * text, const std::size_t len, const uint8_t base, unsigned threads){
+    text_check_base(base);
+    return text_parse(text, len, base, threads, "");
+}
+
+UINT128_T_INLINE std::vector <uint128_t> uint128_read_text(const std::string & path, const uint8_t base, unsigned threads){
+    text_check_base(base);
+    #if defined(UINT128_T_TEXT_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0){
+            throw std::runtime_error("Error: cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0){
+            ::close(fd);
+            throw std::runtime_error("Error: cannot read " + path);
+        }
+        const std::size_t length = (std::size_t) st.st_size;
+        if (!length){
+            ::close(fd);
+            return std::vector <uint128_t> ();
+        }
+        void * p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED){
+            throw std::runtime_error("Error: cannot map " + path);
+        }
+        try{
+            std::vector <uint128_t> out = text_parse(static_cast <const char *> (p), length, base, threads, " of " + path);
+            ::munmap(p, length);
+            return out;
+        }
+        catch (...){
+            ::munmap(p, length);
+            throw;
+        }
+    #else
+        std::FILE * file = std::fopen(path.c_str(), "rb");
+        if (!file){
+            throw std::runtime_error("Error: cannot open " + path);
+        }
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        std::vector <char> text((size > 0) ? (std::size_t) size : 0);
+        const bool ok = (size >= 0) && (std::fread(text.data(), 1, text.size(), file) == text.size());
+        std::fclose(file);
+        if (!ok){
+            throw std::runtime_error("Error: cannot read " + path);
+        }
+        return text_parse(text.data(), text.size(), base, threads, " of " + path);
+    #endif
+}
+
+// Formats the values in rounds of TEXT_BLOCK per thread, each into its own
+// buffer, and hands the buffers to emit(data, size) in order
+template <typename Emit>
+static void text_format(const uint128_t * values, const std::size_t count, const uint8_t base, const unsigned threads, const Emit & emit){
+    text_check_base(base);
+    const unsigned workers = text_threads(threads, count, TEXT_BLOCK);
+    std::vector <std::vector <char> > buffers(workers, std::vector <char> (std::min(count, TEXT_BLOCK) * TEXT_MAX_LINE));
+    std::vector <std::size_t> sizes(workers);
+    const uint128_kernels & kernels = uint128_active_kernels();
+
+    for(std::size_t done = 0; done < count;){
+        const std::size_t round = std::min(count - done, workers * TEXT_BLOCK);
+        text_run(workers, [&](const unsigned i){
+            const std::size_t from = std::min(round, i * TEXT_BLOCK);
+            const std::size_t to = std::min(round, from + TEXT_BLOCK);
+            sizes[i] = kernels.format_lines(values + done + from, to - from, base, buffers[i].data());
+        });
+        for(unsigned i = 0; i < workers; i++){
+            emit(buffers[i].data(), sizes[i]);
+        }
+        done += round;
+    }
+}
+
+UINT128_T_INLINE std::string uint128_format_text(const uint128_t * values, const std::size_t count, const uint8_t base, unsigned threads){
+    std::string out;
+    text_format(values, count, base, threads, [&](const char * data, const std::size_t size){
+        out.append(data, size);
+    });
+    return out;
+}
+
+UINT128_T_INLINE void uint128_write_text(const std::string & path, const uint128_t * values, const std::size_t count, const uint8_t base, unsigned threads){
+    text_check_base(base);
+    std::FILE * file = std::fopen(path.c_str(), "wb");
+    if (!file){
+        throw std::runtime_error("Error: cannot create " + path);
+    }
+    bool ok = true;
+    try{
+        text_format(values, count, base, threads, [&](const char * data, const std::size_t size){
+            ok = ok && (std::fwrite(data, 1, size, file) == size);
+        });
+    }
+    catch (...){
+        std::fclose(file);
+        throw;
+    }
+    if ((std::fclose(file) != 0) || !ok){
+        throw std::runtime_error("Error: could not write " + path);
+    }
+}
@@ -0,0 +1,46 @@
+// PUBLIC IMPORT HEADER
+// Newline separated text of uint128_t values, in decimal or hex
+//
+//     uint128_parse(str, len, base, value)         - one number; false if it is not one
+//     uint128_parse_text(text, len, base)          - every line of a buffer
+//     uint128_read_text(path, base)                - every line of a file
+//     uint128_format_text(values, count, base)     - one line per value
+//     uint128_write_text(path, values, count, base)
+//
+// A line holds digits only, or for base 16 digits and letters in either case
+// after an optional 0x. Leading zeros are allowed; signs, spaces and empty
+// lines are not. Lines end in '\n' or "\r\n", except maybe the last one.
+// Output is lowercase without a prefix.
+//
+// Files are mapped where the system allows it (otherwise read whole), cut at
+// line boundaries into one piece per thread, and each piece is parsed straight
+// into its place in the result. The avx2 and avx512 kernels find the end of
+// a line and check its characters with two 32 byte compares; all levels
+// convert 8 digits at a time in a 64 bit register. Writing formats blocks of
+// values into one buffer per thread and writes the buffers in order.
+//
+// threads = 0 uses std::thread::hardware_concurrency().
+#ifndef _UINT128_T_TEXT_H_
+#define _UINT128_T_TEXT_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "uint128_t.h"
+
+// base must be 10 or 16 here and below; other bases throw std::invalid_argument
+UINT128_T_EXTERN bool uint128_parse(const char * str, const std::size_t len, const uint8_t base, uint128_t & value);
+
+// throw std::runtime_error naming the first invalid line
+UINT128_T_EXTERN std::vector <uint128_t> uint128_parse_text(const char * text, const std::size_t len, const uint8_t base = 10, unsigned threads = 0);
+UINT128_T_EXTERN std::vector <uint128_t> uint128_read_text(const std::string & path, const uint8_t base = 10, unsigned threads = 0);
+
+UINT128_T_EXTERN std::string uint128_format_text(const uint128_t * values, const std::size_t count, const uint8_t base = 10, unsigned threads = 0);
+UINT128_T_EXTERN void uint128_write_text(const std::string & path, const uint128_t * values, const std::size_t count, const uint8_t base = 10, unsigned threads = 0);
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_text.cpp"
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+#include <stdexcept>
+
+#include "uint128_t.build"
+#include "uint128_t_dispatch.h"
+#include "uint128_t_uuid.h"
+
+UINT128_T_INLINE void uuid_format(const uint128_t & value, char * out){
+    uint128_active_kernels().uuid_format_n(&value, 1, out, uuid_length);
+}
+
+UINT128_T_INLINE std::string uuid_str(const uint128_t & value){
+    char buf[uuid_length];
+    uuid_format(value, buf);
+    return std::string(buf, uuid_length);
+}
+
+UINT128_T_INLINE bool uuid_parse(const char * str, const std::size_t len, uint128_t & value){
+    return (len == uuid_length) && uint128_active_kernels().uuid_parse_n(str, uuid_length, 1, &value);
+}
+
+UINT128_T_INLINE uint128_t uuid_parse(const std::string & str){
+    uint128_t value;
+    if (!uuid_parse(str.data(), str.size(), value)){
+        throw std::invalid_argument("Error: not a UUID: " + str);
+    }
+    return value;
+}
+
+UINT128_T_INLINE void uuid_format_n(const uint128_t * values, const std::size_t count, char * out, const std::size_t stride){
+    uint128_active_kernels().uuid_format_n(values, count, out, stride);
+}
+
+UINT128_T_INLINE std::size_t uuid_parse_n(const char * in, const std::size_t count, uint128_t * values, const std::size_t stride){
+    return uint128_active_kernels().uuid_parse_n(in, stride, count, values);
+}
+
+static const char ULID_DIGITS[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+// Crockford base32 digit values by ASCII code, either case, with I and L
+// read as 1 and O as 0; 32 marks everything else
+static const uint8_t ULID_VALUES[128] = {
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+    32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32, 32,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 32, 32, 32, 32, 32, 32,
+    32, 10, 11, 12, 13, 14, 15, 16, 17,  1, 18, 19,  1, 20, 21,  0,
+    22, 23, 24, 25, 26, 32, 27, 28, 29, 30, 31, 32, 32, 32, 32, 32,
+    32, 10, 11, 12, 13, 14, 15, 16, 17,  1, 18, 19,  1, 20, 21,  0,
+    22, 23, 24, 25, 26, 32, 27, 28, 29, 30, 31, 32, 32, 32, 32, 32,
+};
+
+// value of a digit, or 32
+static inline unsigned ulid_digit(const char c){
+    const unsigned u = (unsigned char) c;
+    return (u < 128) ? ULID_VALUES[u] : 32;
+}
+
+// 12 digits, 60 bits
+static inline void ulid_write60(char * out, uint64_t v){
+    for(int i = 11; i >= 0; i--){
+        out[i] = ULID_DIGITS[v & 31];
+        v >>= 5;
+    }
+}
+
+static inline bool ulid_read60(const char * in, uint64_t & v){
+    v = 0;
+    unsigned bad = 0;
+    for(unsigned i = 0; i < 12; i++){
+        const unsigned d = ulid_digit(in[i]);
+        bad |= d;
+        v = (v << 5) | (d & 31);
+    }
+    return !(bad & 32);
+}
+
+UINT128_T_INLINE void ulid_format(const uint128_t & value, char * out){
+    // 3 + 5 bits on top, then two runs of 60
+    const uint64_t hi = value.upper(), lo = value.lower();
+    out[0] = ULID_DIGITS[hi >> 61];
+    out[1] = ULID_DIGITS[(hi >> 56) & 31];
+    ulid_write60(out + 2,  ((hi << 4) | (lo >> 60)) & 0x0fffffffffffffffULL);
+    ulid_write60(out + 14, lo & 0x0fffffffffffffffULL);
+}
+
+UINT128_T_INLINE std::string ulid_str(const uint128_t & value){
+    char buf[ulid_length];
+    ulid_format(value, buf);
+    return std::string(buf, ulid_length);
+}
+
+UINT128_T_INLINE bool ulid_parse(const char * str, const std::size_t len, uint128_t & value){
+    if (len != ulid_length){
+        return false;
+    }
+    const unsigned d0 = ulid_digit(str[0]), d1 = ulid_digit(str[1]);
+    uint64_t mid, low;
+    if ((d0 > 7) || (d1 > 31) || !ulid_read60(str + 2, mid) || !ulid_read60(str + 14, low)){
+        return false;
+    }
+    value = uint128_t(((uint64_t) ((d0 << 5) | d1) << 56) | (mid >> 4), (mid << 60) | low);
+    return true;
+}
+
+UINT128_T_INLINE uint128_t ulid_parse(const std::string & str){
+    uint128_t value;
+    if (!ulid_parse(str.data(), str.size(), value)){
+        throw std::invalid_argument("Error: not a ULID: " + str);
+    }
+    return value;
+}
+
+UINT128_T_INLINE void ulid_format_n(const uint128_t * values, const std::size_t count, char * out, const std::size_t stride){
+    for(std::size_t i = 0; i < count; i++){
+        ulid_format(values[i], out + i * stride);
+    }
+}
+
+UINT128_T_INLINE std::size_t ulid_parse_n(const char * in, const std::size_t count, uint128_t * values, const std::size_t stride){
+    for(std::size_t i = 0; i < count; i++){
+        if (!ulid_parse(in + i * stride, ulid_length, values[i])){
+            return i;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,74 @@
+// PUBLIC IMPORT HEADER
+// UUID and ULID text for uint128_t keys
+//
+// A UUID is stored with its first byte in the most significant bits, so
+// "00112233-4455-6677-8899-aabbccddeeff" is uint128_t(0x0011223344556677, 0x8899aabbccddeeff)
+// and numeric order is the byte order RFC 4122 compares in. A ULID is the
+// 128 bit integer its 26 Crockford base32 characters spell, with the 48 bit
+// millisecond timestamp on top.
+//
+//     uuid_format / uuid_parse     - 8-4-4-4-12 hex, written lowercase, read in either case
+//     ulid_format / ulid_parse     - 26 characters, written uppercase, read in either case
+//     ..._n                        - the same over arrays, with a fixed stride between records
+//
+// The UUID codec goes through the dispatch table (see uint128_t_dispatch.h):
+// the avx2 and avx512 levels convert a whole UUID in a few SSSE3 shuffles, the
+// others eight digits per 64 bit word. Nothing allocates except the _str
+// functions.
+#ifndef _UINT128_T_UUID_H_
+#define _UINT128_T_UUID_H_
+
+#include <cstddef>
+#include <string>
+
+#include "uint128_t.h"
+
+constexpr std::size_t uuid_length = 36;
+constexpr std::size_t ulid_length = 26;
+
+// writes uuid_length characters, not null terminated
+UINT128_T_EXTERN void uuid_format(const uint128_t & value, char * out);
+UINT128_T_EXTERN std::string uuid_str(const uint128_t & value);
+
+// false unless str is exactly one 8-4-4-4-12 UUID
+UINT128_T_EXTERN bool uuid_parse(const char * str, const std::size_t len, uint128_t & value);
+
+// throws std::invalid_argument
+UINT128_T_EXTERN uint128_t uuid_parse(const std::string & str);
+
+// record i is written to / read from text + i * stride; stride must be at
+// least uuid_length. uuid_parse_n returns how many leading records were
+// valid, so anything less than count is the index of the first bad one.
+UINT128_T_EXTERN void uuid_format_n(const uint128_t * values, const std::size_t count, char * out, const std::size_t stride = uuid_length);
+UINT128_T_EXTERN std::size_t uuid_parse_n(const char * in, const std::size_t count, uint128_t * values, const std::size_t stride = uuid_length);
+
+// RFC 4122 version (the high nibble of byte 6)
+inline unsigned uuid_version(const uint128_t & value){
+    return (unsigned) (value.upper() >> 12) & 0xf;
+}
+
+// writes ulid_length characters, not null terminated
+UINT128_T_EXTERN void ulid_format(const uint128_t & value, char * out);
+UINT128_T_EXTERN std::string ulid_str(const uint128_t & value);
+
+// false unless str is exactly 26 Crockford base32 characters no larger than
+// 7ZZZZZZZZZZZZZZZZZZZZZZZZZ; I and L read as 1 and O as 0, as Crockford allows
+UINT128_T_EXTERN bool ulid_parse(const char * str, const std::size_t len, uint128_t & value);
+
+// throws std::invalid_argument
+UINT128_T_EXTERN uint128_t ulid_parse(const std::string & str);
+
+// stride must be at least ulid_length; ulid_parse_n returns like uuid_parse_n
+UINT128_T_EXTERN void ulid_format_n(const uint128_t * values, const std::size_t count, char * out, const std::size_t stride = ulid_length);
+UINT128_T_EXTERN std::size_t ulid_parse_n(const char * in, const std::size_t count, uint128_t * values, const std::size_t stride = ulid_length);
+
+// milliseconds since the Unix epoch
+inline uint64_t ulid_time(const uint128_t & value){
+    return value.upper() >> 16;
+}
+
+#if defined(UINT128_T_HEADER_ONLY)
+  #include "uint128_t_uuid.cpp"
+#endif
+
+#endif